@@ -17,6 +17,7 @@
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/auth/crypto_mod.h>
+#include <drivers/auth/mbedtls/mbedtls_common.h>
 #include <drivers/console.h>
 #include <lib/bootmarker_capture.h>
 #include <lib/cpus/errata.h>
@@ -145,6 +146,10 @@ void bl1_main(void)
 	else
 		NOTICE("BL1-FWU: *******FWU Process Started*******\n");
 
+#if DEBUG && defined(TF_MBEDTLS_HEAP_ALLOC_ID)
+	mbedtls_heap_print_peak();
+#endif
+
 	/* Teardown the measured boot driver */
 	bl1_plat_mboot_finish();
 
@@ -15,6 +15,7 @@
 #include <common/debug.h>
 #include <drivers/auth/auth_mod.h>
 #include <drivers/auth/crypto_mod.h>
+#include <drivers/auth/mbedtls/mbedtls_common.h>
 #include <drivers/console.h>
 #include <drivers/fwu/fwu.h>
 #include <lib/bootmarker_capture.h>
@@ -123,6 +124,10 @@ void bl2_main(void)
 	/* Load the subsequent bootloader images. */
 	next_bl_ep_info = bl2_load_images();
 
+#if DEBUG && defined(TF_MBEDTLS_HEAP_ALLOC_ID)
+	mbedtls_heap_print_peak();
+#endif
+
 	/* Teardown the Measured Boot backend */
 	bl2_plat_mboot_finish();
 
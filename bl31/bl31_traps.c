@@ -17,6 +17,12 @@ int handle_sysreg_trap(uint64_t esr_el3, cpu_context_t *ctx)
 {
 	uint64_t __unused opcode = esr_el3 & ISS_SYSREG_OPCODE_MASK;
 
+#if CTX_FPREGS_LAZY
+	if (EC_BITS(esr_el3) == EC_FP_SIMD) {
+		return cm_handle_fpregs_trap(ctx);
+	}
+#endif
+
 #if ENABLE_FEAT_RNG_TRAP
 	if ((opcode == ISS_SYSREG_OPCODE_RNDR) || (opcode == ISS_SYSREG_OPCODE_RNDRRS)) {
 		return plat_handle_rng_trap(esr_el3, ctx);
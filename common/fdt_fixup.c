@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2024, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -65,14 +65,15 @@ int dt_add_psci_node(void *fdt)
 {
 	int offs;
 
-	if (fdt_path_offset(fdt, "/psci") >= 0) {
+	if (fdtw_path_offset(fdt, "/psci") >= 0) {
 		WARN("PSCI Device Tree node already exists!\n");
 		return 0;
 	}
 
-	offs = fdt_path_offset(fdt, "/");
+	offs = fdtw_path_offset(fdt, "/");
 	if (offs < 0)
 		return -1;
+	fdtw_index_invalidate(fdt);
 	offs = fdt_add_subnode(fdt, offs, "psci");
 	if (offs < 0)
 		return -1;
@@ -128,6 +129,7 @@ static int dt_update_one_cpu_node(void *fdt, int offset)
 		    (strcmp(prop, "psci") == 0) && (len == 5))
 			continue;
 
+		fdtw_index_invalidate(fdt);
 		ret = fdt_setprop_string(fdt, offs, "enable-method", "psci");
 		if (ret < 0)
 			return ret;
@@ -160,7 +162,7 @@ int dt_add_psci_cpu_enable_methods(void *fdt)
 	int offs, ret;
 
 	do {
-		offs = fdt_path_offset(fdt, "/cpus");
+		offs = fdtw_path_offset(fdt, "/cpus");
 		if (offs < 0)
 			return offs;
 
@@ -196,13 +198,14 @@ int dt_add_psci_cpu_enable_methods(void *fdt)
 int fdt_add_reserved_memory(void *dtb, const char *node_name,
 			    uintptr_t base, size_t size)
 {
-	int offs = fdt_path_offset(dtb, "/reserved-memory");
+	int offs = fdtw_path_offset(dtb, "/reserved-memory");
 	uint32_t addresses[4];
 	int ac, sc;
 	unsigned int idx = 0;
 
 	ac = fdt_address_cells(dtb, 0);
 	sc = fdt_size_cells(dtb, 0);
+	fdtw_index_invalidate(dtb);
 	if (offs < 0) {			/* create if not existing yet */
 		offs = fdt_add_subnode(dtb, 0, "reserved-memory");
 		if (offs < 0) {
@@ -339,10 +342,11 @@ int fdt_add_cpus_node(void *dtb, unsigned int afflv0,
 	u_register_t mpidr;
 	int cpuid;
 
-	if (fdt_path_offset(dtb, "/cpus") >= 0) {
+	if (fdtw_path_offset(dtb, "/cpus") >= 0) {
 		return -EEXIST;
 	}
 
+	fdtw_index_invalidate(dtb);
 	offs = fdt_add_subnode(dtb, 0, "cpus");
 	if (offs < 0) {
 		ERROR ("FDT: add subnode \"cpus\" node to parent node failed");
@@ -419,12 +423,13 @@ int fdt_add_cpu_idle_states(void *dtb, const struct psci_cpu_idle_state *state)
 		return ret;
 	}
 
-	cpus_node = fdt_path_offset(dtb, "/cpus");
+	cpus_node = fdtw_path_offset(dtb, "/cpus");
 	if (cpus_node < 0) {
 		return cpus_node;
 	}
 
 	/* Create the idle-states node and its child nodes. */
+	fdtw_index_invalidate(dtb);
 	idle_states_node = fdt_add_subnode(dtb, cpus_node, "idle-states");
 	if (idle_states_node < 0) {
 		return idle_states_node;
@@ -523,7 +528,7 @@ int fdt_add_cpu_idle_states(void *dtb, const struct psci_cpu_idle_state *state)
 int fdt_adjust_gic_redist(void *dtb, unsigned int nr_cores,
 			  uintptr_t gicr_base, unsigned int gicr_frame_size)
 {
-	int offset = fdt_node_offset_by_compatible(dtb, 0, "arm,gic-v3");
+	int offset = fdtw_node_offset_by_compatible(dtb, 0, "arm,gic-v3");
 	uint64_t reg_64;
 	uint32_t reg_32;
 	void *val;
@@ -534,7 +539,7 @@ int fdt_adjust_gic_redist(void *dtb, unsigned int nr_cores,
 		return offset;
 	}
 
-	parent = fdt_parent_offset(dtb, offset);
+	parent = fdtw_parent_offset(dtb, offset);
 	if (parent < 0) {
 		return parent;
 	}
@@ -616,11 +621,12 @@ int fdt_set_mac_address(void *dtb, unsigned int ethernet_idx,
 		return -FDT_ERR_NOTFOUND;
 	}
 
-	node = fdt_path_offset(dtb, path);
+	node = fdtw_path_offset(dtb, path);
 	if (node < 0) {
 		ERROR("Path \"%s\" not found in DT: %d\n", path, node);
 		return node;
 	}
 
+	fdtw_index_invalidate(dtb);
 	return fdt_setprop(dtb, node, "local-mac-address", mac_addr, 6);
 }
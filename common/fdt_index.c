@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Offset index over a Device Tree Blob, used by the fdtw_*_offset() lookup
+ * helpers to avoid walking the whole structure block of large trees.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <libfdt.h>
+
+#include <common/fdt_wrappers.h>
+#include <lib/cassert.h>
+
+/* Deepest node nesting supported by the index */
+#define FDTW_INDEX_MAX_DEPTH	32
+
+struct fdtw_index_node {
+	int offset;
+	/* Index of the parent node, -1 for the root node */
+	int parent;
+	/* Index following the last descendant of the node */
+	int end;
+	/* One bit per hashed "compatible" string */
+	uint32_t compat_mask;
+};
+
+struct fdtw_index_phandle {
+	uint32_t phandle;
+	/* Index of the node */
+	int node;
+};
+
+struct fdtw_index {
+	const void *dtb;
+	/* Used to detect changes made to the DTB behind the index's back */
+	uint32_t totalsize;
+	uint32_t size_dt_struct;
+	struct fdtw_index_node *nodes;
+	unsigned int nr_nodes;
+	struct fdtw_index_phandle *phandles;
+	unsigned int nr_phandles;
+};
+
+CASSERT(sizeof(struct fdtw_index) <= FDTW_INDEX_HDR_SIZE,
+	assert_fdtw_index_hdr_size);
+CASSERT((sizeof(struct fdtw_index_node) +
+	 sizeof(struct fdtw_index_phandle)) <= FDTW_INDEX_ENTRY_SIZE,
+	assert_fdtw_index_entry_size);
+
+/* Index currently in use, if any */
+static struct fdtw_index *fdtw_index;
+
+/* FNV-1a hash of a string, reduced to a bit of the compatible mask */
+static uint32_t fdtw_compat_bit(const char *str, size_t len)
+{
+	uint32_t hash = 0x811c9dc5U;
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		hash = (hash ^ (uint8_t)str[i]) * 0x01000193U;
+	}
+
+	return 1U << (hash & 31U);
+}
+
+static uint32_t fdtw_compat_mask(const void *dtb, int node)
+{
+	const char *prop;
+	uint32_t mask = 0U;
+	size_t len;
+	int plen;
+
+	prop = fdt_getprop(dtb, node, "compatible", &plen);
+	if (prop == NULL) {
+		return 0U;
+	}
+
+	while (plen > 0) {
+		len = strnlen(prop, (size_t)plen);
+		mask |= fdtw_compat_bit(prop, len);
+		prop += len + 1U;
+		plen -= (int)len + 1;
+	}
+
+	return mask;
+}
+
+static void fdtw_sift_down(struct fdtw_index_phandle *ph, unsigned int root,
+			   unsigned int num)
+{
+	struct fdtw_index_phandle tmp;
+	unsigned int child;
+
+	while ((child = (2U * root) + 1U) < num) {
+		if (((child + 1U) < num) &&
+		    (ph[child + 1U].phandle > ph[child].phandle)) {
+			child++;
+		}
+
+		if (ph[root].phandle >= ph[child].phandle) {
+			return;
+		}
+
+		tmp = ph[root];
+		ph[root] = ph[child];
+		ph[child] = tmp;
+		root = child;
+	}
+}
+
+/* Heap sort the phandle table, so that it can be searched by bisection */
+static void fdtw_sort_phandles(struct fdtw_index_phandle *ph, unsigned int num)
+{
+	struct fdtw_index_phandle tmp;
+	unsigned int i;
+
+	for (i = num / 2U; i > 0U; i--) {
+		fdtw_sift_down(ph, i - 1U, num);
+	}
+
+	for (i = num; i > 1U; i--) {
+		tmp = ph[0];
+		ph[0] = ph[i - 1U];
+		ph[i - 1U] = tmp;
+		fdtw_sift_down(ph, 0U, i - 1U);
+	}
+}
+
+/*******************************************************************************
+ * Build an index of the nodes of 'dtb' in the 'size' bytes long 'arena', which
+ * must be 8-byte aligned and stay allocated as long as the index is used. A
+ * tree of N nodes needs at most FDTW_INDEX_SIZE(N) bytes. Only one index is
+ * used at a time and building a new one drops the previous one.
+ *
+ * The index is dropped by fdtw_index_invalidate(), which must be called before
+ * modifying the structure of the DTB. Changes of its size are also detected.
+ * Returns 0 on success and a negative FDT error code on failure, in which case
+ * the lookup helpers go back to walking the DTB.
+ ******************************************************************************/
+int fdtw_index_init(const void *dtb, void *arena, size_t size)
+{
+	struct fdtw_index *idx = arena;
+	struct fdtw_index_node *nodes;
+	struct fdtw_index_phandle *ph, *ph_end;
+	int stack[FDTW_INDEX_MAX_DEPTH];
+	int node, depth = -1, top = 0;
+	unsigned int n = 0U;
+	uint32_t phandle;
+	int err;
+
+	assert((arena != NULL) && (((uintptr_t)arena % sizeof(uint64_t)) == 0U));
+
+	fdtw_index = NULL;
+
+	err = fdt_check_header(dtb);
+	if (err != 0) {
+		return err;
+	}
+
+	size &= ~(sizeof(uint64_t) - 1U);
+	if (size < FDTW_INDEX_HDR_SIZE) {
+		return -FDT_ERR_NOSPACE;
+	}
+
+	/* Nodes grow from the start of the arena and phandles from its end */
+	nodes = (void *)((uintptr_t)arena + FDTW_INDEX_HDR_SIZE);
+	ph_end = (void *)((uintptr_t)arena + size);
+	ph = ph_end;
+
+	for (node = fdt_next_node(dtb, -1, &depth);
+	     (node >= 0) && (depth >= 0);
+	     node = fdt_next_node(dtb, node, &depth)) {
+		if (depth >= FDTW_INDEX_MAX_DEPTH) {
+			return -FDT_ERR_BADSTRUCTURE;
+		}
+
+		if ((uintptr_t)&nodes[n + 1U] > (uintptr_t)ph) {
+			return -FDT_ERR_NOSPACE;
+		}
+
+		/* Close the subtrees of the nodes which are not ancestors */
+		while (top > depth) {
+			nodes[stack[--top]].end = (int)n;
+		}
+
+		nodes[n].offset = node;
+		nodes[n].parent = (depth > 0) ? stack[depth - 1] : -1;
+		nodes[n].compat_mask = fdtw_compat_mask(dtb, node);
+		stack[top++] = (int)n;
+
+		phandle = fdt_get_phandle(dtb, node);
+		if ((phandle != 0U) && (phandle != ~0U)) {
+			if ((uintptr_t)(ph - 1) < (uintptr_t)&nodes[n + 1U]) {
+				return -FDT_ERR_NOSPACE;
+			}
+			ph--;
+			ph->phandle = phandle;
+			ph->node = (int)n;
+		}
+
+		n++;
+	}
+
+	if ((node < 0) && (node != -FDT_ERR_NOTFOUND)) {
+		return node;
+	}
+
+	while (top > 0) {
+		nodes[stack[--top]].end = (int)n;
+	}
+
+	fdtw_sort_phandles(ph, (unsigned int)(ph_end - ph));
+
+	idx->dtb = dtb;
+	idx->totalsize = fdt_totalsize(dtb);
+	idx->size_dt_struct = fdt_size_dt_struct(dtb);
+	idx->nodes = nodes;
+	idx->nr_nodes = n;
+	idx->phandles = ph;
+	idx->nr_phandles = (unsigned int)(ph_end - ph);
+
+	fdtw_index = idx;
+
+	return 0;
+}
+
+/* Stop using the index of 'dtb', if there is one */
+void fdtw_index_invalidate(const void *dtb)
+{
+	if ((fdtw_index != NULL) && (fdtw_index->dtb == dtb)) {
+		fdtw_index = NULL;
+	}
+}
+
+/* Return the index of 'dtb' if there is one and it is still valid */
+static const struct fdtw_index *fdtw_index_get(const void *dtb)
+{
+	const struct fdtw_index *idx = fdtw_index;
+
+	if ((idx == NULL) || (idx->dtb != dtb) ||
+	    (fdt_totalsize(dtb) != idx->totalsize) ||
+	    (fdt_size_dt_struct(dtb) != idx->size_dt_struct)) {
+		return NULL;
+	}
+
+	return idx;
+}
+
+/* Return the position of the node at 'offset' in the index, or -1 */
+static int fdtw_index_find(const struct fdtw_index *idx, int offset)
+{
+	unsigned int lo = 0U, hi = idx->nr_nodes, mid;
+
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2U);
+		if (idx->nodes[mid].offset == offset) {
+			return (int)mid;
+		} else if (idx->nodes[mid].offset < offset) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return -1;
+}
+
+/* Same name matching rules as libfdt, a unit address may be omitted */
+static bool fdtw_index_name_eq(const void *dtb, int offset, const char *s,
+			       size_t len)
+{
+	const char *name;
+	int nlen;
+
+	name = fdt_get_name(dtb, offset, &nlen);
+	if ((name == NULL) || ((size_t)nlen < len) ||
+	    (memcmp(name, s, len) != 0)) {
+		return false;
+	}
+
+	return (name[len] == '\0') ||
+	       ((name[len] == '@') && (memchr(s, '@', len) == NULL));
+}
+
+int fdtw_parent_offset(const void *dtb, int node)
+{
+	const struct fdtw_index *idx = fdtw_index_get(dtb);
+	int i;
+
+	if (idx != NULL) {
+		i = fdtw_index_find(idx, node);
+		if (i >= 0) {
+			i = idx->nodes[i].parent;
+			return (i < 0) ? -FDT_ERR_NOTFOUND : idx->nodes[i].offset;
+		}
+	}
+
+	return fdt_parent_offset(dtb, node);
+}
+
+int fdtw_path_offset(const void *dtb, const char *path)
+{
+	const struct fdtw_index *idx = fdtw_index_get(dtb);
+	const char *end;
+	size_t len;
+	int i = 0, c;
+
+	/* Aliases are left to libfdt */
+	if ((idx == NULL) || (path[0] != '/')) {
+		return fdt_path_offset(dtb, path);
+	}
+
+	while (*path != '\0') {
+		while (*path == '/') {
+			path++;
+		}
+
+		if (*path == '\0') {
+			break;
+		}
+
+		end = strchr(path, '/');
+		len = (end != NULL) ? (size_t)(end - path) : strlen(path);
+
+		for (c = i + 1; c < idx->nodes[i].end; c = idx->nodes[c].end) {
+			if (fdtw_index_name_eq(dtb, idx->nodes[c].offset,
+					       path, len)) {
+				break;
+			}
+		}
+
+		if (c >= idx->nodes[i].end) {
+			return -FDT_ERR_NOTFOUND;
+		}
+
+		i = c;
+		path += len;
+	}
+
+	return idx->nodes[i].offset;
+}
+
+int fdtw_node_offset_by_phandle(const void *dtb, uint32_t phandle)
+{
+	const struct fdtw_index *idx = fdtw_index_get(dtb);
+	unsigned int lo = 0U, hi, mid;
+
+	if ((idx == NULL) || (phandle == 0U) || (phandle == ~0U)) {
+		return fdt_node_offset_by_phandle(dtb, phandle);
+	}
+
+	hi = idx->nr_phandles;
+	while (lo < hi) {
+		mid = lo + ((hi - lo) / 2U);
+		if (idx->phandles[mid].phandle == phandle) {
+			return idx->nodes[idx->phandles[mid].node].offset;
+		} else if (idx->phandles[mid].phandle < phandle) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return -FDT_ERR_NOTFOUND;
+}
+
+int fdtw_node_offset_by_compatible(const void *dtb, int startoffset,
+				   const char *compatible)
+{
+	const struct fdtw_index *idx = fdtw_index_get(dtb);
+	uint32_t bit;
+	int i;
+
+	if (idx == NULL) {
+		return fdt_node_offset_by_compatible(dtb, startoffset,
+						     compatible);
+	}
+
+	if (startoffset < 0) {
+		i = 0;
+	} else {
+		i = fdtw_index_find(idx, startoffset);
+		if (i < 0) {
+			return fdt_node_offset_by_compatible(dtb, startoffset,
+							     compatible);
+		}
+		i++;
+	}
+
+	bit = fdtw_compat_bit(compatible, strlen(compatible));
+
+	for (; i < (int)idx->nr_nodes; i++) {
+		if (((idx->nodes[i].compat_mask & bit) != 0U) &&
+		    (fdt_node_check_compatible(dtb, idx->nodes[i].offset,
+					       compatible) == 0)) {
+			return idx->nodes[i].offset;
+		}
+	}
+
+	return -FDT_ERR_NOTFOUND;
+}
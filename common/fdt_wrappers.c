@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2023, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2024, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -283,7 +283,7 @@ int fdt_get_reg_props_by_index(const void *dtb, int node, int index,
 	int ac, sc;
 	int cell;
 
-	parent = fdt_parent_offset(dtb, node);
+	parent = fdtw_parent_offset(dtb, node);
 	if (parent < 0) {
 		return -FDT_ERR_BADOFFSET;
 	}
@@ -344,9 +344,9 @@ int fdt_get_stdout_node_offset(const void *dtb)
 	int len;
 
 	/* The /secure-chosen node takes precedence over the standard one. */
-	node = fdt_path_offset(dtb, "/secure-chosen");
+	node = fdtw_path_offset(dtb, "/secure-chosen");
 	if (node < 0) {
-		node = fdt_path_offset(dtb, "/chosen");
+		node = fdtw_path_offset(dtb, "/chosen");
 		if (node < 0) {
 			return -FDT_ERR_NOTFOUND;
 		}
@@ -376,7 +376,7 @@ int fdt_get_stdout_node_offset(const void *dtb)
 		return -FDT_ERR_NOTFOUND;
 	}
 
-	return fdt_path_offset(dtb, path);
+	return fdtw_path_offset(dtb, path);
 }
 
 
@@ -440,7 +440,7 @@ static uint64_t fdtw_search_all_xlat_entries(const void *dtb,
 	 *              = 1                 + 2                      + 1
 	 */
 
-	parent_bus_node = fdt_parent_offset(dtb, local_bus);
+	parent_bus_node = fdtw_parent_offset(dtb, local_bus);
 	self_addr_cells = fdt_address_cells(dtb, local_bus);
 	self_size_cells = fdt_size_cells(dtb, local_bus);
 	parent_addr_cells = fdt_address_cells(dtb, parent_bus_node);
@@ -532,7 +532,7 @@ uint64_t fdtw_translate_address(const void *dtb, int node,
 	const char *node_name;
 	uint64_t global_address;
 
-	local_bus_node = fdt_parent_offset(dtb, node);
+	local_bus_node = fdtw_parent_offset(dtb, node);
 	node_name = fdt_get_name(dtb, local_bus_node, NULL);
 
 	/*
@@ -589,7 +589,7 @@ int fdtw_for_each_cpu(const void *dtb,
 	int ret = 0;
 	int parent, node = 0;
 
-	parent = fdt_path_offset(dtb, "/cpus");
+	parent = fdtw_path_offset(dtb, "/cpus");
 	if (parent < 0) {
 		return parent;
 	}
@@ -630,6 +630,7 @@ int fdtw_find_or_add_subnode(void *fdt, int parentoffset, const char *name)
 	offset = fdt_subnode_offset(fdt, parentoffset, name);
 
 	if (offset == -FDT_ERR_NOTFOUND) {
+		fdtw_index_invalidate(fdt);
 		offset = fdt_add_subnode(fdt, parentoffset, name);
 	}
 
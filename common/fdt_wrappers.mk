@@ -1,7 +1,11 @@
 #
-# Copyright (c) 2021, Arm Limited. All rights reserved.
+# Copyright (c) 2021-2024, Arm Limited. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
 
 FDT_WRAPPERS_SOURCES	:=	common/fdt_wrappers.c
+
+ifeq (${FDT_INDEX},1)
+FDT_WRAPPERS_SOURCES	+=	common/fdt_index.c
+endif
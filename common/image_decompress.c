@@ -1,28 +1,93 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2024, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <assert.h>
+#include <errno.h>
 #include <stdint.h>
 
 #include <arch_helpers.h>
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/image_decompress.h>
+#include <drivers/io/io_storage.h>
+#include <plat/common/platform.h>
 
 static uintptr_t decompressor_buf_base;
 static uint32_t decompressor_buf_size;
 static decompressor_t *decompressor;
+static const decompressor_format_t *decompressor_formats;
+static unsigned int decompressor_num_formats;
 static struct image_info saved_image_info;
 
+/* Bytes of the temporary buffer used by the last decompression */
+static size_t decompressor_high_water;
+
+#if !TRUSTED_BOARD_BOOT
+static uint32_t stream_chunk_size;
+static stream_decompressor_t *stream_decompressor;
+
+/* Compressed input of image_decompress_stream() */
+struct decompress_stream {
+	uintptr_t image_handle;
+	size_t remaining;
+};
+#endif
+
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *_decompressor)
 {
 	decompressor_buf_base = buf_base;
 	decompressor_buf_size = buf_size;
 	decompressor = _decompressor;
+	decompressor_formats = NULL;
+	decompressor_num_formats = 0U;
+}
+
+/*
+ * Same as image_decompress_init(), but the decompressor of each image is
+ * picked from 'formats' according to the magic bytes of its compressed data.
+ */
+void image_decompress_init_formats(uintptr_t buf_base, uint32_t buf_size,
+				   const decompressor_format_t *formats,
+				   unsigned int num_formats)
+{
+	assert((formats != NULL) && (num_formats != 0U));
+
+	decompressor_buf_base = buf_base;
+	decompressor_buf_size = buf_size;
+	decompressor = NULL;
+	decompressor_formats = formats;
+	decompressor_num_formats = num_formats;
+}
+
+static decompressor_t *image_decompress_find(uintptr_t base, uint32_t size)
+{
+	const uint8_t *data = (const uint8_t *)base;
+	uint32_t magic;
+	unsigned int i;
+
+	if (decompressor_formats == NULL) {
+		return decompressor;
+	}
+
+	if (size < sizeof(magic)) {
+		return NULL;
+	}
+
+	magic = (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+		((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+
+	for (i = 0U; i < decompressor_num_formats; i++) {
+		if ((magic & decompressor_formats[i].magic_mask) ==
+		    decompressor_formats[i].magic) {
+			return decompressor_formats[i].decompressor;
+		}
+	}
+
+	return NULL;
 }
 
 void image_decompress_prepare(struct image_info *info)
@@ -42,6 +107,7 @@ int image_decompress(struct image_info *info)
 {
 	uintptr_t compressed_image_base, image_base, work_base;
 	uint32_t compressed_image_size, work_size;
+	decompressor_t *decompress;
 	int ret;
 
 	/*
@@ -63,7 +129,17 @@ int image_decompress(struct image_info *info)
 	work_base = compressed_image_base + compressed_image_size;
 	work_size = decompressor_buf_size - compressed_image_size;
 
-	ret = decompressor(&compressed_image_base, compressed_image_size,
+	decompress = image_decompress_find(compressed_image_base,
+					   compressed_image_size);
+	if (decompress == NULL) {
+		ERROR("Unknown compressed image format\n");
+		return -EINVAL;
+	}
+
+	/* The decompressor doesn't tell how much workspace it used */
+	decompressor_high_water = decompressor_buf_size;
+
+	ret = decompress(&compressed_image_base, compressed_image_size,
 			   &image_base, info->image_max_size,
 			   work_base, work_size);
 	if (ret) {
@@ -78,3 +154,135 @@ int image_decompress(struct image_info *info)
 
 	return 0;
 }
+
+#if !TRUSTED_BOARD_BOOT
+/*******************************************************************************
+ * Set up the decompression of images streamed from their storage. The
+ * compressed data is read in chunks of 'chunk_size' bytes into the start of the
+ * temporary buffer, and the rest of the buffer is the decompressor workspace.
+ * Unlike image_decompress(), this doesn't require a temporary buffer as large
+ * as the compressed images.
+ ******************************************************************************/
+void image_decompress_stream_init(uintptr_t buf_base, uint32_t buf_size,
+				  uint32_t chunk_size,
+				  stream_decompressor_t *_decompressor)
+{
+	assert((chunk_size != 0U) && (chunk_size < buf_size));
+
+	decompressor_buf_base = buf_base;
+	decompressor_buf_size = buf_size;
+	stream_chunk_size = chunk_size;
+	stream_decompressor = _decompressor;
+}
+
+static int image_decompress_read(void *ctx, uintptr_t buf, size_t len,
+				 size_t *len_read)
+{
+	struct decompress_stream *stream = ctx;
+	int ret;
+
+	if (len > stream->remaining) {
+		len = stream->remaining;
+	}
+
+	*len_read = 0U;
+	if (len == 0U) {
+		return 0;
+	}
+
+	ret = io_read(stream->image_handle, buf, len, len_read);
+	if ((ret != 0) || (*len_read == 0U)) {
+		WARN("Failed to read compressed image (%i)\n", ret);
+		return (ret != 0) ? ret : -EIO;
+	}
+
+	stream->remaining -= *len_read;
+
+	return 0;
+}
+
+/*******************************************************************************
+ * Load the compressed image 'image_id' from its storage and decompress it to
+ * its destination described by 'info' as it is read. This replaces the calls
+ * to load_auth_image() and image_decompress() for that image, so it must be
+ * skipped by the generic image loading.
+ *
+ * The compressed image can't be authenticated as it is never held in memory,
+ * hence this is not available when TRUSTED_BOARD_BOOT is enabled. When measured
+ * boot is enabled, the decompressed image is measured.
+ ******************************************************************************/
+int image_decompress_stream(unsigned int image_id, struct image_info *info)
+{
+	struct decompress_stream stream;
+	uintptr_t dev_handle, image_spec;
+	uintptr_t image_base = info->image_base;
+	size_t work_used = 0U;
+	int ret;
+
+	assert(stream_decompressor != NULL);
+
+	ret = plat_get_image_source(image_id, &dev_handle, &image_spec);
+	if (ret != 0) {
+		WARN("Failed to obtain reference to image id=%u (%i)\n",
+		     image_id, ret);
+		return ret;
+	}
+
+	ret = io_open(dev_handle, image_spec, &stream.image_handle);
+	if (ret != 0) {
+		WARN("Failed to access image id=%u (%i)\n", image_id, ret);
+		return ret;
+	}
+
+	ret = io_size(stream.image_handle, &stream.remaining);
+	if ((ret != 0) || (stream.remaining == 0U)) {
+		WARN("Failed to determine the size of the image id=%u (%i)\n",
+		     image_id, ret);
+		ret = (ret != 0) ? ret : -EIO;
+		goto exit;
+	}
+
+	INFO("Decompressing image id=%u at address 0x%lx\n", image_id,
+	     image_base);
+
+	ret = stream_decompressor(image_decompress_read, &stream,
+				  decompressor_buf_base, stream_chunk_size,
+				  &image_base, info->image_max_size,
+				  decompressor_buf_base + stream_chunk_size,
+				  decompressor_buf_size - stream_chunk_size,
+				  &work_used);
+
+	decompressor_high_water = stream_chunk_size + work_used;
+
+	if (ret != 0) {
+		ERROR("Failed to decompress image (err=%d)\n", ret);
+		goto exit;
+	}
+
+	/* image_base is updated to the final pos when decompressor() exits. */
+	info->image_size = image_base - info->image_base;
+
+	ret = plat_mboot_measure_image(image_id, info);
+	if (ret != 0) {
+		goto exit;
+	}
+
+	flush_dcache_range(info->image_base, info->image_size);
+
+exit:
+	(void)io_close(stream.image_handle);
+	(void)io_dev_close(dev_handle);
+
+	return ret;
+}
+#endif /* !TRUSTED_BOARD_BOOT */
+
+/*******************************************************************************
+ * Return the number of bytes at the start of the temporary buffer which were
+ * used by the last decompression. The rest of the buffer was left untouched and
+ * can be reused by the platform.
+ ******************************************************************************/
+size_t image_decompress_high_water(void)
+{
+	return decompressor_high_water;
+}
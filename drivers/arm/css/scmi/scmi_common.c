@@ -24,23 +24,57 @@
 #endif
 
 
+/*
+ * Wait for SCP to hand the ownership of the channel back to AP.
+ */
+static void scmi_wait_channel_free(scmi_channel_t *ch)
+{
+	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+
+	while (!SCMI_IS_CHANNEL_FREE(mbx_mem->status)) {
+		if (ch->info->delay != 0)
+			udelay(ch->info->delay);
+	}
+
+	/*
+	 * Ensure that any read to the SCMI payload area is done after reading
+	 * mailbox status. If these 2 reads were reordered then the CPU would
+	 * read invalid payload data
+	 */
+	dmbld();
+}
+
 /*
  * Private helper function to get exclusive access to SCMI channel.
  */
 void scmi_get_channel(scmi_channel_t *ch)
 {
+	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
+	int ret;
+
 	assert(ch->lock);
 	scmi_lock_get(ch->lock);
 
-	/* Make sure any previous command has finished */
-	assert(SCMI_IS_CHANNEL_FREE(
-			((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->status));
+	/*
+	 * A command posted with scmi_post_command() may still be in progress.
+	 * Its response is checked here, as nobody waited for it.
+	 */
+	scmi_wait_channel_free(ch);
+
+	if (SCMI_MSG_GET_TOKEN(mbx_mem->msg_header) == SCMI_MSG_TOKEN_POSTED) {
+		SCMI_PAYLOAD_RET_VAL1(mbx_mem->payload, ret);
+		if ((ret != SCMI_E_SUCCESS) && (ret != SCMI_E_QUEUED)) {
+			ERROR("SCMI posted command 0x%x returned %d\n",
+			      mbx_mem->msg_header, ret);
+		}
+		mbx_mem->msg_header = 0U;
+	}
 }
 
 /*
  * Private helper function to transfer ownership of channel from AP to SCP.
  */
-void scmi_send_sync_command(scmi_channel_t *ch)
+static void scmi_ring_doorbell(scmi_channel_t *ch)
 {
 	mailbox_mem_t *mbx_mem = (mailbox_mem_t *)(ch->info->scmi_mbx_mem);
 
@@ -54,6 +88,16 @@ void scmi_send_sync_command(scmi_channel_t *ch)
 	dmbst();
 
 	ch->info->ring_doorbell(ch->info);
+}
+
+/*
+ * Private helper function to transfer ownership of channel from AP to SCP
+ * and wait for the response.
+ */
+void scmi_send_sync_command(scmi_channel_t *ch)
+{
+	scmi_ring_doorbell(ch);
+
 	/*
 	 * Ensure that the write to the doorbell register is ordered prior to
 	 * checking whether the channel is free.
@@ -61,17 +105,26 @@ void scmi_send_sync_command(scmi_channel_t *ch)
 	dmbsy();
 
 	/* Wait for channel to be free */
-	while (!SCMI_IS_CHANNEL_FREE(mbx_mem->status)) {
-		if (ch->info->delay != 0)
-			udelay(ch->info->delay);
-	}
+	scmi_wait_channel_free(ch);
+}
 
-	/*
-	 * Ensure that any read to the SCMI payload area is done after reading
-	 * mailbox status. If these 2 reads were reordered then the CPU would
-	 * read invalid payload data
-	 */
-	dmbld();
+/*
+ * Private helper function to transfer ownership of channel from AP to SCP and
+ * release exclusive access to it without waiting for the response. The
+ * message must have been created with the SCMI_MSG_TOKEN_POSTED token. The
+ * next user of the channel waits for the command to complete and reports an
+ * error response.
+ */
+void scmi_post_command(scmi_channel_t *ch)
+{
+	assert(SCMI_MSG_GET_TOKEN(((mailbox_mem_t *)
+			(ch->info->scmi_mbx_mem))->msg_header) ==
+	       SCMI_MSG_TOKEN_POSTED);
+
+	scmi_ring_doorbell(ch);
+
+	assert(ch->lock);
+	scmi_lock_release(ch->lock);
 }
 
 /*
@@ -172,6 +225,14 @@ void *scmi_init(scmi_channel_t *ch)
 
 	scmi_lock_init(ch->lock);
 
+	/*
+	 * Forget about the content of the mailbox, which has not been written
+	 * by this driver.
+	 */
+	assert(SCMI_IS_CHANNEL_FREE(
+			((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->status));
+	((mailbox_mem_t *)(ch->info->scmi_mbx_mem))->msg_header = 0U;
+
 	ch->is_initialized = 1;
 
 	ret = scmi_proto_version(ch, SCMI_PWR_DMN_PROTO_ID, &version);
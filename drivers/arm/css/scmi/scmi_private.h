@@ -73,6 +73,12 @@
 	(((_msg_id) & SCMI_MSG_ID_MASK) << SCMI_MSG_ID_SHIFT) |			\
 	(((_token) & SCMI_MSG_TOKEN_MASK) << SCMI_MSG_TOKEN_SHIFT))
 
+/*
+ * Token of the messages sent with scmi_post_command(). The other messages use
+ * token 0.
+ */
+#define SCMI_MSG_TOKEN_POSTED		1
+
 /* Helper macro to get the token from a SCMI message header */
 #define SCMI_MSG_GET_TOKEN(_msg)				\
 	(((_msg) >> SCMI_MSG_TOKEN_SHIFT) & SCMI_MSG_TOKEN_MASK)
@@ -144,6 +150,7 @@ typedef struct mailbox_mem {
 /* Private APIs for use within SCMI driver */
 void scmi_get_channel(scmi_channel_t *ch);
 void scmi_send_sync_command(scmi_channel_t *ch);
+void scmi_post_command(scmi_channel_t *ch);
 void scmi_put_channel(scmi_channel_t *ch);
 
 static inline void validate_scmi_channel(scmi_channel_t *ch)
@@ -102,6 +102,28 @@ static void css_scp_core_pos_to_scmi_channel(unsigned int core_pos,
 	*scmi_domain_id = GET_SCMI_DOMAIN_ID(composite_id);
 }
 
+/*
+ * Helper function to request the power down of the calling CPU power domain
+ * and its parent power domains if applicable. If CSS_SCMI_POSTED_PWR_STATE_SET
+ * is enabled, the CPU does not wait for the response of SCP, and an error is
+ * reported by the next CPU that uses the same SCMI channel.
+ */
+static int css_scp_pwr_down_self(uint32_t scmi_pwr_state)
+{
+	unsigned int channel_id, domain_id;
+
+	css_scp_core_pos_to_scmi_channel(plat_my_core_pos(),
+			&domain_id, &channel_id);
+#if CSS_SCMI_POSTED_PWR_STATE_SET
+	scmi_pwr_state_set_posted(scmi_handles[channel_id],
+		domain_id, scmi_pwr_state);
+	return SCMI_E_SUCCESS;
+#else
+	return scmi_pwr_state_set(scmi_handles[channel_id],
+		domain_id, scmi_pwr_state);
+#endif
+}
+
 /*
  * Helper function to suspend a CPU power domain and its parent power domains
  * if applicable.
@@ -128,7 +150,7 @@ void css_scp_suspend(const struct psci_power_state *target_state)
 		return;
 	}
 #if !HW_ASSISTED_COHERENCY
-	unsigned int lvl, channel_id, domain_id;
+	unsigned int lvl;
 	uint32_t scmi_pwr_state = 0;
 	/*
 	 * If we reach here, then assert that power down at system power domain
@@ -156,10 +178,7 @@ void css_scp_suspend(const struct psci_power_state *target_state)
 
 	SCMI_SET_PWR_STATE_MAX_PWR_LVL(scmi_pwr_state, lvl - 1);
 
-	css_scp_core_pos_to_scmi_channel(plat_my_core_pos(),
-			&domain_id, &channel_id);
-	ret = scmi_pwr_state_set(scmi_handles[channel_id],
-		domain_id, scmi_pwr_state);
+	ret = css_scp_pwr_down_self(scmi_pwr_state);
 
 	if (ret != SCMI_E_SUCCESS) {
 		ERROR("SCMI set power state command return 0x%x unexpected\n",
@@ -175,7 +194,7 @@ void css_scp_suspend(const struct psci_power_state *target_state)
  */
 void css_scp_off(const struct psci_power_state *target_state)
 {
-	unsigned int lvl = 0, channel_id, domain_id;
+	unsigned int lvl = 0;
 	int ret;
 	uint32_t scmi_pwr_state = 0;
 
@@ -198,10 +217,7 @@ void css_scp_off(const struct psci_power_state *target_state)
 
 	SCMI_SET_PWR_STATE_MAX_PWR_LVL(scmi_pwr_state, lvl - 1);
 
-	css_scp_core_pos_to_scmi_channel(plat_my_core_pos(),
-			&domain_id, &channel_id);
-	ret = scmi_pwr_state_set(scmi_handles[channel_id],
-		domain_id, scmi_pwr_state);
+	ret = css_scp_pwr_down_self(scmi_pwr_state);
 	if (ret != SCMI_E_QUEUED && ret != SCMI_E_SUCCESS) {
 		ERROR("SCMI set power state command return 0x%x unexpected\n",
 				ret);
@@ -391,7 +407,7 @@ void __init plat_arm_pwrc_setup(void)
 		INFO("Initializing SCMI driver on channel %d\n", idx);
 
 		scmi_channels[idx].info = plat_css_get_scmi_info(idx);
-		scmi_channels[idx].lock = ARM_SCMI_LOCK_GET_INSTANCE;
+		scmi_channels[idx].lock = ARM_SCMI_LOCK_GET_INSTANCE(idx);
 		scmi_handles[idx] = scmi_init(&scmi_channels[idx]);
 
 		if (scmi_handles[idx] == NULL) {
@@ -14,6 +14,7 @@
 #include <drivers/arm/gic600_multichip.h>
 #include <drivers/arm/gicv3.h>
 #include <lib/spinlock.h>
+#include <lib/utils.h>
 #include <plat/common/platform.h>
 
 #include "gicv3_private.h"
@@ -37,6 +38,41 @@ static spinlock_t gic_lock;
 /* Check for valid SGI/PPI or SPI interrupt ID */
 static bool is_valid_interrupt(unsigned int id);
 
+#if GICV3_SPARSE_SAVE_RESTORE
+/*
+ * Helper macros to record, while saving, which 32-INTID banks hold a non-reset
+ * value for a given register type, and to check it while restoring. Banks that
+ * are still in their reset state are not written back on restore.
+ */
+#define GICR_BANK_MARK(ctx, name, bank, val)				\
+	do {								\
+		if ((val) != 0U) {					\
+			(ctx)->gicr_banks.name |= BIT_32(bank);		\
+		}							\
+	} while (false)
+
+#define GICR_BANK_IS_SET(ctx, name, bank)				\
+	(((ctx)->gicr_banks.name & BIT_32(bank)) != 0U)
+
+#define GICD_BANK_MARK(ctx, reg, int_id, val)				\
+	do {								\
+		if ((val) != 0U) {					\
+			unsigned int _bank = gicd_bank_index(int_id);	\
+			(ctx)->gicd_banks.reg[_bank >> 5] |=		\
+					BIT_32(_bank & 0x1fU);		\
+		}							\
+	} while (false)
+
+#define GICD_BANK_IS_SET(ctx, reg, int_id)				\
+	(((ctx)->gicd_banks.reg[gicd_bank_index(int_id) >> 5] &	\
+	  BIT_32(gicd_bank_index(int_id) & 0x1fU)) != 0U)
+#else
+#define GICR_BANK_MARK(ctx, name, bank, val)
+#define GICR_BANK_IS_SET(ctx, name, bank)	true
+#define GICD_BANK_MARK(ctx, reg, int_id, val)
+#define GICD_BANK_IS_SET(ctx, reg, int_id)	true
+#endif /* GICV3_SPARSE_SAVE_RESTORE */
+
 /*
  * Helper macros to save and restore GICR and GICD registers
  * corresponding to their numbers to and from the context
@@ -47,14 +83,27 @@ static bool is_valid_interrupt(unsigned int id);
 #define SAVE_GICR_REG(base, ctx, name, i)	\
 	(ctx)->gicr_##name[(i)] = gicr_read_##name((base), (i))
 
-/* Helper macros to save and restore GICD registers to and from the context */
+/*
+ * Helper macros to save and restore GICD registers to and from the context.
+ * The restore macros walk the interrupt range one 32-INTID bank at a time so
+ * that banks which were found in their reset state at save time are skipped.
+ */
 #define RESTORE_GICD_REGS(base, ctx, intr_num, reg, REG)		\
 	do {								\
-		for (unsigned int int_id = MIN_SPI_ID; int_id < (intr_num);\
+		for (unsigned int bank_id = MIN_SPI_ID;		\
+				bank_id < (intr_num);			\
+				bank_id += (1U << GIC_BANK_SHIFT)) {	\
+			if (!GICD_BANK_IS_SET(ctx, reg, bank_id)) {	\
+				continue;				\
+			}						\
+			for (unsigned int int_id = bank_id;		\
+				(int_id < (intr_num)) && (int_id <	\
+				(bank_id + (1U << GIC_BANK_SHIFT)));	\
 				int_id += (1U << REG##R_SHIFT)) {	\
-			gicd_write_##reg((base), int_id,		\
+				gicd_write_##reg((base), int_id,	\
 				(ctx)->gicd_##reg[(int_id - MIN_SPI_ID) >> \
 							REG##R_SHIFT]);	\
+			}						\
 		}							\
 	} while (false)
 
@@ -64,18 +113,31 @@ static bool is_valid_interrupt(unsigned int id);
 				int_id += (1U << REG##R_SHIFT)) {	\
 			(ctx)->gicd_##reg[(int_id - MIN_SPI_ID) >>	\
 			REG##R_SHIFT] = gicd_read_##reg((base), int_id); \
+			GICD_BANK_MARK(ctx, reg, int_id,		\
+				(ctx)->gicd_##reg[(int_id - MIN_SPI_ID) >> \
+							REG##R_SHIFT]);	\
 		}							\
 	} while (false)
 
 #if GIC_EXT_INTID
 #define RESTORE_GICD_EREGS(base, ctx, intr_num, reg, REG)		\
 	do {								\
-		for (unsigned int int_id = MIN_ESPI_ID; int_id < (intr_num);\
+		for (unsigned int bank_id = MIN_ESPI_ID;		\
+				bank_id < (intr_num);			\
+				bank_id += (1U << GIC_BANK_SHIFT)) {	\
+			if (!GICD_BANK_IS_SET(ctx, reg, bank_id)) {	\
+				continue;				\
+			}						\
+			for (unsigned int int_id = bank_id;		\
+				(int_id < (intr_num)) && (int_id <	\
+				(bank_id + (1U << GIC_BANK_SHIFT)));	\
 				int_id += (1U << REG##R_SHIFT)) {	\
-			gicd_write_##reg((base), int_id,		\
-			(ctx)->gicd_##reg[(int_id - (MIN_ESPI_ID -	\
-			round_up(TOTAL_SPI_INTR_NUM, 1U << REG##R_SHIFT)))\
+				gicd_write_##reg((base), int_id,	\
+				(ctx)->gicd_##reg[(int_id - (MIN_ESPI_ID - \
+				round_up(TOTAL_SPI_INTR_NUM,		\
+					1U << REG##R_SHIFT)))		\
 						>> REG##R_SHIFT]);	\
+			}						\
 		}							\
 	} while (false)
 
@@ -86,6 +148,11 @@ static bool is_valid_interrupt(unsigned int id);
 			(ctx)->gicd_##reg[(int_id - (MIN_ESPI_ID -	\
 			round_up(TOTAL_SPI_INTR_NUM, 1U << REG##R_SHIFT)))\
 			>> REG##R_SHIFT] = gicd_read_##reg((base), int_id);\
+			GICD_BANK_MARK(ctx, reg, int_id,		\
+				(ctx)->gicd_##reg[(int_id - (MIN_ESPI_ID - \
+				round_up(TOTAL_SPI_INTR_NUM,		\
+					1U << REG##R_SHIFT)))		\
+						>> REG##R_SHIFT]);	\
 		}							\
 	} while (false)
 #else
@@ -93,6 +160,24 @@ static bool is_valid_interrupt(unsigned int id);
 #define RESTORE_GICD_EREGS(base, ctx, intr_num, reg, REG)
 #endif /* GIC_EXT_INTID */
 
+#if GICV3_SPARSE_SAVE_RESTORE
+/*
+ * Return the index of the 32-INTID bank of the (E)SPI range 'int_id' belongs
+ * to. ESPI banks are placed after the SPI ones.
+ */
+static inline unsigned int gicd_bank_index(unsigned int int_id)
+{
+#if GIC_EXT_INTID
+	if (int_id >= MIN_ESPI_ID) {
+		return ((int_id - MIN_ESPI_ID) >> GIC_BANK_SHIFT) +
+			(round_up(TOTAL_SPI_INTR_NUM, 1U << GIC_BANK_SHIFT) >>
+			 GIC_BANK_SHIFT);
+	}
+#endif
+	return (int_id - MIN_SPI_ID) >> GIC_BANK_SHIFT;
+}
+#endif /* GICV3_SPARSE_SAVE_RESTORE */
+
 /*******************************************************************************
  * This function initialises the ARM GICv3 driver in EL3 with provided platform
  * inputs.
@@ -593,28 +678,47 @@ void gicv3_rdistif_save(unsigned int proc_num,
 	rdist_ctx->gicr_propbaser = gicr_read_propbaser(gicr_base);
 	rdist_ctx->gicr_pendbaser = gicr_read_pendbaser(gicr_base);
 
+#if GICV3_SPARSE_SAVE_RESTORE
+	zeromem(&rdist_ctx->gicr_banks, sizeof(rdist_ctx->gicr_banks));
+#endif
+
 	/* 32 interrupt IDs per register */
 	for (i = 0U; i < ppi_regs_num; ++i) {
 		SAVE_GICR_REG(gicr_base, rdist_ctx, igroupr, i);
+		GICR_BANK_MARK(rdist_ctx, igroupr, i,
+			       rdist_ctx->gicr_igroupr[i]);
 		SAVE_GICR_REG(gicr_base, rdist_ctx, isenabler, i);
+		GICR_BANK_MARK(rdist_ctx, isenabler, i,
+			       rdist_ctx->gicr_isenabler[i]);
 		SAVE_GICR_REG(gicr_base, rdist_ctx, ispendr, i);
+		GICR_BANK_MARK(rdist_ctx, ispendr, i,
+			       rdist_ctx->gicr_ispendr[i]);
 		SAVE_GICR_REG(gicr_base, rdist_ctx, isactiver, i);
+		GICR_BANK_MARK(rdist_ctx, isactiver, i,
+			       rdist_ctx->gicr_isactiver[i]);
 		SAVE_GICR_REG(gicr_base, rdist_ctx, igrpmodr, i);
+		GICR_BANK_MARK(rdist_ctx, igrpmodr, i,
+			       rdist_ctx->gicr_igrpmodr[i]);
 	}
 
 	/* 16 interrupt IDs per GICR_ICFGR register */
 	regs_num = ppi_regs_num << 1;
 	for (i = 0U; i < regs_num; ++i) {
 		SAVE_GICR_REG(gicr_base, rdist_ctx, icfgr, i);
+		GICR_BANK_MARK(rdist_ctx, icfgr, i >> 1,
+			       rdist_ctx->gicr_icfgr[i]);
 	}
 
 	rdist_ctx->gicr_nsacr = gicr_read_nsacr(gicr_base);
+	GICR_BANK_MARK(rdist_ctx, nsacr, 0U, rdist_ctx->gicr_nsacr);
 
 	/* 4 interrupt IDs per GICR_IPRIORITYR register */
 	regs_num = ppi_regs_num << 3;
 	for (i = 0U; i < regs_num; ++i) {
 		rdist_ctx->gicr_ipriorityr[i] =
 		gicr_ipriorityr_read(gicr_base, i);
+		GICR_BANK_MARK(rdist_ctx, ipriorityr, i >> 3,
+			       rdist_ctx->gicr_ipriorityr[i]);
 	}
 
 	/*
@@ -692,31 +796,45 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 
 	/* 32 interrupt IDs per register */
 	for (i = 0U; i < ppi_regs_num; ++i) {
-		RESTORE_GICR_REG(gicr_base, rdist_ctx, igroupr, i);
-		RESTORE_GICR_REG(gicr_base, rdist_ctx, igrpmodr, i);
+		if (GICR_BANK_IS_SET(rdist_ctx, igroupr, i)) {
+			RESTORE_GICR_REG(gicr_base, rdist_ctx, igroupr, i);
+		}
+		if (GICR_BANK_IS_SET(rdist_ctx, igrpmodr, i)) {
+			RESTORE_GICR_REG(gicr_base, rdist_ctx, igrpmodr, i);
+		}
 	}
 
 	/* 4 interrupt IDs per GICR_IPRIORITYR register */
 	regs_num = ppi_regs_num << 3;
 	for (i = 0U; i < regs_num; ++i) {
-		gicr_ipriorityr_write(gicr_base, i,
+		if (GICR_BANK_IS_SET(rdist_ctx, ipriorityr, i >> 3)) {
+			gicr_ipriorityr_write(gicr_base, i,
 					rdist_ctx->gicr_ipriorityr[i]);
+		}
 	}
 
 	/* 16 interrupt IDs per GICR_ICFGR register */
 	regs_num = ppi_regs_num << 1;
 	for (i = 0U; i < regs_num; ++i) {
-		RESTORE_GICR_REG(gicr_base, rdist_ctx, icfgr, i);
+		if (GICR_BANK_IS_SET(rdist_ctx, icfgr, i >> 1)) {
+			RESTORE_GICR_REG(gicr_base, rdist_ctx, icfgr, i);
+		}
 	}
 
-	gicr_write_nsacr(gicr_base, rdist_ctx->gicr_nsacr);
+	if (GICR_BANK_IS_SET(rdist_ctx, nsacr, 0U)) {
+		gicr_write_nsacr(gicr_base, rdist_ctx->gicr_nsacr);
+	}
 
 	/* Restore after group and priorities are set.
 	 * 32 interrupt IDs per register
 	 */
 	for (i = 0U; i < ppi_regs_num; ++i) {
-		RESTORE_GICR_REG(gicr_base, rdist_ctx, ispendr, i);
-		RESTORE_GICR_REG(gicr_base, rdist_ctx, isactiver, i);
+		if (GICR_BANK_IS_SET(rdist_ctx, ispendr, i)) {
+			RESTORE_GICR_REG(gicr_base, rdist_ctx, ispendr, i);
+		}
+		if (GICR_BANK_IS_SET(rdist_ctx, isactiver, i)) {
+			RESTORE_GICR_REG(gicr_base, rdist_ctx, isactiver, i);
+		}
 	}
 
 	/*
@@ -727,7 +845,9 @@ void gicv3_rdistif_init_restore(unsigned int proc_num,
 
 	/* 32 interrupt IDs per GICR_ISENABLER register */
 	for (i = 0U; i < ppi_regs_num; ++i) {
-		RESTORE_GICR_REG(gicr_base, rdist_ctx, isenabler, i);
+		if (GICR_BANK_IS_SET(rdist_ctx, isenabler, i)) {
+			RESTORE_GICR_REG(gicr_base, rdist_ctx, isenabler, i);
+		}
 	}
 
 	/*
@@ -763,6 +883,10 @@ void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx)
 	/* Save the GICD_CTLR */
 	dist_ctx->gicd_ctlr = gicd_read_ctlr(gicd_base);
 
+#if GICV3_SPARSE_SAVE_RESTORE
+	zeromem(&dist_ctx->gicd_banks, sizeof(dist_ctx->gicd_banks));
+#endif
+
 	/* Save GICD_IGROUPR for INTIDs 32 - 1019 */
 	SAVE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUP);
 
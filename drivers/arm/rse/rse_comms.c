@@ -4,15 +4,30 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 
+#include <arch_helpers.h>
 #include <common/debug.h>
 #include <drivers/arm/mhu.h>
 #include <drivers/arm/rse_comms.h>
+#include <lib/spinlock.h>
 #include <psa/client.h>
 #include <rse_comms_protocol.h>
 
+#include <platform_def.h>
+
+/*
+ * Number of callers which can have a PSA call in progress at the same time,
+ * each of them owning a message buffer. A single buffer is enough for the boot
+ * stages, platforms making PSA calls from several cores at runtime should
+ * raise it in their platform_def.h.
+ */
+#ifndef PLAT_RSE_COMMS_MAX_CLIENTS
+#define PLAT_RSE_COMMS_MAX_CLIENTS	1U
+#endif
+
 /* Union as message space and reply space are never used at the same time, and this saves space as
  * we can overlap them.
  */
@@ -21,6 +36,115 @@ union __packed __attribute__((aligned(4))) rse_comms_io_buffer_t {
 	struct serialized_rse_comms_reply_t reply;
 };
 
+/*
+ * Declared statically to avoid using huge amounts of stack space. Callers
+ * serialize their message and deserialize the reply in their own buffer in
+ * parallel, only the exchange over MHU is serialized.
+ */
+static union rse_comms_io_buffer_t io_bufs[PLAT_RSE_COMMS_MAX_CLIENTS];
+static bool io_buf_busy[PLAT_RSE_COMMS_MAX_CLIENTS];
+static spinlock_t io_buf_lock;
+
+/* Protects the MHU channel and the sequence number */
+static spinlock_t mhu_lock;
+static uint8_t seq_num = 1U;
+
+static union rse_comms_io_buffer_t *get_io_buf(void)
+{
+	unsigned int i;
+
+	for (;;) {
+		spin_lock(&io_buf_lock);
+		for (i = 0U; i < PLAT_RSE_COMMS_MAX_CLIENTS; i++) {
+			if (!io_buf_busy[i]) {
+				io_buf_busy[i] = true;
+				spin_unlock(&io_buf_lock);
+				return &io_bufs[i];
+			}
+		}
+		spin_unlock(&io_buf_lock);
+
+		/*
+		 * Wait for put_io_buf() to release a buffer. An event sent
+		 * since the lock was released is not lost, wfe() then returns
+		 * immediately.
+		 */
+		wfe();
+	}
+}
+
+static void put_io_buf(union rse_comms_io_buffer_t *io_buf)
+{
+	/* Clear the MHU message buffer to remove assets from memory */
+	memset(io_buf, 0x0, sizeof(*io_buf));
+
+	spin_lock(&io_buf_lock);
+	io_buf_busy[io_buf - io_bufs] = false;
+	spin_unlock(&io_buf_lock);
+
+	/* Wake up the callers waiting for a buffer in get_io_buf() */
+	dsbish();
+	sev();
+}
+
+/*
+ * Send the message in the buffer and wait for the matching reply, which
+ * overwrites the message in the buffer.
+ */
+static psa_status_t rse_comms_exchange(union rse_comms_io_buffer_t *io_buf,
+				       size_t msg_size, size_t *reply_size)
+{
+	struct serialized_rse_comms_header_t header;
+	enum mhu_error_t err;
+
+	spin_lock(&mhu_lock);
+
+	io_buf->msg.header.seq_num = seq_num++;
+	header = io_buf->msg.header;
+
+	VERBOSE("[RSE-COMMS] Sending message\n");
+	VERBOSE("protocol_ver=%u\n", header.protocol_ver);
+	VERBOSE("seq_num=%u\n", header.seq_num);
+	VERBOSE("client_id=%u\n", header.client_id);
+
+	err = mhu_send_data((uint8_t *)&io_buf->msg, msg_size);
+	if (err != MHU_ERR_NONE) {
+		spin_unlock(&mhu_lock);
+		return PSA_ERROR_COMMUNICATION_FAILURE;
+	}
+
+#if DEBUG
+	/*
+	 * Poisoning the message buffer (with a known pattern).
+	 * Helps in detecting hypothetical RSE communication bugs.
+	 */
+	memset(&io_buf->msg, 0xA5, msg_size);
+#endif
+
+	err = mhu_receive_data((uint8_t *)&io_buf->reply, reply_size);
+
+	spin_unlock(&mhu_lock);
+
+	if (err != MHU_ERR_NONE) {
+		return PSA_ERROR_COMMUNICATION_FAILURE;
+	}
+
+	VERBOSE("[RSE-COMMS] Received reply\n");
+	VERBOSE("protocol_ver=%u\n", io_buf->reply.header.protocol_ver);
+	VERBOSE("seq_num=%u\n", io_buf->reply.header.seq_num);
+	VERBOSE("client_id=%u\n", io_buf->reply.header.client_id);
+
+	/* A reply to another message must never be passed to the caller */
+	if ((io_buf->reply.header.seq_num != header.seq_num) ||
+	    (io_buf->reply.header.client_id != header.client_id)) {
+		ERROR("[RSE-COMMS] Unexpected reply seq_num=%u (expected %u)\n",
+		      io_buf->reply.header.seq_num, header.seq_num);
+		return PSA_ERROR_COMMUNICATION_FAILURE;
+	}
+
+	return PSA_SUCCESS;
+}
+
 static uint8_t select_protocol_version(const psa_invec *in_vec, size_t in_len,
 				       const psa_outvec *out_vec, size_t out_len)
 {
@@ -72,15 +196,10 @@ static uint8_t select_protocol_version(const psa_invec *in_vec, size_t in_len,
 psa_status_t psa_call(psa_handle_t handle, int32_t type, const psa_invec *in_vec, size_t in_len,
 		      psa_outvec *out_vec, size_t out_len)
 {
-	/* Declared statically to avoid using huge amounts of stack space. Maybe revisit if
-	 * functions not being reentrant becomes a problem.
-	 */
-	static union rse_comms_io_buffer_t io_buf;
-	enum mhu_error_t err;
+	union rse_comms_io_buffer_t *io_buf;
 	psa_status_t status;
-	static uint8_t seq_num = 1U;
 	size_t msg_size;
-	size_t reply_size = sizeof(io_buf.reply);
+	size_t reply_size = sizeof(io_buf->reply);
 	psa_status_t return_val;
 	size_t idx;
 
@@ -89,53 +208,36 @@ psa_status_t psa_call(psa_handle_t handle, int32_t type, const psa_invec *in_vec
 		return PSA_ERROR_INVALID_ARGUMENT;
 	}
 
-	io_buf.msg.header.seq_num = seq_num,
-	/* No need to distinguish callers (currently concurrent calls are not supported). */
-	io_buf.msg.header.client_id = 1U,
-	io_buf.msg.header.protocol_ver = select_protocol_version(in_vec, in_len, out_vec, out_len);
+	io_buf = get_io_buf();
+
+	/*
+	 * All the callers share the same client ID, as RSE derives the
+	 * identity of the caller from it. Replies are matched with their
+	 * message by sequence number.
+	 */
+	io_buf->msg.header.client_id = 1U;
+	io_buf->msg.header.protocol_ver = select_protocol_version(in_vec, in_len, out_vec, out_len);
 
 	status = rse_protocol_serialize_msg(handle, type, in_vec, in_len, out_vec,
-					    out_len, &io_buf.msg, &msg_size);
+					    out_len, &io_buf->msg, &msg_size);
 	if (status != PSA_SUCCESS) {
-		return status;
+		goto out;
 	}
 
-	VERBOSE("[RSE-COMMS] Sending message\n");
-	VERBOSE("protocol_ver=%u\n", io_buf.msg.header.protocol_ver);
-	VERBOSE("seq_num=%u\n", io_buf.msg.header.seq_num);
-	VERBOSE("client_id=%u\n", io_buf.msg.header.client_id);
 	for (idx = 0; idx < in_len; idx++) {
 		VERBOSE("in_vec[%lu].len=%lu\n", idx, in_vec[idx].len);
 		VERBOSE("in_vec[%lu].buf=%p\n", idx, (void *)in_vec[idx].base);
 	}
 
-	err = mhu_send_data((uint8_t *)&io_buf.msg, msg_size);
-	if (err != MHU_ERR_NONE) {
-		return PSA_ERROR_COMMUNICATION_FAILURE;
-	}
-
-#if DEBUG
-	/*
-	 * Poisoning the message buffer (with a known pattern).
-	 * Helps in detecting hypothetical RSE communication bugs.
-	 */
-	memset(&io_buf.msg, 0xA5, msg_size);
-#endif
-
-	err = mhu_receive_data((uint8_t *)&io_buf.reply, &reply_size);
-	if (err != MHU_ERR_NONE) {
-		return PSA_ERROR_COMMUNICATION_FAILURE;
+	status = rse_comms_exchange(io_buf, msg_size, &reply_size);
+	if (status != PSA_SUCCESS) {
+		goto out;
 	}
 
-	VERBOSE("[RSE-COMMS] Received reply\n");
-	VERBOSE("protocol_ver=%u\n", io_buf.reply.header.protocol_ver);
-	VERBOSE("seq_num=%u\n", io_buf.reply.header.seq_num);
-	VERBOSE("client_id=%u\n", io_buf.reply.header.client_id);
-
 	status = rse_protocol_deserialize_reply(out_vec, out_len, &return_val,
-						&io_buf.reply, reply_size);
+						&io_buf->reply, reply_size);
 	if (status != PSA_SUCCESS) {
-		return status;
+		goto out;
 	}
 
 	VERBOSE("return_val=%d\n", return_val);
@@ -144,12 +246,12 @@ psa_status_t psa_call(psa_handle_t handle, int32_t type, const psa_invec *in_vec
 		VERBOSE("out_vec[%lu].buf=%p\n", idx, (void *)out_vec[idx].base);
 	}
 
-	/* Clear the MHU message buffer to remove assets from memory */
-	memset(&io_buf, 0x0, sizeof(io_buf));
+	status = return_val;
 
-	seq_num++;
+out:
+	put_io_buf(io_buf);
 
-	return return_val;
+	return status;
 }
 
 int rse_comms_init(uintptr_t mhu_sender_base, uintptr_t mhu_receiver_base)
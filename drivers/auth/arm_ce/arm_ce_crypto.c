@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <arch_features.h>
+#include <arch_helpers.h>
+#include <drivers/auth/arm_ce/arm_ce_crypto.h>
+#include <drivers/auth/crypto_mod.h>
+#include <lib/utils_def.h>
+
+#define LIB_NAME		"Arm Cryptographic Extension"
+
+#define SHA256_BLOCK_SIZE	64U
+#define SHA256_DIGEST_SIZE	32U
+
+/* Context of the hash calculation in progress */
+static struct {
+	uint32_t state[8];
+	uint8_t buf[SHA256_BLOCK_SIZE];
+	size_t buf_len;
+	uint64_t total_len;
+} sha256_ctx;
+
+static const uint32_t sha256_init_state[8] = {
+	0x6a09e667U, 0xbb67ae85U, 0x3c6ef372U, 0xa54ff53aU,
+	0x510e527fU, 0x9b05688cU, 0x1f83d9abU, 0x5be0cd19U,
+};
+
+static bool sha256_present;
+
+static void init(void)
+{
+	sha256_present = is_feat_sha256_present();
+}
+
+/*
+ * Process blocks of data with the SIMD registers. Accesses to them from EL3
+ * are trapped outside of the context switch code, so they are enabled for
+ * the duration of the processing.
+ */
+static void sha256_blocks(const uint8_t *data, size_t num_blocks)
+{
+	u_register_t cptr_el3 = 0U;
+
+	if (IS_IN_EL3()) {
+		cptr_el3 = read_cptr_el3();
+		write_cptr_el3(cptr_el3 & ~TFP_BIT);
+		isb();
+	}
+
+	sha256_ce_blocks(sha256_ctx.state, data, num_blocks);
+
+	if (IS_IN_EL3()) {
+		write_cptr_el3(cptr_el3);
+		isb();
+	}
+}
+
+static int calc_hash_init(enum crypto_md_algo md_algo)
+{
+	if ((md_algo != CRYPTO_MD_SHA256) || !sha256_present) {
+		return CRYPTO_ERR_NOT_SUPPORTED;
+	}
+
+	(void)memcpy(sha256_ctx.state, sha256_init_state,
+		     sizeof(sha256_ctx.state));
+	sha256_ctx.buf_len = 0U;
+	sha256_ctx.total_len = 0U;
+
+	return CRYPTO_SUCCESS;
+}
+
+static int calc_hash_update(const void *data_ptr, size_t len)
+{
+	const uint8_t *data = data_ptr;
+	size_t n;
+
+	sha256_ctx.total_len += len;
+
+	/* Complete the block started by a previous update */
+	if (sha256_ctx.buf_len != 0U) {
+		n = MIN(len, SHA256_BLOCK_SIZE - sha256_ctx.buf_len);
+		(void)memcpy(&sha256_ctx.buf[sha256_ctx.buf_len], data, n);
+		sha256_ctx.buf_len += n;
+		data += n;
+		len -= n;
+
+		if (sha256_ctx.buf_len < SHA256_BLOCK_SIZE) {
+			return CRYPTO_SUCCESS;
+		}
+
+		sha256_blocks(sha256_ctx.buf, 1U);
+		sha256_ctx.buf_len = 0U;
+	}
+
+	n = len / SHA256_BLOCK_SIZE;
+	if (n != 0U) {
+		sha256_blocks(data, n);
+		data += n * SHA256_BLOCK_SIZE;
+		len -= n * SHA256_BLOCK_SIZE;
+	}
+
+	(void)memcpy(sha256_ctx.buf, data, len);
+	sha256_ctx.buf_len = len;
+
+	return CRYPTO_SUCCESS;
+}
+
+static int calc_hash_finish(unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	uint64_t bit_len = sha256_ctx.total_len * 8U;
+	unsigned int i;
+
+	/* Pad with a one bit, zeroes and the big-endian length in bits */
+	sha256_ctx.buf[sha256_ctx.buf_len++] = 0x80U;
+	if (sha256_ctx.buf_len > (SHA256_BLOCK_SIZE - sizeof(bit_len))) {
+		(void)memset(&sha256_ctx.buf[sha256_ctx.buf_len], 0,
+			     SHA256_BLOCK_SIZE - sha256_ctx.buf_len);
+		sha256_blocks(sha256_ctx.buf, 1U);
+		sha256_ctx.buf_len = 0U;
+	}
+
+	(void)memset(&sha256_ctx.buf[sha256_ctx.buf_len], 0,
+		     SHA256_BLOCK_SIZE - sizeof(bit_len) - sha256_ctx.buf_len);
+	for (i = 0U; i < sizeof(bit_len); i++) {
+		sha256_ctx.buf[SHA256_BLOCK_SIZE - 1U - i] =
+			(uint8_t)(bit_len >> (8U * i));
+	}
+	sha256_blocks(sha256_ctx.buf, 1U);
+
+	for (i = 0U; i < SHA256_DIGEST_SIZE; i++) {
+		output[i] = (uint8_t)(sha256_ctx.state[i / 4U] >>
+				      (24U - (8U * (i % 4U))));
+	}
+
+	/* Do not leave data behind */
+	(void)memset(&sha256_ctx, 0, sizeof(sha256_ctx));
+
+	return CRYPTO_SUCCESS;
+}
+
+static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
+		     unsigned int data_len,
+		     unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	int rc;
+
+	rc = calc_hash_init(md_algo);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	(void)calc_hash_update(data_ptr, data_len);
+
+	return calc_hash_finish(output);
+}
+
+#if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
+CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
+/*
+ * DER encoding of the AlgorithmIdentifier of SHA-256, with NULL parameters,
+ * followed by the header of the digest OCTET STRING.
+ */
+static const uint8_t sha256_alg_null_params[] = {
+	0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01,
+	0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04,
+	0x20,
+};
+
+/* Same with absent parameters */
+static const uint8_t sha256_alg_no_params[] = {
+	0x30, 0x0b, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01,
+	0x65, 0x03, 0x04, 0x02, 0x01, 0x04, 0x20,
+};
+
+/*
+ * Return a pointer to the SHA-256 digest in a DER encoded DigestInfo, or NULL
+ * if it is not a DigestInfo of a SHA-256 digest. As in the mbed TLS library,
+ * padding is allowed after the DigestInfo.
+ */
+static const uint8_t *sha256_digest_info_hash(const uint8_t *p, size_t len)
+{
+	const uint8_t *alg;
+	size_t alg_len;
+
+	if ((len < 2U) || (p[0] != 0x30U)) {
+		return NULL;
+	}
+
+	if (p[1] == (sizeof(sha256_alg_null_params) + SHA256_DIGEST_SIZE)) {
+		alg = sha256_alg_null_params;
+		alg_len = sizeof(sha256_alg_null_params);
+	} else if (p[1] == (sizeof(sha256_alg_no_params) + SHA256_DIGEST_SIZE)) {
+		alg = sha256_alg_no_params;
+		alg_len = sizeof(sha256_alg_no_params);
+	} else {
+		return NULL;
+	}
+
+	if (((len - 2U) < (alg_len + SHA256_DIGEST_SIZE)) ||
+	    (memcmp(&p[2], alg, alg_len) != 0)) {
+		return NULL;
+	}
+
+	return &p[2U + alg_len];
+}
+
+/*
+ * Verify a SHA-256 hash. Other algorithms, and DigestInfo encodings not
+ * recognised here, are left to the library the crypto module falls back to.
+ */
+static int verify_hash(void *data_ptr, unsigned int data_len,
+		       void *digest_info_ptr, unsigned int digest_info_len)
+{
+	unsigned char data_hash[CRYPTO_MD_MAX_SIZE];
+	const uint8_t *hash;
+	uint8_t diff = 0U;
+	unsigned int i;
+	int rc;
+
+	hash = sha256_digest_info_hash(digest_info_ptr, digest_info_len);
+	if (hash == NULL) {
+		return CRYPTO_ERR_NOT_SUPPORTED;
+	}
+
+	rc = calc_hash(CRYPTO_MD_SHA256, data_ptr, data_len, data_hash);
+	if (rc != CRYPTO_SUCCESS) {
+		return rc;
+	}
+
+	/* Compare in constant time */
+	for (i = 0U; i < SHA256_DIGEST_SIZE; i++) {
+		diff |= data_hash[i] ^ hash[i];
+	}
+
+	return (diff == 0U) ? CRYPTO_SUCCESS : CRYPTO_ERR_HASH;
+}
+#endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
+	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
+
+const crypto_lib_desc_t arm_ce_crypto_lib_desc = {
+	.name = LIB_NAME,
+	.init = init,
+#if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
+CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
+	.verify_hash = verify_hash,
+#endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
+	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
+	.calc_hash = calc_hash,
+	.calc_hash_init = calc_hash_init,
+	.calc_hash_update = calc_hash_update,
+	.calc_hash_finish = calc_hash_finish,
+};
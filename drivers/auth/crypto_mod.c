@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2023, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2024, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,10 +7,52 @@
 #include <assert.h>
 
 #include <common/debug.h>
+#include <drivers/auth/arm_ce/arm_ce_crypto.h>
 #include <drivers/auth/crypto_mod.h>
+#include <lib/utils_def.h>
 
 /* Variable exported by the crypto library through REGISTER_CRYPTO_LIB() */
 
+/*
+ * Libraries to which operations are offloaded, in decreasing order of
+ * priority, exported by the platform through REGISTER_CRYPTO_OFFLOAD_LIBS().
+ * By default, hash calculations are offloaded to the Cryptographic Extension
+ * when ARM_CE_HASH is enabled.
+ */
+#pragma weak crypto_offload_libs
+#if ARM_CE_HASH
+static const crypto_lib_desc_t *const default_offload_libs[] = {
+	&arm_ce_crypto_lib_desc,
+};
+
+const crypto_offload_libs_t crypto_offload_libs = {
+	.libs = default_offload_libs,
+	.num_libs = ARRAY_SIZE(default_offload_libs),
+};
+#else
+const crypto_offload_libs_t crypto_offload_libs = {
+	.libs = NULL,
+	.num_libs = 0U,
+};
+#endif /* ARM_CE_HASH */
+
+#if CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
+CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
+/* Library running the hash calculation in progress */
+static const crypto_lib_desc_t *hash_lib = &crypto_lib_desc;
+#endif /* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
+	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
+
+/* Library running the decryption in progress */
+static const crypto_lib_desc_t *dec_lib = &crypto_lib_desc;
+
+/* Offload library iterator */
+#define for_each_offload_lib(_i, _lib) \
+	for ((_i) = 0U; \
+	     ((_i) < crypto_offload_libs.num_libs) && \
+	     (((_lib) = crypto_offload_libs.libs[(_i)]) != NULL); \
+	     (_i)++)
+
 /*
  * The crypto module is responsible for verifying digital signatures and hashes.
  * It relies on a crypto library to perform the cryptographic operations.
@@ -44,6 +86,9 @@
  */
 void crypto_mod_init(void)
 {
+	const crypto_lib_desc_t *lib;
+	unsigned int i;
+
 	assert(crypto_lib_desc.name != NULL);
 	assert(crypto_lib_desc.init != NULL);
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
@@ -62,6 +107,15 @@ CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 	/* Initialize the cryptographic library */
 	crypto_lib_desc.init();
 	INFO("Using crypto library '%s'\n", crypto_lib_desc.name);
+
+	/* Initialize the libraries operations are offloaded to */
+	for_each_offload_lib(i, lib) {
+		assert(lib->name != NULL);
+		if (lib->init != NULL) {
+			lib->init();
+		}
+		INFO("Offloading to crypto library '%s'\n", lib->name);
+	}
 }
 
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY || \
@@ -81,6 +135,10 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 				void *sig_alg_ptr, unsigned int sig_alg_len,
 				void *pk_ptr, unsigned int pk_len)
 {
+	const crypto_lib_desc_t *lib;
+	unsigned int i;
+	int rc;
+
 	assert(data_ptr != NULL);
 	assert(data_len != 0);
 	assert(sig_ptr != NULL);
@@ -90,6 +148,18 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 	assert(pk_ptr != NULL);
 	assert(pk_len != 0);
 
+	for_each_offload_lib(i, lib) {
+		if (lib->verify_signature == NULL) {
+			continue;
+		}
+		rc = lib->verify_signature(data_ptr, data_len, sig_ptr, sig_len,
+					   sig_alg_ptr, sig_alg_len, pk_ptr,
+					   pk_len);
+		if (rc != CRYPTO_ERR_NOT_SUPPORTED) {
+			return rc;
+		}
+	}
+
 	return crypto_lib_desc.verify_signature(data_ptr, data_len,
 						sig_ptr, sig_len,
 						sig_alg_ptr, sig_alg_len,
@@ -107,11 +177,26 @@ int crypto_mod_verify_signature(void *data_ptr, unsigned int data_len,
 int crypto_mod_verify_hash(void *data_ptr, unsigned int data_len,
 			   void *digest_info_ptr, unsigned int digest_info_len)
 {
+	const crypto_lib_desc_t *lib;
+	unsigned int i;
+	int rc;
+
 	assert(data_ptr != NULL);
 	assert(data_len != 0);
 	assert(digest_info_ptr != NULL);
 	assert(digest_info_len != 0);
 
+	for_each_offload_lib(i, lib) {
+		if (lib->verify_hash == NULL) {
+			continue;
+		}
+		rc = lib->verify_hash(data_ptr, data_len, digest_info_ptr,
+				      digest_info_len);
+		if (rc != CRYPTO_ERR_NOT_SUPPORTED) {
+			return rc;
+		}
+	}
+
 	return crypto_lib_desc.verify_hash(data_ptr, data_len,
 					   digest_info_ptr, digest_info_len);
 }
@@ -133,12 +218,121 @@ int crypto_mod_calc_hash(enum crypto_md_algo alg, void *data_ptr,
 			 unsigned int data_len,
 			 unsigned char output[CRYPTO_MD_MAX_SIZE])
 {
+	const crypto_lib_desc_t *lib;
+	unsigned int i;
+	int rc;
+
 	assert(data_ptr != NULL);
 	assert(data_len != 0);
 	assert(output != NULL);
 
+	for_each_offload_lib(i, lib) {
+		if (lib->calc_hash == NULL) {
+			continue;
+		}
+		rc = lib->calc_hash(alg, data_ptr, data_len, output);
+		if (rc != CRYPTO_ERR_NOT_SUPPORTED) {
+			return rc;
+		}
+	}
+
 	return crypto_lib_desc.calc_hash(alg, data_ptr, data_len, output);
 }
+
+static bool lib_has_hash_steps(const crypto_lib_desc_t *lib)
+{
+	return (lib->calc_hash_init != NULL) &&
+	       (lib->calc_hash_update != NULL) &&
+	       (lib->calc_hash_finish != NULL);
+}
+
+/*
+ * Return true if the crypto library, or one of the libraries operations are
+ * offloaded to, supports hash calculation in several steps, which allows data
+ * to be hashed without being mapped all at once.
+ */
+bool crypto_mod_calc_hash_has_steps(void)
+{
+	const crypto_lib_desc_t *lib;
+	unsigned int i;
+
+	for_each_offload_lib(i, lib) {
+		if (lib_has_hash_steps(lib)) {
+			return true;
+		}
+	}
+
+	return lib_has_hash_steps(&crypto_lib_desc);
+}
+
+/*
+ * Start a hash calculation in several steps. On success,
+ * crypto_mod_calc_hash_finish() must be called to end it. Return
+ * CRYPTO_ERR_NOT_SUPPORTED if none of the libraries supporting several steps
+ * supports the algorithm.
+ *
+ * Parameters:
+ *
+ *   alg: message digest algorithm
+ */
+int crypto_mod_calc_hash_init(enum crypto_md_algo alg)
+{
+	const crypto_lib_desc_t *lib;
+	unsigned int i;
+	int rc;
+
+	assert(crypto_mod_calc_hash_has_steps());
+
+	for_each_offload_lib(i, lib) {
+		if (!lib_has_hash_steps(lib)) {
+			continue;
+		}
+		rc = lib->calc_hash_init(alg);
+		if (rc != CRYPTO_ERR_NOT_SUPPORTED) {
+			hash_lib = lib;
+			return rc;
+		}
+	}
+
+	if (!lib_has_hash_steps(&crypto_lib_desc)) {
+		return CRYPTO_ERR_NOT_SUPPORTED;
+	}
+
+	hash_lib = &crypto_lib_desc;
+
+	return crypto_lib_desc.calc_hash_init(alg);
+}
+
+/*
+ * Hash the next part of the data
+ *
+ * Parameters:
+ *
+ *   data_ptr, len: data to be hashed
+ */
+int crypto_mod_calc_hash_update(const void *data_ptr, size_t len)
+{
+	assert(hash_lib->calc_hash_update != NULL);
+	assert(data_ptr != NULL);
+
+	return hash_lib->calc_hash_update(data_ptr, len);
+}
+
+/*
+ * Output the hash of the data passed since crypto_mod_calc_hash_init() and
+ * end the calculation.
+ *
+ * Parameters:
+ *
+ *   output: resulting hash
+ */
+int crypto_mod_calc_hash_finish(unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	assert(hash_lib->calc_hash_finish != NULL);
+	assert(output != NULL);
+
+	return hash_lib->calc_hash_finish(output);
+}
 #endif /* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
@@ -173,7 +367,10 @@ int crypto_mod_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 			    unsigned int iv_len, const void *tag,
 			    unsigned int tag_len)
 {
-	assert(crypto_lib_desc.auth_decrypt != NULL);
+	const crypto_lib_desc_t *lib;
+	unsigned int i;
+	int rc;
+
 	assert(data_ptr != NULL);
 	assert(len != 0U);
 	assert(key != NULL);
@@ -183,7 +380,129 @@ int crypto_mod_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 	assert(tag != NULL);
 	assert((tag_len != 0U) && (tag_len <= CRYPTO_MAX_TAG_SIZE));
 
+	for_each_offload_lib(i, lib) {
+		if (lib->auth_decrypt == NULL) {
+			continue;
+		}
+		rc = lib->auth_decrypt(dec_algo, data_ptr, len, key, key_len,
+				       key_flags, iv, iv_len, tag, tag_len);
+		if (rc != CRYPTO_ERR_NOT_SUPPORTED) {
+			return rc;
+		}
+	}
+
+	/* The registered library may rely on the offload libraries for it */
+	assert(crypto_lib_desc.auth_decrypt != NULL);
+
 	return crypto_lib_desc.auth_decrypt(dec_algo, data_ptr, len, key,
 					    key_len, key_flags, iv, iv_len, tag,
 					    tag_len);
 }
+
+static bool lib_has_decrypt_steps(const crypto_lib_desc_t *lib)
+{
+	return (lib->auth_decrypt_init != NULL) &&
+	       (lib->auth_decrypt_update != NULL) &&
+	       (lib->auth_decrypt_finish != NULL);
+}
+
+/*
+ * Return true if the crypto library, or one of the libraries operations are
+ * offloaded to, supports authenticated decryption in several steps, which
+ * allows an image to be decrypted while it is read.
+ */
+bool crypto_mod_auth_decrypt_has_steps(void)
+{
+	const crypto_lib_desc_t *lib;
+	unsigned int i;
+
+	for_each_offload_lib(i, lib) {
+		if (lib_has_decrypt_steps(lib)) {
+			return true;
+		}
+	}
+
+	return lib_has_decrypt_steps(&crypto_lib_desc);
+}
+
+/*
+ * Start an authenticated decryption in several steps. On success,
+ * crypto_mod_auth_decrypt_finish() must be called to end it. Return
+ * CRYPTO_ERR_NOT_SUPPORTED if none of the libraries supporting several steps
+ * supports the algorithm.
+ *
+ * Parameters:
+ *
+ *   dec_algo: authenticated decryption algorithm
+ *   key, key_len, key_flags: symmetric decryption key
+ *   iv, iv_len: initialization vector
+ */
+int crypto_mod_auth_decrypt_init(enum crypto_dec_algo dec_algo,
+				 const void *key, unsigned int key_len,
+				 unsigned int key_flags, const void *iv,
+				 unsigned int iv_len)
+{
+	const crypto_lib_desc_t *lib;
+	unsigned int i;
+	int rc;
+
+	assert(crypto_mod_auth_decrypt_has_steps());
+	assert(key != NULL);
+	assert(key_len != 0U);
+	assert(iv != NULL);
+	assert((iv_len != 0U) && (iv_len <= CRYPTO_MAX_IV_SIZE));
+
+	for_each_offload_lib(i, lib) {
+		if (!lib_has_decrypt_steps(lib)) {
+			continue;
+		}
+		rc = lib->auth_decrypt_init(dec_algo, key, key_len, key_flags,
+					    iv, iv_len);
+		if (rc != CRYPTO_ERR_NOT_SUPPORTED) {
+			dec_lib = lib;
+			return rc;
+		}
+	}
+
+	if (!lib_has_decrypt_steps(&crypto_lib_desc)) {
+		return CRYPTO_ERR_NOT_SUPPORTED;
+	}
+
+	dec_lib = &crypto_lib_desc;
+
+	return crypto_lib_desc.auth_decrypt_init(dec_algo, key, key_len,
+						 key_flags, iv, iv_len);
+}
+
+/*
+ * Decrypt the next part of the data in place. All but the last part must be
+ * a multiple of CRYPTO_DEC_BLOCK_SIZE bytes long.
+ *
+ * Parameters:
+ *
+ *   data_ptr, len: data to be decrypted (inout param)
+ */
+int crypto_mod_auth_decrypt_update(void *data_ptr, size_t len)
+{
+	assert(dec_lib->auth_decrypt_update != NULL);
+	assert(data_ptr != NULL);
+
+	return dec_lib->auth_decrypt_update(data_ptr, len);
+}
+
+/*
+ * Check the authentication tag of the data decrypted since
+ * crypto_mod_auth_decrypt_init() and end the decryption.
+ *
+ * Parameters:
+ *
+ *   tag, tag_len: authentication tag
+ */
+int crypto_mod_auth_decrypt_finish(const void *tag, unsigned int tag_len)
+{
+	assert(dec_lib->auth_decrypt_finish != NULL);
+	assert(tag != NULL);
+	assert((tag_len != 0U) && (tag_len <= CRYPTO_MAX_TAG_SIZE));
+
+	return dec_lib->auth_decrypt_finish(tag, tag_len);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2023, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2024, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,7 +8,6 @@
 #include <stddef.h>
 
 /* mbed TLS headers */
-#include <mbedtls/memory_buffer_alloc.h>
 #include <mbedtls/platform.h>
 #include <mbedtls/version.h>
 
@@ -47,7 +46,7 @@ void mbedtls_init(void)
 		assert(heap_size >= TF_MBEDTLS_HEAP_SIZE);
 
 		/* Initialize the mbed TLS heap */
-		mbedtls_memory_buffer_alloc_init(heap_addr, heap_size);
+		mbedtls_heap_init(heap_addr, heap_size);
 
 #ifdef MBEDTLS_PLATFORM_SNPRINTF_ALT
 		mbedtls_platform_set_snprintf(snprintf);
@@ -56,6 +55,21 @@ void mbedtls_init(void)
 	}
 }
 
+/*
+ * Print the highest amount of the mbed TLS heap used so far, if the allocator
+ * records it. Called once the images of a boot stage are authenticated, it
+ * gives the heap size required by the chain of trust of the platform.
+ */
+void mbedtls_heap_print_peak(void)
+{
+	size_t peak;
+
+	if (mbedtls_heap_get_peak(&peak) == 0) {
+		INFO("mbed TLS heap peak usage: %zu of %u bytes\n", peak,
+		     (unsigned int)TF_MBEDTLS_HEAP_SIZE);
+	}
+}
+
 /*
  * The following helper function simply returns the default allocated heap.
  * It can be used by platforms for their plat_get_mbedtls_heap() implementation.
@@ -32,7 +32,8 @@ endif
 
 $(eval $(call add_define,MBEDTLS_CONFIG_FILE))
 
-MBEDTLS_SOURCES	+=		drivers/auth/mbedtls/mbedtls_common.c
+MBEDTLS_SOURCES	+=		drivers/auth/mbedtls/mbedtls_common.c	\
+				drivers/auth/mbedtls/mbedtls_heap.c
 
 LIBMBEDTLS_SRCS		+= $(addprefix ${MBEDTLS_DIR}/library/,		\
 					aes.c 				\
@@ -134,6 +135,40 @@ else
     TF_MBEDTLS_USE_AES_GCM	:=	0
 endif
 
+# Number of parsed public keys kept for the following signature verifications.
+# The cached keys stay on the mbed TLS heap, so the cache is disabled (0) by
+# default. It is only implemented by the legacy mbed TLS crypto interface.
+TF_MBEDTLS_PK_CACHE_SIZE	?=	0
+
+ifneq (${TF_MBEDTLS_PK_CACHE_SIZE},0)
+    ifeq (${PSA_CRYPTO},1)
+        $(error "TF_MBEDTLS_PK_CACHE_SIZE is not supported with PSA_CRYPTO=1")
+    endif
+endif
+
+# Allocator of the mbed TLS heap: 'buffer' (first-fit allocator of mbed TLS),
+# 'arena' (bump allocator reset at the end of each operation) or 'pool'
+# (power-of-two size classes).
+TF_MBEDTLS_HEAP_ALLOC		?=	buffer
+
+ifeq (${TF_MBEDTLS_HEAP_ALLOC},buffer)
+    TF_MBEDTLS_HEAP_ALLOC_ID	:=	TF_MBEDTLS_HEAP_BUFFER
+else ifeq (${TF_MBEDTLS_HEAP_ALLOC},arena)
+    TF_MBEDTLS_HEAP_ALLOC_ID	:=	TF_MBEDTLS_HEAP_ARENA
+    # Cached keys would keep the arena from being reset
+    ifneq (${TF_MBEDTLS_PK_CACHE_SIZE},0)
+        $(error "TF_MBEDTLS_HEAP_ALLOC=arena requires TF_MBEDTLS_PK_CACHE_SIZE=0")
+    endif
+    # So would the key slots that the PSA Crypto core keeps allocated
+    ifeq (${PSA_CRYPTO},1)
+        $(error "TF_MBEDTLS_HEAP_ALLOC=arena is not supported with PSA_CRYPTO=1")
+    endif
+else ifeq (${TF_MBEDTLS_HEAP_ALLOC},pool)
+    TF_MBEDTLS_HEAP_ALLOC_ID	:=	TF_MBEDTLS_HEAP_POOL
+else
+    $(error "TF_MBEDTLS_HEAP_ALLOC=${TF_MBEDTLS_HEAP_ALLOC} not supported")
+endif
+
 # Needs to be set to drive mbed TLS configuration correctly
 $(eval $(call add_defines,\
     $(sort \
@@ -141,6 +176,8 @@ $(eval $(call add_defines,\
         TF_MBEDTLS_KEY_SIZE \
         TF_MBEDTLS_HASH_ALG_ID \
         TF_MBEDTLS_USE_AES_GCM \
+        TF_MBEDTLS_PK_CACHE_SIZE \
+        TF_MBEDTLS_HEAP_ALLOC_ID \
 )))
 
 $(eval $(call MAKE_LIB,mbedtls))
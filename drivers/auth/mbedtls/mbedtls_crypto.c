@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
 
@@ -77,6 +78,131 @@ int mbedtls_x509_get_sig_alg(const mbedtls_x509_buf *sig_oid,
 			     mbedtls_md_type_t *md_alg,
 			     mbedtls_pk_type_t *pk_alg,
 			     void **sig_opts);
+
+#if TF_MBEDTLS_PK_CACHE_SIZE
+/* Size of the hash identifying a public key in the cache */
+#define PK_ID_SIZE		32U
+
+/*
+ * Cache of parsed public keys, identified by the SHA-256 hash of their DER
+ * encoding. The same keys (ROTPK, trusted and non-trusted world keys) verify
+ * several certificates in a boot stage, so they are only parsed the first
+ * time. The least recently used key is evicted when the cache is full.
+ */
+static struct pk_cache_entry {
+	unsigned char id[PK_ID_SIZE];
+	mbedtls_pk_context pk;
+	unsigned int last_use;
+	bool valid;
+} pk_cache[TF_MBEDTLS_PK_CACHE_SIZE];
+
+static unsigned int pk_cache_clock;
+
+/*
+ * Return the parsed public key from the cache. If it is not there yet, parse it
+ * into 'ctx' and move it to the least recently used entry, which is only
+ * evicted once the key has been parsed successfully.
+ */
+static int pk_cache_get(void *pk_ptr, unsigned int pk_len,
+			mbedtls_pk_context *ctx, mbedtls_pk_context **pk)
+{
+	const mbedtls_md_info_t *md_info;
+	struct pk_cache_entry *entry, *victim = &pk_cache[0];
+	unsigned char id[PK_ID_SIZE];
+	unsigned char *p, *end;
+	unsigned int i;
+	int rc;
+
+	md_info = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+	if (md_info == NULL) {
+		return MBEDTLS_ERR_MD_BAD_INPUT_DATA;
+	}
+
+	rc = mbedtls_md(md_info, pk_ptr, pk_len, id);
+	if (rc != 0) {
+		return rc;
+	}
+
+	pk_cache_clock++;
+
+	for (i = 0U; i < TF_MBEDTLS_PK_CACHE_SIZE; i++) {
+		entry = &pk_cache[i];
+		if (entry->valid && (memcmp(entry->id, id, PK_ID_SIZE) == 0)) {
+			entry->last_use = pk_cache_clock;
+			*pk = &entry->pk;
+			return 0;
+		}
+
+		if (!victim->valid) {
+			continue;
+		}
+		if (!entry->valid || (entry->last_use < victim->last_use)) {
+			victim = entry;
+		}
+	}
+
+	mbedtls_pk_init(ctx);
+	p = (unsigned char *)pk_ptr;
+	end = (unsigned char *)(p + pk_len);
+	rc = mbedtls_pk_parse_subpubkey(&p, end, ctx);
+	if (rc != 0) {
+		mbedtls_pk_free(ctx);
+		return rc;
+	}
+
+	if (victim->valid) {
+		mbedtls_pk_free(&victim->pk);
+	}
+
+	/* The entry takes over the key parsed in 'ctx' */
+	victim->pk = *ctx;
+	mbedtls_pk_init(ctx);
+
+	(void)memcpy(victim->id, id, PK_ID_SIZE);
+	victim->last_use = pk_cache_clock;
+	victim->valid = true;
+	*pk = &victim->pk;
+
+	return 0;
+}
+#endif /* TF_MBEDTLS_PK_CACHE_SIZE */
+
+/*
+ * Get the parsed public key, either from the cache or by parsing it into 'ctx',
+ * in which case it is freed by put_pk(). With the cache, 'ctx' only holds the
+ * key until it enters the cache.
+ */
+static int get_pk(void *pk_ptr, unsigned int pk_len, mbedtls_pk_context *ctx,
+		  mbedtls_pk_context **pk)
+{
+#if TF_MBEDTLS_PK_CACHE_SIZE
+	return pk_cache_get(pk_ptr, pk_len, ctx, pk);
+#else
+	unsigned char *p, *end;
+	int rc;
+
+	mbedtls_pk_init(ctx);
+	p = (unsigned char *)pk_ptr;
+	end = (unsigned char *)(p + pk_len);
+	rc = mbedtls_pk_parse_subpubkey(&p, end, ctx);
+	if (rc != 0) {
+		mbedtls_pk_free(ctx);
+		return rc;
+	}
+
+	*pk = ctx;
+
+	return 0;
+#endif /* TF_MBEDTLS_PK_CACHE_SIZE */
+}
+
+static void put_pk(mbedtls_pk_context *ctx, mbedtls_pk_context *pk)
+{
+	if (pk == ctx) {
+		mbedtls_pk_free(ctx);
+	}
+}
+
 /*
  * Verify a signature.
  *
@@ -92,7 +218,8 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	mbedtls_asn1_buf signature;
 	mbedtls_md_type_t md_alg;
 	mbedtls_pk_type_t pk_alg;
-	mbedtls_pk_context pk = {0};
+	mbedtls_pk_context pk_ctx = {0};
+	mbedtls_pk_context *pk = NULL;
 	int rc;
 	void *sig_opts = NULL;
 	const mbedtls_md_info_t *md_info;
@@ -113,11 +240,8 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 		return CRYPTO_ERR_SIGNATURE;
 	}
 
-	/* Parse the public key */
-	mbedtls_pk_init(&pk);
-	p = (unsigned char *)pk_ptr;
-	end = (unsigned char *)(p + pk_len);
-	rc = mbedtls_pk_parse_subpubkey(&p, end, &pk);
+	/* Get the parsed public key */
+	rc = get_pk(pk_ptr, pk_len, &pk_ctx, &pk);
 	if (rc != 0) {
 		rc = CRYPTO_ERR_SIGNATURE;
 		goto end2;
@@ -148,7 +272,7 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	}
 
 	/* Verify the signature */
-	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, &pk, md_alg, hash,
+	rc = mbedtls_pk_verify_ext(pk_alg, sig_opts, pk, md_alg, hash,
 			mbedtls_md_get_size(md_info),
 			signature.p, signature.len);
 	if (rc != 0) {
@@ -160,7 +284,7 @@ static int verify_signature(void *data_ptr, unsigned int data_len,
 	rc = CRYPTO_SUCCESS;
 
 end1:
-	mbedtls_pk_free(&pk);
+	put_pk(&pk_ctx, pk);
 end2:
 	mbedtls_free(sig_opts);
 	return rc;
@@ -288,6 +412,51 @@ static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
 	 */
 	return mbedtls_md(md_info, data_ptr, data_len, output);
 }
+
+/* Context of the hash calculation in progress */
+static mbedtls_md_context_t md_ctx;
+
+/*
+ * Start a hash calculation in several steps
+ */
+static int calc_hash_init(enum crypto_md_algo md_algo)
+{
+	const mbedtls_md_info_t *md_info;
+
+	md_info = mbedtls_md_info_from_type(md_type(md_algo));
+	if (md_info == NULL) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	mbedtls_md_init(&md_ctx);
+
+	if ((mbedtls_md_setup(&md_ctx, md_info, 0) != 0) ||
+	    (mbedtls_md_starts(&md_ctx) != 0)) {
+		mbedtls_md_free(&md_ctx);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int calc_hash_update(const void *data_ptr, size_t len)
+{
+	if (mbedtls_md_update(&md_ctx, data_ptr, len) != 0) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int calc_hash_finish(unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	int rc;
+
+	rc = mbedtls_md_finish(&md_ctx, output);
+	mbedtls_md_free(&md_ctx);
+
+	return (rc != 0) ? CRYPTO_ERR_HASH : CRYPTO_SUCCESS;
+}
 #endif /* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 	  CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
 
@@ -298,50 +467,63 @@ static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
  */
 #define DEC_OP_BUF_SIZE		128
 
-static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
-			   unsigned int key_len, const void *iv,
-			   unsigned int iv_len, const void *tag,
-			   unsigned int tag_len)
+/* Context of the decryption in progress */
+static mbedtls_gcm_context gcm_ctx;
+
+/*
+ * Start the decryption of an image. On success, aes_gcm_decrypt_finish() must
+ * be called to release the context.
+ */
+static int aes_gcm_decrypt_init(const void *key, unsigned int key_len,
+				const void *iv, unsigned int iv_len)
 {
-	mbedtls_gcm_context ctx;
 	mbedtls_cipher_id_t cipher = MBEDTLS_CIPHER_ID_AES;
-	unsigned char buf[DEC_OP_BUF_SIZE];
-	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
-	unsigned char *pt = data_ptr;
-	size_t dec_len;
-	int diff, i, rc;
-	size_t output_length __unused;
+	int rc;
 
-	mbedtls_gcm_init(&ctx);
+	mbedtls_gcm_init(&gcm_ctx);
 
-	rc = mbedtls_gcm_setkey(&ctx, cipher, key, key_len * 8);
+	rc = mbedtls_gcm_setkey(&gcm_ctx, cipher, key, key_len * 8);
 	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+		goto err_gcm;
 	}
 
 #if (MBEDTLS_VERSION_MAJOR < 3)
-	rc = mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len, NULL, 0);
+	rc = mbedtls_gcm_starts(&gcm_ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len,
+				NULL, 0);
 #else
-	rc = mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len);
+	rc = mbedtls_gcm_starts(&gcm_ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len);
 #endif
 	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+		goto err_gcm;
 	}
 
+	return CRYPTO_SUCCESS;
+
+err_gcm:
+	mbedtls_gcm_free(&gcm_ctx);
+	return CRYPTO_ERR_DECRYPTION;
+}
+
+/* Decrypt the next part of the image in place */
+static int aes_gcm_decrypt_update(void *data_ptr, size_t len)
+{
+	unsigned char buf[DEC_OP_BUF_SIZE];
+	unsigned char *pt = data_ptr;
+	size_t dec_len;
+	int rc;
+	size_t output_length __unused;
+
 	while (len > 0) {
 		dec_len = MIN(sizeof(buf), len);
 
 #if (MBEDTLS_VERSION_MAJOR < 3)
-		rc = mbedtls_gcm_update(&ctx, dec_len, pt, buf);
+		rc = mbedtls_gcm_update(&gcm_ctx, dec_len, pt, buf);
 #else
-		rc = mbedtls_gcm_update(&ctx, pt, dec_len, buf, sizeof(buf), &output_length);
+		rc = mbedtls_gcm_update(&gcm_ctx, pt, dec_len, buf, sizeof(buf), &output_length);
 #endif
 
 		if (rc != 0) {
-			rc = CRYPTO_ERR_DECRYPTION;
-			goto exit_gcm;
+			return CRYPTO_ERR_DECRYPTION;
 		}
 
 		memcpy(pt, buf, dec_len);
@@ -349,10 +531,20 @@ static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
 		len -= dec_len;
 	}
 
+	return CRYPTO_SUCCESS;
+}
+
+/* Check the authentication tag and release the context */
+static int aes_gcm_decrypt_finish(const void *tag, unsigned int tag_len)
+{
+	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
+	int diff, i, rc;
+	size_t output_length __unused;
+
 #if (MBEDTLS_VERSION_MAJOR < 3)
-	rc = mbedtls_gcm_finish(&ctx, tag_buf, sizeof(tag_buf));
+	rc = mbedtls_gcm_finish(&gcm_ctx, tag_buf, sizeof(tag_buf));
 #else
-	rc = mbedtls_gcm_finish(&ctx, NULL, 0, &output_length, tag_buf, sizeof(tag_buf));
+	rc = mbedtls_gcm_finish(&gcm_ctx, NULL, 0, &output_length, tag_buf, sizeof(tag_buf));
 #endif
 
 	if (rc != 0) {
@@ -373,10 +565,28 @@ static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
 	rc = CRYPTO_SUCCESS;
 
 exit_gcm:
-	mbedtls_gcm_free(&ctx);
+	mbedtls_gcm_free(&gcm_ctx);
 	return rc;
 }
 
+static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
+			   unsigned int key_len, const void *iv,
+			   unsigned int iv_len, const void *tag,
+			   unsigned int tag_len)
+{
+	int rc, rc_finish;
+
+	rc = aes_gcm_decrypt_init(key, key_len, iv, iv_len);
+	if (rc != 0) {
+		return rc;
+	}
+
+	rc = aes_gcm_decrypt_update(data_ptr, len);
+	rc_finish = aes_gcm_decrypt_finish(tag, tag_len);
+
+	return (rc != 0) ? rc : rc_finish;
+}
+
 /*
  * Authenticated decryption of an image
  */
@@ -403,6 +613,23 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 
 	return CRYPTO_SUCCESS;
 }
+
+/*
+ * Start the authenticated decryption of an image in several steps
+ */
+static int auth_decrypt_init(enum crypto_dec_algo dec_algo, const void *key,
+			     unsigned int key_len, unsigned int key_flags,
+			     const void *iv, unsigned int iv_len)
+{
+	assert((key_flags & ENC_KEY_IS_IDENTIFIER) == 0);
+
+	switch (dec_algo) {
+	case CRYPTO_GCM_DECRYPT:
+		return aes_gcm_decrypt_init(key, key_len, iv, iv_len);
+	default:
+		return CRYPTO_ERR_DECRYPTION;
+	}
+}
 #endif /* TF_MBEDTLS_USE_AES_GCM */
 
 /*
@@ -411,19 +638,25 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 #if TF_MBEDTLS_USE_AES_GCM
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    auth_decrypt, NULL);
+		    calc_hash_init, calc_hash_update, calc_hash_finish,
+		    auth_decrypt, auth_decrypt_init, aes_gcm_decrypt_update,
+		    aes_gcm_decrypt_finish, NULL);
 #else
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    NULL, NULL);
+		    calc_hash_init, calc_hash_update, calc_hash_finish,
+		    NULL, NULL, NULL, NULL, NULL);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY
 #if TF_MBEDTLS_USE_AES_GCM
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    auth_decrypt, NULL);
+		    NULL, NULL, NULL, auth_decrypt, auth_decrypt_init,
+		    aes_gcm_decrypt_update, aes_gcm_decrypt_finish, NULL);
 #else
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    NULL, NULL);
+		    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY
-REGISTER_CRYPTO_LIB(LIB_NAME, init, NULL, NULL, calc_hash, NULL, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init, NULL, NULL, calc_hash, calc_hash_init,
+		    calc_hash_update, calc_hash_finish, NULL, NULL, NULL, NULL,
+		    NULL);
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2015-2023, Arm Limited and Contributors. All rights reserved.
+# Copyright (c) 2015-2024, Arm Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -14,3 +14,8 @@ ifeq (${PSA_CRYPTO},1)
 else
 	MBEDTLS_SOURCES +=	drivers/auth/mbedtls/mbedtls_crypto.c
 endif
+
+ifeq (${ARM_CE_HASH},1)
+	MBEDTLS_SOURCES +=	drivers/auth/arm_ce/arm_ce_crypto.c		\
+				drivers/auth/arm_ce/aarch64/sha256_ce.S
+endif
@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* mbed TLS headers */
+#include <mbedtls/memory_buffer_alloc.h>
+#include <mbedtls/platform.h>
+
+#include <common/debug.h>
+#include <drivers/auth/mbedtls/mbedtls_common.h>
+#include <lib/utils_def.h>
+
+#if TF_MBEDTLS_HEAP_ALLOC_ID == TF_MBEDTLS_HEAP_BUFFER
+
+/*
+ * First-fit allocator of mbed TLS. The peak usage is only recorded by mbed TLS
+ * when it is built with MBEDTLS_MEMORY_DEBUG.
+ */
+void mbedtls_heap_init(void *heap_addr, size_t heap_size)
+{
+	mbedtls_memory_buffer_alloc_init(heap_addr, heap_size);
+}
+
+int mbedtls_heap_get_peak(size_t *peak)
+{
+#ifdef MBEDTLS_MEMORY_DEBUG
+	size_t max_blocks;
+
+	mbedtls_memory_buffer_alloc_max_get(peak, &max_blocks);
+	return 0;
+#else
+	(void)peak;
+	return -1;
+#endif
+}
+
+#else /* TF_MBEDTLS_HEAP_ALLOC_ID != TF_MBEDTLS_HEAP_BUFFER */
+
+/* Alignment of the allocated blocks, which the block headers preserve */
+#define HEAP_ALIGN		U(16)
+
+/* Header preceding each allocated block */
+typedef union {
+	size_t size;		/* Arena: size of the block, header included */
+	unsigned int class;	/* Pool: size class of the block */
+	uint8_t pad[HEAP_ALIGN];
+} heap_hdr_t;
+
+CASSERT(sizeof(heap_hdr_t) == HEAP_ALIGN, assert_mbedtls_heap_hdr_size);
+
+static uintptr_t heap_base;
+static uintptr_t heap_end;
+
+/* Lowest unused address of the heap, and its highest value so far */
+static uintptr_t heap_top;
+static uintptr_t heap_peak;
+
+/*
+ * Carve 'size' bytes from the top of the heap. Blocks are only returned to the
+ * top of the heap by the arena allocator.
+ */
+static heap_hdr_t *heap_carve(size_t size)
+{
+	heap_hdr_t *hdr;
+
+	if (size > (heap_end - heap_top)) {
+		ERROR("mbed TLS heap exhausted (%zu bytes requested, peak %zu)\n",
+		      size, (size_t)(heap_peak - heap_base));
+		return NULL;
+	}
+
+	hdr = (heap_hdr_t *)heap_top;
+	heap_top += size;
+	if (heap_top > heap_peak) {
+		heap_peak = heap_top;
+	}
+
+	return hdr;
+}
+
+/* Size of a block holding 'n' elements of 'size' bytes, header included */
+static size_t heap_block_size(size_t n, size_t size)
+{
+	size_t len;
+
+	if ((n == 0U) || (size == 0U) || (n > (SIZE_MAX / size))) {
+		return 0U;
+	}
+
+	len = n * size;
+	if (len > (SIZE_MAX - (2U * HEAP_ALIGN))) {
+		return 0U;
+	}
+
+	return round_up(len, HEAP_ALIGN) + sizeof(heap_hdr_t);
+}
+
+#if TF_MBEDTLS_HEAP_ALLOC_ID == TF_MBEDTLS_HEAP_ARENA
+
+/*
+ * Arena allocator: blocks are carved from the top of the heap and only freeing
+ * the topmost block gives its memory back. The arena is reset once all the
+ * blocks are freed, which happens at the end of each cryptographic operation,
+ * so the memory never gets fragmented across operations.
+ */
+static unsigned int num_blocks;
+
+static void *heap_calloc(size_t n, size_t size)
+{
+	size_t block_size = heap_block_size(n, size);
+	heap_hdr_t *hdr;
+
+	if (block_size == 0U) {
+		return NULL;
+	}
+
+	hdr = heap_carve(block_size);
+	if (hdr == NULL) {
+		return NULL;
+	}
+
+	hdr->size = block_size;
+	num_blocks++;
+
+	(void)memset(hdr + 1, 0, block_size - sizeof(heap_hdr_t));
+
+	return hdr + 1;
+}
+
+static void heap_free(void *ptr)
+{
+	heap_hdr_t *hdr;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	hdr = (heap_hdr_t *)ptr - 1;
+	assert(num_blocks != 0U);
+	assert(((uintptr_t)hdr >= heap_base) && ((uintptr_t)ptr < heap_top));
+
+	num_blocks--;
+	if (num_blocks == 0U) {
+		heap_top = heap_base;
+	} else if (((uintptr_t)hdr + hdr->size) == heap_top) {
+		heap_top = (uintptr_t)hdr;
+	}
+}
+
+#else /* TF_MBEDTLS_HEAP_ALLOC_ID == TF_MBEDTLS_HEAP_POOL */
+
+/*
+ * Size-class pool allocator: the heap is carved into blocks whose size is a
+ * power of two, and freed blocks are kept on a list per size class to be
+ * reused by the next allocation of the same class.
+ */
+#define POOL_MIN_SHIFT		U(5)
+#define POOL_NUM_CLASSES	U(12)
+
+static void *free_list[POOL_NUM_CLASSES];
+
+static void *heap_calloc(size_t n, size_t size)
+{
+	size_t block_size = heap_block_size(n, size);
+	unsigned int class = 0U;
+	heap_hdr_t *hdr;
+
+	if (block_size == 0U) {
+		return NULL;
+	}
+
+	while ((U(1) << (POOL_MIN_SHIFT + class)) < block_size) {
+		class++;
+		if (class == POOL_NUM_CLASSES) {
+			ERROR("mbed TLS allocation of %zu bytes too large\n",
+			      block_size);
+			return NULL;
+		}
+	}
+
+	if (free_list[class] != NULL) {
+		hdr = free_list[class];
+		free_list[class] = *(void **)(hdr + 1);
+	} else {
+		hdr = heap_carve(U(1) << (POOL_MIN_SHIFT + class));
+		if (hdr == NULL) {
+			return NULL;
+		}
+		hdr->class = class;
+	}
+
+	(void)memset(hdr + 1, 0, block_size - sizeof(heap_hdr_t));
+
+	return hdr + 1;
+}
+
+static void heap_free(void *ptr)
+{
+	heap_hdr_t *hdr;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	hdr = (heap_hdr_t *)ptr - 1;
+	assert(((uintptr_t)hdr >= heap_base) && ((uintptr_t)ptr < heap_top));
+	assert(hdr->class < POOL_NUM_CLASSES);
+
+	*(void **)ptr = free_list[hdr->class];
+	free_list[hdr->class] = hdr;
+}
+
+#endif /* TF_MBEDTLS_HEAP_ALLOC_ID == TF_MBEDTLS_HEAP_ARENA */
+
+void mbedtls_heap_init(void *heap_addr, size_t heap_size)
+{
+	heap_base = round_up((uintptr_t)heap_addr, HEAP_ALIGN);
+	heap_end = round_down((uintptr_t)heap_addr + heap_size, HEAP_ALIGN);
+	assert(heap_end > heap_base);
+
+	heap_top = heap_base;
+	heap_peak = heap_base;
+
+	(void)mbedtls_platform_set_calloc_free(heap_calloc, heap_free);
+}
+
+int mbedtls_heap_get_peak(size_t *peak)
+{
+	*peak = heap_peak - heap_base;
+	return 0;
+}
+
+#endif /* TF_MBEDTLS_HEAP_ALLOC_ID == TF_MBEDTLS_HEAP_BUFFER */
@@ -614,6 +614,52 @@ static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
 
 	return CRYPTO_SUCCESS;
 }
+
+/* Hash calculation in progress */
+static psa_hash_operation_t hash_op;
+
+/*
+ * Start a hash calculation in several steps
+ */
+static int calc_hash_init(enum crypto_md_algo md_algo)
+{
+	psa_algorithm_t psa_md_alg;
+
+	/* convert the md_alg to psa_algo */
+	psa_md_alg = mbedtls_md_psa_alg_from_type(md_type(md_algo));
+
+	hash_op = psa_hash_operation_init();
+	if (psa_hash_setup(&hash_op, psa_md_alg) != PSA_SUCCESS) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int calc_hash_update(const void *data_ptr, size_t len)
+{
+	if (psa_hash_update(&hash_op, data_ptr, len) != PSA_SUCCESS) {
+		(void)psa_hash_abort(&hash_op);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int calc_hash_finish(unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	size_t hash_length;
+	psa_status_t status;
+
+	status = psa_hash_finish(&hash_op, (uint8_t *)output,
+				 CRYPTO_MD_MAX_SIZE, &hash_length);
+	if (status != PSA_SUCCESS) {
+		(void)psa_hash_abort(&hash_op);
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
 #endif /*
 	* CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY || \
 	* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
@@ -626,50 +672,63 @@ static int calc_hash(enum crypto_md_algo md_algo, void *data_ptr,
  */
 #define DEC_OP_BUF_SIZE		128
 
-static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
-			   unsigned int key_len, const void *iv,
-			   unsigned int iv_len, const void *tag,
-			   unsigned int tag_len)
+/* Context of the decryption in progress */
+static mbedtls_gcm_context gcm_ctx;
+
+/*
+ * Start the decryption of an image. On success, aes_gcm_decrypt_finish() must
+ * be called to release the context.
+ */
+static int aes_gcm_decrypt_init(const void *key, unsigned int key_len,
+				const void *iv, unsigned int iv_len)
 {
-	mbedtls_gcm_context ctx;
 	mbedtls_cipher_id_t cipher = MBEDTLS_CIPHER_ID_AES;
-	unsigned char buf[DEC_OP_BUF_SIZE];
-	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
-	unsigned char *pt = data_ptr;
-	size_t dec_len;
-	int diff, i, rc;
-	size_t output_length __unused;
+	int rc;
 
-	mbedtls_gcm_init(&ctx);
+	mbedtls_gcm_init(&gcm_ctx);
 
-	rc = mbedtls_gcm_setkey(&ctx, cipher, key, key_len * 8);
+	rc = mbedtls_gcm_setkey(&gcm_ctx, cipher, key, key_len * 8);
 	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+		goto err_gcm;
 	}
 
 #if (MBEDTLS_VERSION_MAJOR < 3)
-	rc = mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len, NULL, 0);
+	rc = mbedtls_gcm_starts(&gcm_ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len,
+				NULL, 0);
 #else
-	rc = mbedtls_gcm_starts(&ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len);
+	rc = mbedtls_gcm_starts(&gcm_ctx, MBEDTLS_GCM_DECRYPT, iv, iv_len);
 #endif
 	if (rc != 0) {
-		rc = CRYPTO_ERR_DECRYPTION;
-		goto exit_gcm;
+		goto err_gcm;
 	}
 
+	return CRYPTO_SUCCESS;
+
+err_gcm:
+	mbedtls_gcm_free(&gcm_ctx);
+	return CRYPTO_ERR_DECRYPTION;
+}
+
+/* Decrypt the next part of the image in place */
+static int aes_gcm_decrypt_update(void *data_ptr, size_t len)
+{
+	unsigned char buf[DEC_OP_BUF_SIZE];
+	unsigned char *pt = data_ptr;
+	size_t dec_len;
+	int rc;
+	size_t output_length __unused;
+
 	while (len > 0) {
 		dec_len = MIN(sizeof(buf), len);
 
 #if (MBEDTLS_VERSION_MAJOR < 3)
-		rc = mbedtls_gcm_update(&ctx, dec_len, pt, buf);
+		rc = mbedtls_gcm_update(&gcm_ctx, dec_len, pt, buf);
 #else
-		rc = mbedtls_gcm_update(&ctx, pt, dec_len, buf, sizeof(buf), &output_length);
+		rc = mbedtls_gcm_update(&gcm_ctx, pt, dec_len, buf, sizeof(buf), &output_length);
 #endif
 
 		if (rc != 0) {
-			rc = CRYPTO_ERR_DECRYPTION;
-			goto exit_gcm;
+			return CRYPTO_ERR_DECRYPTION;
 		}
 
 		memcpy(pt, buf, dec_len);
@@ -677,10 +736,20 @@ static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
 		len -= dec_len;
 	}
 
+	return CRYPTO_SUCCESS;
+}
+
+/* Check the authentication tag and release the context */
+static int aes_gcm_decrypt_finish(const void *tag, unsigned int tag_len)
+{
+	unsigned char tag_buf[CRYPTO_MAX_TAG_SIZE];
+	int diff, i, rc;
+	size_t output_length __unused;
+
 #if (MBEDTLS_VERSION_MAJOR < 3)
-	rc = mbedtls_gcm_finish(&ctx, tag_buf, sizeof(tag_buf));
+	rc = mbedtls_gcm_finish(&gcm_ctx, tag_buf, sizeof(tag_buf));
 #else
-	rc = mbedtls_gcm_finish(&ctx, NULL, 0, &output_length, tag_buf, sizeof(tag_buf));
+	rc = mbedtls_gcm_finish(&gcm_ctx, NULL, 0, &output_length, tag_buf, sizeof(tag_buf));
 #endif
 
 	if (rc != 0) {
@@ -701,10 +770,28 @@ static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
 	rc = CRYPTO_SUCCESS;
 
 exit_gcm:
-	mbedtls_gcm_free(&ctx);
+	mbedtls_gcm_free(&gcm_ctx);
 	return rc;
 }
 
+static int aes_gcm_decrypt(void *data_ptr, size_t len, const void *key,
+			   unsigned int key_len, const void *iv,
+			   unsigned int iv_len, const void *tag,
+			   unsigned int tag_len)
+{
+	int rc, rc_finish;
+
+	rc = aes_gcm_decrypt_init(key, key_len, iv, iv_len);
+	if (rc != 0) {
+		return rc;
+	}
+
+	rc = aes_gcm_decrypt_update(data_ptr, len);
+	rc_finish = aes_gcm_decrypt_finish(tag, tag_len);
+
+	return (rc != 0) ? rc : rc_finish;
+}
+
 /*
  * Authenticated decryption of an image
  */
@@ -731,6 +818,23 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 
 	return CRYPTO_SUCCESS;
 }
+
+/*
+ * Start the authenticated decryption of an image in several steps
+ */
+static int auth_decrypt_init(enum crypto_dec_algo dec_algo, const void *key,
+			     unsigned int key_len, unsigned int key_flags,
+			     const void *iv, unsigned int iv_len)
+{
+	assert((key_flags & ENC_KEY_IS_IDENTIFIER) == 0);
+
+	switch (dec_algo) {
+	case CRYPTO_GCM_DECRYPT:
+		return aes_gcm_decrypt_init(key, key_len, iv, iv_len);
+	default:
+		return CRYPTO_ERR_DECRYPTION;
+	}
+}
 #endif /* TF_MBEDTLS_USE_AES_GCM */
 
 /*
@@ -739,19 +843,25 @@ static int auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 #if CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC
 #if TF_MBEDTLS_USE_AES_GCM
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    auth_decrypt, NULL);
+		    calc_hash_init, calc_hash_update, calc_hash_finish,
+		    auth_decrypt, auth_decrypt_init, aes_gcm_decrypt_update,
+		    aes_gcm_decrypt_finish, NULL);
 #else
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, calc_hash,
-		    NULL, NULL);
+		    calc_hash_init, calc_hash_update, calc_hash_finish,
+		    NULL, NULL, NULL, NULL, NULL);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_ONLY
 #if TF_MBEDTLS_USE_AES_GCM
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    auth_decrypt, NULL);
+		    NULL, NULL, NULL, auth_decrypt, auth_decrypt_init,
+		    aes_gcm_decrypt_update, aes_gcm_decrypt_finish, NULL);
 #else
 REGISTER_CRYPTO_LIB(LIB_NAME, init, verify_signature, verify_hash, NULL,
-		    NULL, NULL);
+		    NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
 #endif
 #elif CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY
-REGISTER_CRYPTO_LIB(LIB_NAME, init, NULL, NULL, calc_hash, NULL, NULL);
+REGISTER_CRYPTO_LIB(LIB_NAME, init, NULL, NULL, calc_hash, calc_hash_init,
+		    calc_hash_update, calc_hash_finish, NULL, NULL, NULL, NULL,
+		    NULL);
 #endif /* CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC */
@@ -18,6 +18,7 @@
 #include <drivers/io/io_driver.h>
 #include <drivers/io/io_encrypted.h>
 #include <drivers/io/io_storage.h>
+#include <lib/cassert.h>
 #include <lib/utils.h>
 #include <plat/common/platform.h>
 #include <tools_share/firmware_encrypted.h>
@@ -150,6 +151,91 @@ static int enc_file_len(io_entity_t *entity, size_t *length)
 	return result;
 }
 
+/*
+ * Read the payload in chunks of this size and decrypt each chunk right after
+ * it has been read, while it is still in the cache. It must be a multiple of
+ * CRYPTO_DEC_BLOCK_SIZE.
+ */
+#define ENC_READ_CHUNK_SIZE	U(0x4000)
+
+CASSERT((ENC_READ_CHUNK_SIZE % CRYPTO_DEC_BLOCK_SIZE) == 0U,
+	assert_enc_read_chunk_size_multiple_of_dec_block_size);
+
+/* Read the whole payload, then decrypt it */
+static int enc_read_then_decrypt(const struct fw_enc_hdr *header,
+				 const uint8_t *key, size_t key_len,
+				 unsigned int key_flags, uintptr_t buffer,
+				 size_t length, size_t *length_read)
+{
+	int result;
+
+	result = io_read(backend_handle, buffer, length, length_read);
+	if (result != 0) {
+		WARN("Failed to read encrypted payload (%i)\n", result);
+		return -ENOENT;
+	}
+
+	return crypto_mod_auth_decrypt(header->dec_algo, (void *)buffer,
+				       *length_read, key, key_len, key_flags,
+				       header->iv, header->iv_len,
+				       header->tag, header->tag_len);
+}
+
+/* Decrypt the payload chunk by chunk as it is read */
+static int enc_read_and_decrypt(const struct fw_enc_hdr *header,
+				const uint8_t *key, size_t key_len,
+				unsigned int key_flags, uintptr_t buffer,
+				size_t length, size_t *length_read)
+{
+	int result, read_result = 0;
+	size_t chunk_len, bytes_read;
+
+	result = crypto_mod_auth_decrypt_init(header->dec_algo, key, key_len,
+					      key_flags, header->iv,
+					      header->iv_len);
+	if (result != 0) {
+		return result;
+	}
+
+	*length_read = 0U;
+	while (*length_read < length) {
+		chunk_len = MIN(length - *length_read,
+				(size_t)ENC_READ_CHUNK_SIZE);
+
+		read_result = io_read(backend_handle, buffer + *length_read,
+				      chunk_len, &bytes_read);
+		if (read_result != 0) {
+			WARN("Failed to read encrypted payload (%i)\n",
+			     read_result);
+			read_result = -ENOENT;
+			break;
+		}
+
+		if (bytes_read != 0U) {
+			result = crypto_mod_auth_decrypt_update(
+					(void *)(buffer + *length_read),
+					bytes_read);
+			*length_read += bytes_read;
+		}
+
+		/* A short read marks the end of the payload */
+		if ((result != 0) || (bytes_read < chunk_len)) {
+			break;
+		}
+	}
+
+	/* The decryption must be finished even if it has failed */
+	if (result == 0) {
+		result = crypto_mod_auth_decrypt_finish(header->tag,
+							header->tag_len);
+	} else {
+		(void)crypto_mod_auth_decrypt_finish(header->tag,
+						     header->tag_len);
+	}
+
+	return (read_result != 0) ? read_result : result;
+}
+
 static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			 size_t *length_read)
 {
@@ -186,14 +272,6 @@ static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		return -ENOENT;
 	}
 
-	result = io_read(backend_handle, buffer, length, &bytes_read);
-	if (result != 0) {
-		WARN("Failed to read encrypted payload (%i)\n", result);
-		return -ENOENT;
-	}
-
-	*length_read = bytes_read;
-
 	result = plat_get_enc_key_info(fw_enc_status, key, &key_len, &key_flags,
 				       (uint8_t *)&uuid_spec->uuid,
 				       sizeof(uuid_t));
@@ -202,15 +280,23 @@ static int enc_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		return -ENOENT;
 	}
 
-	result = crypto_mod_auth_decrypt(header.dec_algo,
-					 (void *)buffer, *length_read, key,
-					 key_len, key_flags, header.iv,
-					 header.iv_len, header.tag,
-					 header.tag_len);
+	*length_read = 0U;
+	if (crypto_mod_auth_decrypt_has_steps()) {
+		result = enc_read_and_decrypt(&header, key, key_len, key_flags,
+					      buffer, length, length_read);
+	} else {
+		result = enc_read_then_decrypt(&header, key, key_len,
+					       key_flags, buffer, length,
+					       length_read);
+	}
 	memset(key, 0, key_len);
 
 	if (result != 0) {
-		ERROR("File decryption failed (%i)\n", result);
+		/* Do not leave unauthenticated plaintext behind */
+		zeromem((void *)buffer, *length_read);
+		if (result != -ENOENT) {
+			ERROR("File decryption failed (%i)\n", result);
+		}
 		return -ENOENT;
 	}
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -260,6 +260,32 @@ int event_log_measure(uintptr_t data_base, uint32_t data_size,
 				    (void *)data_base, data_size, hash_data);
 }
 
+/*
+ * Measure data in several parts, with the algorithm selected by the Event Log
+ * driver. Once event_log_measure_init() has succeeded, the parts are passed to
+ * event_log_measure_update() and event_log_measure_finish() must be called to
+ * get the measurement. These are only available if the crypto library
+ * supports hash calculation in several steps.
+ */
+int event_log_measure_init(void)
+{
+	if (!crypto_mod_calc_hash_has_steps()) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return crypto_mod_calc_hash_init(CRYPTO_MD_ID);
+}
+
+int event_log_measure_update(uintptr_t data_base, size_t data_size)
+{
+	return crypto_mod_calc_hash_update((const void *)data_base, data_size);
+}
+
+int event_log_measure_finish(unsigned char hash_data[CRYPTO_MD_MAX_SIZE])
+{
+	return crypto_mod_calc_hash_finish(hash_data);
+}
+
 /*
  * Calculate and write hash of image, configuration data, etc.
  * to Event Log.
@@ -13,6 +13,7 @@
 
 #include "base.h"
 #include "clock.h"
+#include "perf.h"
 #include "power_domain.h"
 #include "reset_domain.h"
 #include "sensor.h"
@@ -119,6 +120,13 @@ scmi_msg_handler_t scmi_msg_get_rstd_handler(struct scmi_msg *msg);
  */
 scmi_msg_handler_t scmi_msg_get_pd_handler(struct scmi_msg *msg);
 
+/*
+ * scmi_msg_get_perf_handler - Return a handler for a performance message
+ * @msg - message to process
+ * Return a function handler for the message or NULL
+ */
+scmi_msg_handler_t scmi_msg_get_perf_handler(struct scmi_msg *msg);
+
 /*
  * scmi_msg_get_sensor_handler - Return a handler for a sensor message
  * @msg - message to process
@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: BSD-3-Clause
 /*
- * Copyright (c) 2015-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2024, Arm Limited and Contributors. All rights reserved.
  * Copyright (c) 2019-2020, Linaro Limited
  */
 
@@ -14,6 +14,7 @@
 #pragma weak scmi_msg_get_clock_handler
 #pragma weak scmi_msg_get_rstd_handler
 #pragma weak scmi_msg_get_pd_handler
+#pragma weak scmi_msg_get_perf_handler
 #pragma weak scmi_msg_get_voltage_handler
 #pragma weak scmi_msg_get_sensor_handler
 
@@ -32,6 +33,11 @@ scmi_msg_handler_t scmi_msg_get_pd_handler(struct scmi_msg *msg __unused)
 	return NULL;
 }
 
+scmi_msg_handler_t scmi_msg_get_perf_handler(struct scmi_msg *msg __unused)
+{
+	return NULL;
+}
+
 scmi_msg_handler_t scmi_msg_get_voltage_handler(struct scmi_msg *msg __unused)
 {
 	return NULL;
@@ -81,6 +87,9 @@ void scmi_process_message(struct scmi_msg *msg)
 	case SCMI_PROTOCOL_ID_POWER_DOMAIN:
 		handler = scmi_msg_get_pd_handler(msg);
 		break;
+	case SCMI_PROTOCOL_ID_PERF:
+		handler = scmi_msg_get_perf_handler(msg);
+		break;
 	case SCMI_PROTOCOL_ID_SENSOR:
 		handler = scmi_msg_get_sensor_handler(msg);
 		break;
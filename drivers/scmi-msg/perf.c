@@ -0,0 +1,551 @@
+// SPDX-License-Identifier: BSD-3-Clause
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ */
+#include <cdefs.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <drivers/scmi-msg.h>
+#include <drivers/scmi.h>
+#include <lib/utils_def.h>
+
+#include "common.h"
+
+#pragma weak plat_scmi_perf_count
+#pragma weak plat_scmi_perf_get_name
+#pragma weak plat_scmi_perf_levels_array
+#pragma weak plat_scmi_perf_get_level
+#pragma weak plat_scmi_perf_set_level
+#pragma weak plat_scmi_perf_get_limits
+#pragma weak plat_scmi_perf_set_limits
+#pragma weak plat_scmi_perf_get_fastchannel
+#pragma weak plat_scmi_perf_get_doorbell
+
+static bool message_id_is_supported(unsigned int message_id);
+
+size_t plat_scmi_perf_count(unsigned int agent_id __unused)
+{
+	return 0U;
+}
+
+const char *plat_scmi_perf_get_name(unsigned int agent_id __unused,
+				    unsigned int scmi_id __unused)
+{
+	return NULL;
+}
+
+int32_t plat_scmi_perf_levels_array(unsigned int agent_id __unused,
+				    unsigned int scmi_id __unused,
+				    uint32_t *levels __unused,
+				    size_t *nb_elts __unused,
+				    uint32_t start_idx __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+int32_t plat_scmi_perf_get_level(unsigned int agent_id __unused,
+				 unsigned int scmi_id __unused,
+				 uint32_t *level __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+int32_t plat_scmi_perf_set_level(unsigned int agent_id __unused,
+				 unsigned int scmi_id __unused,
+				 uint32_t level __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+int32_t plat_scmi_perf_get_limits(unsigned int agent_id __unused,
+				  unsigned int scmi_id __unused,
+				  uint32_t *range_max __unused,
+				  uint32_t *range_min __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+int32_t plat_scmi_perf_set_limits(unsigned int agent_id __unused,
+				  unsigned int scmi_id __unused,
+				  uint32_t range_max __unused,
+				  uint32_t range_min __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+uintptr_t plat_scmi_perf_get_fastchannel(unsigned int agent_id __unused,
+					 unsigned int scmi_id __unused,
+					 bool set_not_get __unused)
+{
+	return 0U;
+}
+
+int32_t plat_scmi_perf_get_doorbell(unsigned int agent_id __unused,
+				    unsigned int scmi_id __unused,
+				    uintptr_t *addr __unused,
+				    uint32_t *set_mask __unused,
+				    uint32_t *preserve_mask __unused)
+{
+	return SCMI_NOT_SUPPORTED;
+}
+
+static bool domain_has_fastchannels(unsigned int agent_id,
+				    unsigned int scmi_id)
+{
+	return (plat_scmi_perf_get_fastchannel(agent_id, scmi_id,
+					       true) != 0U) ||
+	       (plat_scmi_perf_get_fastchannel(agent_id, scmi_id,
+					       false) != 0U);
+}
+
+static void report_version(struct scmi_msg *msg)
+{
+	struct scmi_protocol_version_p2a return_values = {
+		.status = SCMI_SUCCESS,
+		.version = SCMI_PROTOCOL_VERSION_PERF,
+	};
+
+	if (msg->in_size != 0) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static void report_attributes(struct scmi_msg *msg)
+{
+	struct scmi_protocol_attributes_p2a_perf return_values = {
+		.status = SCMI_SUCCESS,
+	};
+
+	if (msg->in_size != 0) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	return_values.attributes = plat_scmi_perf_count(msg->agent_id) &
+				   SCMI_PERF_NUM_DOMAINS_MASK;
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static void report_message_attributes(struct scmi_msg *msg)
+{
+	struct scmi_protocol_message_attributes_a2p *in_args = (void *)msg->in;
+	struct scmi_protocol_message_attributes_p2a return_values = {
+		.status = SCMI_SUCCESS,
+		.attributes = 0U,
+	};
+	size_t count = plat_scmi_perf_count(msg->agent_id);
+	bool set_not_get;
+	unsigned int n;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	if (!message_id_is_supported(in_args->message_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	if ((in_args->message_id == SCMI_PERF_LEVEL_SET) ||
+	    (in_args->message_id == SCMI_PERF_LEVEL_GET)) {
+		set_not_get = in_args->message_id == SCMI_PERF_LEVEL_SET;
+
+		for (n = 0U; n < count; n++) {
+			if (plat_scmi_perf_get_fastchannel(msg->agent_id, n,
+							   set_not_get) != 0U) {
+				return_values.attributes =
+					SCMI_PERF_MSG_ATTR_FASTCHANNEL;
+				break;
+			}
+		}
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static void scmi_perf_domain_attributes(struct scmi_msg *msg)
+{
+	const struct scmi_perf_domain_attributes_a2p *in_args = (void *)msg->in;
+	struct scmi_perf_domain_attributes_p2a return_values = {
+		.status = SCMI_SUCCESS,
+		.attributes = SCMI_PERF_DOMAIN_SET_LIMITS |
+			      SCMI_PERF_DOMAIN_SET_LEVEL,
+	};
+	const char *name = NULL;
+	unsigned int domain_id = 0U;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	name = plat_scmi_perf_get_name(msg->agent_id, domain_id);
+	if (name == NULL) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	COPY_NAME_IDENTIFIER(return_values.name, name);
+
+	if (domain_has_fastchannels(msg->agent_id, domain_id)) {
+		return_values.attributes |= SCMI_PERF_DOMAIN_FASTCHANNEL;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+#define LEVELS_ARRAY_SIZE_MAX	(SCMI_PLAYLOAD_MAX - \
+				 sizeof(struct scmi_perf_describe_levels_p2a))
+
+#define LEVEL_DESC_SIZE		sizeof(struct scmi_perf_level)
+
+static void scmi_perf_describe_levels(struct scmi_msg *msg)
+{
+	const struct scmi_perf_describe_levels_a2p *in_args = (void *)msg->in;
+	struct scmi_perf_describe_levels_p2a p2a = {
+		.status = SCMI_SUCCESS,
+	};
+	uint32_t plat_levels[LEVELS_ARRAY_SIZE_MAX / LEVEL_DESC_SIZE];
+	struct scmi_perf_level *out;
+	size_t nb_levels, ret_nb, rem_nb, n;
+	unsigned int domain_id, level_index;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+	level_index = SPECULATION_SAFE_VALUE(in_args->level_index);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	status = plat_scmi_perf_levels_array(msg->agent_id, domain_id, NULL,
+					     &nb_levels, 0U);
+	if (status != SCMI_SUCCESS) {
+		scmi_status_response(msg, status);
+		return;
+	}
+
+	if (level_index > nb_levels) {
+		scmi_status_response(msg, SCMI_OUT_OF_RANGE);
+		return;
+	}
+
+	ret_nb = MIN(nb_levels - level_index, ARRAY_SIZE(plat_levels));
+	rem_nb = nb_levels - level_index - ret_nb;
+
+	status = plat_scmi_perf_levels_array(msg->agent_id, domain_id,
+					     plat_levels, &ret_nb,
+					     level_index);
+	if (status != SCMI_SUCCESS) {
+		scmi_status_response(msg, status);
+		return;
+	}
+
+	out = (struct scmi_perf_level *)(uintptr_t)(msg->out + sizeof(p2a));
+	ASSERT_SYM_PTR_ALIGN(out);
+
+	for (n = 0U; n < ret_nb; n++) {
+		out[n].level = plat_levels[n];
+		out[n].power_cost = 0U;
+		out[n].attributes = 0U;
+	}
+
+	p2a.num_levels = SCMI_PERF_DESCRIBE_LEVELS_NUM_LEVELS(ret_nb, rem_nb);
+
+	memcpy(msg->out, &p2a, sizeof(p2a));
+	msg->out_size_out = sizeof(p2a) + ret_nb * LEVEL_DESC_SIZE;
+}
+
+/* Get the range of the supported levels of a domain */
+static int32_t get_levels_range(unsigned int agent_id, unsigned int domain_id,
+				uint32_t *range_max, uint32_t *range_min)
+{
+	size_t nb_levels;
+	size_t nb = 1U;
+	int32_t status;
+
+	status = plat_scmi_perf_levels_array(agent_id, domain_id, NULL,
+					     &nb_levels, 0U);
+	if ((status != SCMI_SUCCESS) || (nb_levels == 0U)) {
+		return SCMI_GENERIC_ERROR;
+	}
+
+	status = plat_scmi_perf_levels_array(agent_id, domain_id, range_min,
+					     &nb, 0U);
+	if (status != SCMI_SUCCESS) {
+		return status;
+	}
+
+	return plat_scmi_perf_levels_array(agent_id, domain_id, range_max,
+					   &nb, nb_levels - 1U);
+}
+
+static void scmi_perf_limits_set(struct scmi_msg *msg)
+{
+	const struct scmi_perf_limits_set_a2p *in_args = (void *)msg->in;
+	unsigned int domain_id;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	if (in_args->range_min > in_args->range_max) {
+		scmi_status_response(msg, SCMI_INVALID_PARAMETERS);
+		return;
+	}
+
+	status = plat_scmi_perf_set_limits(msg->agent_id, domain_id,
+					   in_args->range_max,
+					   in_args->range_min);
+
+	scmi_status_response(msg, status);
+}
+
+static void scmi_perf_limits_get(struct scmi_msg *msg)
+{
+	const struct scmi_perf_limits_get_a2p *in_args = (void *)msg->in;
+	struct scmi_perf_limits_get_p2a return_values = {
+		.status = SCMI_SUCCESS,
+	};
+	unsigned int domain_id;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	status = plat_scmi_perf_get_limits(msg->agent_id, domain_id,
+					   &return_values.range_max,
+					   &return_values.range_min);
+	if (status == SCMI_NOT_SUPPORTED) {
+		/* Without platform limits, all the levels can be used */
+		status = get_levels_range(msg->agent_id, domain_id,
+					  &return_values.range_max,
+					  &return_values.range_min);
+	}
+
+	if (status != SCMI_SUCCESS) {
+		scmi_status_response(msg, status);
+		return;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static void scmi_perf_level_set(struct scmi_msg *msg)
+{
+	const struct scmi_perf_level_set_a2p *in_args = (void *)msg->in;
+	unsigned int domain_id;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	status = plat_scmi_perf_set_level(msg->agent_id, domain_id,
+					  in_args->level);
+
+	scmi_status_response(msg, status);
+}
+
+static void scmi_perf_level_get(struct scmi_msg *msg)
+{
+	const struct scmi_perf_level_get_a2p *in_args = (void *)msg->in;
+	struct scmi_perf_level_get_p2a return_values = {
+		.status = SCMI_SUCCESS,
+	};
+	unsigned int domain_id;
+	int32_t status;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	status = plat_scmi_perf_get_level(msg->agent_id, domain_id,
+					  &return_values.level);
+	if (status != SCMI_SUCCESS) {
+		scmi_status_response(msg, status);
+		return;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+static void scmi_perf_describe_fastchannel(struct scmi_msg *msg)
+{
+	const struct scmi_perf_describe_fastchannel_a2p *in_args =
+		(void *)msg->in;
+	struct scmi_perf_describe_fastchannel_p2a return_values = {
+		.status = SCMI_SUCCESS,
+	};
+	unsigned int domain_id;
+	uintptr_t chan_addr, db_addr;
+	uint32_t db_set_mask, db_preserve_mask;
+
+	if (msg->in_size != sizeof(*in_args)) {
+		scmi_status_response(msg, SCMI_PROTOCOL_ERROR);
+		return;
+	}
+
+	domain_id = SPECULATION_SAFE_VALUE(in_args->domain_id);
+
+	if (domain_id >= plat_scmi_perf_count(msg->agent_id)) {
+		scmi_status_response(msg, SCMI_NOT_FOUND);
+		return;
+	}
+
+	if ((in_args->message_id != SCMI_PERF_LEVEL_SET) &&
+	    (in_args->message_id != SCMI_PERF_LEVEL_GET)) {
+		scmi_status_response(msg, SCMI_NOT_SUPPORTED);
+		return;
+	}
+
+	chan_addr = plat_scmi_perf_get_fastchannel(msg->agent_id, domain_id,
+			in_args->message_id == SCMI_PERF_LEVEL_SET);
+	if (chan_addr == 0U) {
+		scmi_status_response(msg, SCMI_NOT_SUPPORTED);
+		return;
+	}
+
+	return_values.chan_addr_low = (uint32_t)chan_addr;
+	return_values.chan_addr_high = (uint32_t)((uint64_t)chan_addr >> 32);
+	return_values.chan_size = sizeof(uint32_t);
+
+	/* Only requests from the agent may ring a doorbell */
+	if ((in_args->message_id == SCMI_PERF_LEVEL_SET) &&
+	    (plat_scmi_perf_get_doorbell(msg->agent_id, domain_id, &db_addr,
+					 &db_set_mask,
+					 &db_preserve_mask) == SCMI_SUCCESS)) {
+		return_values.attributes = SCMI_PERF_FASTCHANNEL_DOORBELL |
+					   SCMI_PERF_FASTCHANNEL_DOORBELL_32BIT;
+		return_values.doorbell_addr_low = (uint32_t)db_addr;
+		return_values.doorbell_addr_high =
+			(uint32_t)((uint64_t)db_addr >> 32);
+		return_values.doorbell_set_mask_low = db_set_mask;
+		return_values.doorbell_preserve_mask_low = db_preserve_mask;
+	}
+
+	scmi_write_response(msg, &return_values, sizeof(return_values));
+}
+
+void scmi_perf_process_fastchannels(unsigned int agent_id)
+{
+	size_t count = plat_scmi_perf_count(agent_id);
+	uintptr_t chan_addr;
+	uint32_t requested, level;
+	unsigned int n;
+	int32_t status;
+
+	for (n = 0U; n < count; n++) {
+		status = plat_scmi_perf_get_level(agent_id, n, &level);
+
+		chan_addr = plat_scmi_perf_get_fastchannel(agent_id, n, true);
+		if ((chan_addr != 0U) && (status == SCMI_SUCCESS)) {
+			/* The agent may update the level at any time */
+			requested = __atomic_load_n((uint32_t *)chan_addr,
+						    __ATOMIC_RELAXED);
+			if (requested != level) {
+				status = plat_scmi_perf_set_level(agent_id, n,
+								  requested);
+				if (status == SCMI_SUCCESS) {
+					level = requested;
+				} else {
+					VERBOSE("SCMI perf %u level %u: %d\n",
+						n, requested, status);
+					status = plat_scmi_perf_get_level(
+							agent_id, n, &level);
+				}
+			}
+		}
+
+		chan_addr = plat_scmi_perf_get_fastchannel(agent_id, n, false);
+		if ((chan_addr != 0U) && (status == SCMI_SUCCESS)) {
+			__atomic_store_n((uint32_t *)chan_addr, level,
+					 __ATOMIC_RELAXED);
+		}
+	}
+}
+
+static const scmi_msg_handler_t scmi_perf_handler_table[] = {
+	[SCMI_PROTOCOL_VERSION] = report_version,
+	[SCMI_PROTOCOL_ATTRIBUTES] = report_attributes,
+	[SCMI_PROTOCOL_MESSAGE_ATTRIBUTES] = report_message_attributes,
+	[SCMI_PERF_DOMAIN_ATTRIBUTES] = scmi_perf_domain_attributes,
+	[SCMI_PERF_DESCRIBE_LEVELS] = scmi_perf_describe_levels,
+	[SCMI_PERF_LIMITS_SET] = scmi_perf_limits_set,
+	[SCMI_PERF_LIMITS_GET] = scmi_perf_limits_get,
+	[SCMI_PERF_LEVEL_SET] = scmi_perf_level_set,
+	[SCMI_PERF_LEVEL_GET] = scmi_perf_level_get,
+	[SCMI_PERF_DESCRIBE_FASTCHANNEL] = scmi_perf_describe_fastchannel,
+};
+
+static bool message_id_is_supported(unsigned int message_id)
+{
+	return (message_id < ARRAY_SIZE(scmi_perf_handler_table)) &&
+	       (scmi_perf_handler_table[message_id] != NULL);
+}
+
+scmi_msg_handler_t scmi_msg_get_perf_handler(struct scmi_msg *msg)
+{
+	const size_t array_size = ARRAY_SIZE(scmi_perf_handler_table);
+	unsigned int message_id = SPECULATION_SAFE_VALUE(msg->message_id);
+
+	if (message_id >= array_size) {
+		VERBOSE("Perf handle not found %u", msg->message_id);
+		return NULL;
+	}
+
+	return scmi_perf_handler_table[message_id];
+}
@@ -296,6 +296,10 @@ CREATE_FEATURE_FUNCS(feat_hcx, id_aa64mmfr1_el1, ID_AA64MMFR1_EL1_HCX_SHIFT,
 CREATE_FEATURE_PRESENT(feat_rng_trap, id_aa64pfr1_el1, ID_AA64PFR1_EL1_RNDR_TRAP_SHIFT,
 		      ID_AA64PFR1_EL1_RNDR_TRAP_MASK, RNG_TRAP_IMPLEMENTED)
 
+/* FEAT_SHA256: SHA-256 instructions */
+CREATE_FEATURE_PRESENT(feat_sha256, id_aa64isar0_el1, ID_AA64ISAR0_SHA2_SHIFT,
+		      ID_AA64ISAR0_SHA2_MASK, 1U)
+
 /* Return the RME version, zero if not supported. */
 CREATE_FEATURE_FUNCS(feat_rme, id_aa64pfr0_el1, ID_AA64PFR0_FEAT_RME_SHIFT,
 		    ID_AA64PFR0_FEAT_RME_MASK, 1U, ENABLE_RME)
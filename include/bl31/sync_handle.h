@@ -46,6 +46,9 @@ static inline bool is_sysreg_iss_write(uint64_t esr)
  * GPR plus the direction (MRS/MSR). The lower EL's context can be altered
  * by the function, to inject back the result of the emulation.
  *
+ * With CTX_FPREGS_LAZY, FP/SIMD access traps (EC=0x07) are also routed here,
+ * to save the FP/SIMD state of the previous owner on first use.
+ *
  * Return: indication how to proceed with the trap:
  *   TRAP_RET_UNHANDLED(-1): trap is unhandled, trigger panic
  *   TRAP_RET_REPEAT(0): trap was handled, return to the trapping instruction
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2023, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -47,6 +47,52 @@ int fdtw_for_each_cpu(const void *fdt,
 
 int fdtw_find_or_add_subnode(void *fdt, int parentoffset, const char *name);
 
+/*
+ * Node lookups which use the index of the DTB built by fdtw_index_init() when
+ * there is one, and fall back to libfdt otherwise.
+ */
+#if FDT_INDEX
+/* Arena size needed to index a DTB with up to 'nr_nodes' nodes */
+#define FDTW_INDEX_HDR_SIZE		64U
+#define FDTW_INDEX_ENTRY_SIZE		24U
+#define FDTW_INDEX_SIZE(nr_nodes)	\
+	(FDTW_INDEX_HDR_SIZE + ((nr_nodes) * FDTW_INDEX_ENTRY_SIZE))
+
+int fdtw_index_init(const void *dtb, void *arena, size_t size);
+void fdtw_index_invalidate(const void *dtb);
+int fdtw_parent_offset(const void *dtb, int node);
+int fdtw_path_offset(const void *dtb, const char *path);
+int fdtw_node_offset_by_phandle(const void *dtb, uint32_t phandle);
+int fdtw_node_offset_by_compatible(const void *dtb, int startoffset,
+				   const char *compatible);
+#else
+static inline void fdtw_index_invalidate(const void *dtb)
+{
+}
+
+static inline int fdtw_parent_offset(const void *dtb, int node)
+{
+	return fdt_parent_offset(dtb, node);
+}
+
+static inline int fdtw_path_offset(const void *dtb, const char *path)
+{
+	return fdt_path_offset(dtb, path);
+}
+
+static inline int fdtw_node_offset_by_phandle(const void *dtb, uint32_t phandle)
+{
+	return fdt_node_offset_by_phandle(dtb, phandle);
+}
+
+static inline int fdtw_node_offset_by_compatible(const void *dtb,
+						 int startoffset,
+						 const char *compatible)
+{
+	return fdt_node_offset_by_compatible(dtb, startoffset, compatible);
+}
+#endif /* FDT_INDEX */
+
 static inline uint32_t fdt_blob_size(const void *dtb)
 {
 	const uint32_t *dtb_header = (const uint32_t *)dtb;
@@ -65,8 +111,8 @@ static inline bool fdt_node_is_enabled(const void *fdt, int node)
 }
 
 #define fdt_for_each_compatible_node(dtb, node, compatible_str)       \
-for (node = fdt_node_offset_by_compatible(dtb, -1, compatible_str);   \
+for (node = fdtw_node_offset_by_compatible(dtb, -1, compatible_str);  \
      node >= 0;                                                       \
-     node = fdt_node_offset_by_compatible(dtb, node, compatible_str))
+     node = fdtw_node_offset_by_compatible(dtb, node, compatible_str))
 
 #endif /* FDT_WRAPPERS_H */
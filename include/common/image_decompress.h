@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2024, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -16,9 +16,45 @@ typedef int (decompressor_t)(uintptr_t *in_buf, size_t in_len,
 			     uintptr_t *out_buf, size_t out_len,
 			     uintptr_t work_buf, size_t work_len);
 
+/*
+ * Compressed format recognized by the first 4 bytes of the compressed data,
+ * read as a little-endian word and masked with 'magic_mask'.
+ */
+typedef struct decompressor_format {
+	uint32_t magic;
+	uint32_t magic_mask;
+	decompressor_t *decompressor;
+} decompressor_format_t;
+
+/*
+ * Streaming decompressors pull the compressed input in chunks through a read
+ * callback, which returns 0 on success and sets 'len_read' to 0 at the end of
+ * the input. They report in 'work_used' how much of the workspace they used.
+ */
+typedef int (decompressor_read_t)(void *ctx, uintptr_t buf, size_t len,
+				  size_t *len_read);
+
+typedef int (stream_decompressor_t)(decompressor_read_t *read, void *ctx,
+				    uintptr_t in_buf, size_t in_len,
+				    uintptr_t *out_buf, size_t out_len,
+				    uintptr_t work_buf, size_t work_len,
+				    size_t *work_used);
+
 void image_decompress_init(uintptr_t buf_base, uint32_t buf_size,
 			   decompressor_t *decompressor);
+void image_decompress_init_formats(uintptr_t buf_base, uint32_t buf_size,
+				   const decompressor_format_t *formats,
+				   unsigned int num_formats);
 void image_decompress_prepare(struct image_info *info);
 int image_decompress(struct image_info *info);
 
+#if !TRUSTED_BOARD_BOOT
+/* Streamed images are never held in memory, so they can't be authenticated */
+void image_decompress_stream_init(uintptr_t buf_base, uint32_t buf_size,
+				  uint32_t chunk_size,
+				  stream_decompressor_t *decompressor);
+int image_decompress_stream(unsigned int image_id, struct image_info *info);
+#endif
+size_t image_decompress_high_water(void);
+
 #endif /* IMAGE_DECOMPRESS_H */
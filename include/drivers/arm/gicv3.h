@@ -445,6 +445,16 @@ static inline void gicv3_end_of_interrupt(unsigned int id)
 #define GICR_NUM_REGS(reg_name)	\
 	DIV_ROUND_UP_2EVAL(TOTAL_PRIVATE_INTR_NUM, (1 << reg_name##_SHIFT))
 
+/*
+ * Number of 32-INTID banks covering the shared and private interrupt ranges,
+ * and the number of 32-bit words needed to hold one bit per shared bank.
+ */
+#define GIC_BANK_SHIFT		5
+#define GICD_NUM_BANKS		\
+	DIV_ROUND_UP_2EVAL(TOTAL_SHARED_INTR_NUM, (1 << GIC_BANK_SHIFT))
+#define GICD_NUM_BANK_WORDS	\
+	DIV_ROUND_UP_2EVAL(GICD_NUM_BANKS, 32)
+
 /* Interrupt ID mask for HPPIR, AHPPIR, IAR and AIAR CPU Interface registers */
 #define INT_ID_MASK	U(0xffffff)
 
@@ -499,6 +509,37 @@ typedef struct gicv3_driver_data {
 	mpidr_hash_fn mpidr_to_core_pos;
 } gicv3_driver_data_t;
 
+#if GICV3_SPARSE_SAVE_RESTORE
+/*
+ * Bitmaps of the 32-INTID banks for which at least one saved register differs
+ * from its reset value, one bitmap per register type. They are populated by the
+ * save functions and allow the restore functions to skip banks which are still
+ * in their reset state.
+ */
+typedef struct gicv3_redist_banks {
+	uint32_t igroupr;
+	uint32_t isenabler;
+	uint32_t ispendr;
+	uint32_t isactiver;
+	uint32_t ipriorityr;
+	uint32_t icfgr;
+	uint32_t igrpmodr;
+	uint32_t nsacr;
+} gicv3_redist_banks_t;
+
+typedef struct gicv3_dist_banks {
+	uint32_t igroupr[GICD_NUM_BANK_WORDS];
+	uint32_t isenabler[GICD_NUM_BANK_WORDS];
+	uint32_t ispendr[GICD_NUM_BANK_WORDS];
+	uint32_t isactiver[GICD_NUM_BANK_WORDS];
+	uint32_t ipriorityr[GICD_NUM_BANK_WORDS];
+	uint32_t icfgr[GICD_NUM_BANK_WORDS];
+	uint32_t igrpmodr[GICD_NUM_BANK_WORDS];
+	uint32_t nsacr[GICD_NUM_BANK_WORDS];
+	uint32_t irouter[GICD_NUM_BANK_WORDS];
+} gicv3_dist_banks_t;
+#endif /* GICV3_SPARSE_SAVE_RESTORE */
+
 typedef struct gicv3_redist_ctx {
 	/* 64 bits registers */
 	uint64_t gicr_propbaser;
@@ -514,6 +555,10 @@ typedef struct gicv3_redist_ctx {
 	uint32_t gicr_icfgr[GICR_NUM_REGS(ICFGR)];
 	uint32_t gicr_igrpmodr[GICR_NUM_REGS(IGRPMODR)];
 	uint32_t gicr_nsacr;
+
+#if GICV3_SPARSE_SAVE_RESTORE
+	gicv3_redist_banks_t gicr_banks;
+#endif
 } gicv3_redist_ctx_t;
 
 typedef struct gicv3_dist_ctx {
@@ -530,6 +575,10 @@ typedef struct gicv3_dist_ctx {
 	uint32_t gicd_icfgr[GICD_NUM_REGS(ICFGR)];
 	uint32_t gicd_igrpmodr[GICD_NUM_REGS(IGRPMODR)];
 	uint32_t gicd_nsacr[GICD_NUM_REGS(NSACR)];
+
+#if GICV3_SPARSE_SAVE_RESTORE
+	gicv3_dist_banks_t gicd_banks;
+#endif
 } gicv3_dist_ctx_t;
 
 typedef struct gicv3_its_ctx {
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ARM_CE_CRYPTO_H
+#define ARM_CE_CRYPTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <drivers/auth/crypto_mod.h>
+
+/*
+ * Crypto library calculating SHA-256 hashes with the Cryptographic Extension
+ * instructions, to which the crypto module offloads hash calculations.
+ */
+extern const crypto_lib_desc_t arm_ce_crypto_lib_desc;
+
+void sha256_ce_blocks(uint32_t state[8], const uint8_t *data,
+		      size_t num_blocks);
+
+#endif /* ARM_CE_CRYPTO_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2023, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2024, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,10 @@
 #ifndef CRYPTO_MOD_H
 #define CRYPTO_MOD_H
 
+#include <stdbool.h>
+
+#include <lib/utils_def.h>
+
 #define	CRYPTO_AUTH_VERIFY_ONLY			1
 #define	CRYPTO_HASH_CALC_ONLY			2
 #define	CRYPTO_AUTH_VERIFY_AND_HASH_CALC	3
@@ -18,11 +22,13 @@ enum crypto_ret_value {
 	CRYPTO_ERR_HASH,
 	CRYPTO_ERR_SIGNATURE,
 	CRYPTO_ERR_DECRYPTION,
-	CRYPTO_ERR_UNKNOWN
+	CRYPTO_ERR_UNKNOWN,
+	CRYPTO_ERR_NOT_SUPPORTED
 };
 
 #define CRYPTO_MAX_IV_SIZE		16U
 #define CRYPTO_MAX_TAG_SIZE		16U
+#define CRYPTO_DEC_BLOCK_SIZE		16U
 
 /* Decryption algorithm */
 enum crypto_dec_algo {
@@ -66,6 +72,16 @@ typedef struct crypto_lib_desc_s {
 			 unsigned int data_len,
 			 unsigned char output[CRYPTO_MD_MAX_SIZE]);
 
+	/*
+	 * Calculate a hash in several steps (optional). The data is passed to
+	 * 'calc_hash_update' in as many parts as needed, and
+	 * 'calc_hash_finish' must be called once 'calc_hash_init' has
+	 * succeeded. Return one of the 'enum crypto_ret_value' options.
+	 */
+	int (*calc_hash_init)(enum crypto_md_algo md_alg);
+	int (*calc_hash_update)(const void *data_ptr, size_t len);
+	int (*calc_hash_finish)(unsigned char output[CRYPTO_MD_MAX_SIZE]);
+
 	/* Convert Public key (optional) */
 	int (*convert_pk)(void *full_pk_ptr, unsigned int full_pk_len,
 			  void **hashed_pk_ptr, unsigned int *hashed_pk_len);
@@ -79,6 +95,21 @@ typedef struct crypto_lib_desc_s {
 			    unsigned int key_flags, const void *iv,
 			    unsigned int iv_len, const void *tag,
 			    unsigned int tag_len);
+
+	/*
+	 * Authenticated decryption in several steps (optional). The data is
+	 * decrypted in place as it is passed to 'auth_decrypt_update', and the
+	 * tag is checked by 'auth_decrypt_finish', which must be called once
+	 * 'auth_decrypt_init' has succeeded. All but the last update must be
+	 * a multiple of CRYPTO_DEC_BLOCK_SIZE bytes long. Return one of the
+	 * 'enum crypto_ret_value' options.
+	 */
+	int (*auth_decrypt_init)(enum crypto_dec_algo dec_algo,
+				 const void *key, unsigned int key_len,
+				 unsigned int key_flags, const void *iv,
+				 unsigned int iv_len);
+	int (*auth_decrypt_update)(void *data_ptr, size_t len);
+	int (*auth_decrypt_finish)(const void *tag, unsigned int tag_len);
 } crypto_lib_desc_t;
 
 /* Public functions */
@@ -106,12 +137,23 @@ int crypto_mod_auth_decrypt(enum crypto_dec_algo dec_algo, void *data_ptr,
 			    unsigned int key_flags, const void *iv,
 			    unsigned int iv_len, const void *tag,
 			    unsigned int tag_len);
+bool crypto_mod_auth_decrypt_has_steps(void);
+int crypto_mod_auth_decrypt_init(enum crypto_dec_algo dec_algo,
+				 const void *key, unsigned int key_len,
+				 unsigned int key_flags, const void *iv,
+				 unsigned int iv_len);
+int crypto_mod_auth_decrypt_update(void *data_ptr, size_t len);
+int crypto_mod_auth_decrypt_finish(const void *tag, unsigned int tag_len);
 
 #if (CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY) || \
     (CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC)
 int crypto_mod_calc_hash(enum crypto_md_algo alg, void *data_ptr,
 			 unsigned int data_len,
 			 unsigned char output[CRYPTO_MD_MAX_SIZE]);
+bool crypto_mod_calc_hash_has_steps(void);
+int crypto_mod_calc_hash_init(enum crypto_md_algo alg);
+int crypto_mod_calc_hash_update(const void *data_ptr, size_t len);
+int crypto_mod_calc_hash_finish(unsigned char output[CRYPTO_MD_MAX_SIZE]);
 #endif /* (CRYPTO_SUPPORT == CRYPTO_HASH_CALC_ONLY) || \
 	  (CRYPTO_SUPPORT == CRYPTO_AUTH_VERIFY_AND_HASH_CALC) */
 
@@ -120,17 +162,51 @@ int crypto_mod_convert_pk(void *full_pk_ptr, unsigned int full_pk_len,
 
 /* Macro to register a cryptographic library */
 #define REGISTER_CRYPTO_LIB(_name, _init, _verify_signature, _verify_hash, \
-			    _calc_hash, _auth_decrypt, _convert_pk) \
+			    _calc_hash, _calc_hash_init, _calc_hash_update, \
+			    _calc_hash_finish, _auth_decrypt, \
+			    _auth_decrypt_init, _auth_decrypt_update, \
+			    _auth_decrypt_finish, _convert_pk) \
 	const crypto_lib_desc_t crypto_lib_desc = { \
 		.name = _name, \
 		.init = _init, \
 		.verify_signature = _verify_signature, \
 		.verify_hash = _verify_hash, \
 		.calc_hash = _calc_hash, \
+		.calc_hash_init = _calc_hash_init, \
+		.calc_hash_update = _calc_hash_update, \
+		.calc_hash_finish = _calc_hash_finish, \
 		.auth_decrypt = _auth_decrypt, \
+		.auth_decrypt_init = _auth_decrypt_init, \
+		.auth_decrypt_update = _auth_decrypt_update, \
+		.auth_decrypt_finish = _auth_decrypt_finish, \
 		.convert_pk = _convert_pk \
 	}
 
+/*
+ * Libraries to which the crypto module offloads operations, typically drivers
+ * of hardware crypto engines, in decreasing order of priority. An offload
+ * library only provides the operations it accelerates, and returns
+ * CRYPTO_ERR_NOT_SUPPORTED for the algorithms or parameters it does not
+ * handle. Such operations fall back to the next library, and eventually to
+ * the library registered with REGISTER_CRYPTO_LIB().
+ */
+typedef struct crypto_offload_libs_s {
+	const crypto_lib_desc_t *const *libs;
+	unsigned int num_libs;
+} crypto_offload_libs_t;
+
+/*
+ * Macro to register the array of pointers to the descriptors of the libraries
+ * operations are offloaded to. It must be used in the same file as the array
+ * is defined.
+ */
+#define REGISTER_CRYPTO_OFFLOAD_LIBS(_libs) \
+	const crypto_offload_libs_t crypto_offload_libs = { \
+		.libs = (_libs), \
+		.num_libs = ARRAY_SIZE(_libs), \
+	}
+
 extern const crypto_lib_desc_t crypto_lib_desc;
+extern const crypto_offload_libs_t crypto_offload_libs;
 
 #endif /* CRYPTO_MOD_H */
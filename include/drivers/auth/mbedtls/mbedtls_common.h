@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2024, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,21 @@
 #ifndef MBEDTLS_COMMON_H
 #define MBEDTLS_COMMON_H
 
+#include <stddef.h>
+
+/* Allocators selected with TF_MBEDTLS_HEAP_ALLOC_ID */
+#define TF_MBEDTLS_HEAP_BUFFER		1
+#define TF_MBEDTLS_HEAP_ARENA		2
+#define TF_MBEDTLS_HEAP_POOL		3
+
 void mbedtls_init(void);
 
+/*
+ * Set up the allocator of the mbed TLS heap, and return the highest amount of
+ * heap used so far. The latter fails if the allocator does not record it.
+ */
+void mbedtls_heap_init(void *heap_addr, size_t heap_size);
+int mbedtls_heap_get_peak(size_t *peak);
+void mbedtls_heap_print_peak(void);
+
 #endif /* MBEDTLS_COMMON_H */
@@ -72,6 +72,9 @@ void event_log_write_header(void);
 void dump_event_log(uint8_t *log_addr, size_t log_size);
 int event_log_measure(uintptr_t data_base, uint32_t data_size,
 		      unsigned char hash_data[CRYPTO_MD_MAX_SIZE]);
+int event_log_measure_init(void);
+int event_log_measure_update(uintptr_t data_base, size_t data_size);
+int event_log_measure_finish(unsigned char hash_data[CRYPTO_MD_MAX_SIZE]);
 void event_log_record(const uint8_t *hash, uint32_t event_type,
 		      const event_log_metadata_t *metadata_ptr);
 int event_log_measure_and_record(uintptr_t data_base, uint32_t data_size,
@@ -1,6 +1,6 @@
 /* SPDX-License-Identifier: BSD-3-Clause */
 /*
- * Copyright (c) 2015-2019, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2024, Arm Limited and Contributors. All rights reserved.
  * Copyright (c) 2019, Linaro Limited
  */
 
@@ -58,6 +58,16 @@ void scmi_smt_fastcall_smc_entry(unsigned int agent_id);
  */
 void scmi_smt_interrupt_entry(unsigned int agent_id);
 
+/*
+ * Apply the performance levels an agent has written in its PERFORMANCE_LEVEL_SET
+ * fastchannels and report the current levels in its PERFORMANCE_LEVEL_GET
+ * fastchannels. Called by platform from the fastchannel doorbell interrupt
+ * handler, or at any point where the performance levels can safely be changed.
+ *
+ * @agent_id: SCMI agent ID the fastchannels belong to
+ */
+void scmi_perf_process_fastchannels(unsigned int agent_id);
+
 /* Platform callback functions */
 
 /*
@@ -206,4 +216,108 @@ int32_t plat_scmi_rstd_autonomous(unsigned int agent_id, unsigned int scmi_id,
 int32_t plat_scmi_rstd_set_state(unsigned int agent_id, unsigned int scmi_id,
 				 bool assert_not_deassert);
 
+/* Handlers for SCMI Performance protocol services */
+
+/*
+ * Return number of performance domains for the agent
+ * @agent_id: SCMI agent ID
+ * Return number of performance domains
+ */
+size_t plat_scmi_perf_count(unsigned int agent_id);
+
+/*
+ * Get performance domain string ID (aka name)
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * Return pointer to name or NULL
+ */
+const char *plat_scmi_perf_get_name(unsigned int agent_id,
+				    unsigned int scmi_id);
+
+/*
+ * Get the performance levels of a domain as an array sorted in increasing
+ * order.
+ *
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * @levels: If NULL, function returns the number of levels in @nb_elts,
+ *          else output levels array
+ * @nb_elts: Array size of @levels
+ * @start_idx: Start index of levels array
+ * Return an SCMI compliant error code
+ */
+int32_t plat_scmi_perf_levels_array(unsigned int agent_id, unsigned int scmi_id,
+				    uint32_t *levels, size_t *nb_elts,
+				    uint32_t start_idx);
+
+/*
+ * Get the current performance level of a domain
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * @level: Output performance level
+ * Return an SCMI compliant error code
+ */
+int32_t plat_scmi_perf_get_level(unsigned int agent_id, unsigned int scmi_id,
+				 uint32_t *level);
+
+/*
+ * Set the performance level of a domain
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * @level: Target performance level
+ * Return an SCMI compliant error code
+ */
+int32_t plat_scmi_perf_set_level(unsigned int agent_id, unsigned int scmi_id,
+				 uint32_t level);
+
+/*
+ * Get the performance limits of a domain. All the levels of the domain are
+ * reported if not supported.
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * @range_max: Output maximum performance level
+ * @range_min: Output minimum performance level
+ * Return an SCMI compliant error code
+ */
+int32_t plat_scmi_perf_get_limits(unsigned int agent_id, unsigned int scmi_id,
+				  uint32_t *range_max, uint32_t *range_min);
+
+/*
+ * Set the performance limits of a domain
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * @range_max: Maximum performance level
+ * @range_min: Minimum performance level
+ * Return an SCMI compliant error code
+ */
+int32_t plat_scmi_perf_set_limits(unsigned int agent_id, unsigned int scmi_id,
+				  uint32_t range_max, uint32_t range_min);
+
+/*
+ * Get the fastchannel of a performance domain, a 32-bit performance level in
+ * memory shared with the agent.
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * @set_not_get: PERFORMANCE_LEVEL_SET fastchannel if true, written by the
+ *               agent, PERFORMANCE_LEVEL_GET fastchannel otherwise
+ * Return the address of the fastchannel, or 0 if there is none
+ */
+uintptr_t plat_scmi_perf_get_fastchannel(unsigned int agent_id,
+					 unsigned int scmi_id,
+					 bool set_not_get);
+
+/*
+ * Get the 32-bit doorbell register the agent writes after updating the
+ * PERFORMANCE_LEVEL_SET fastchannel of a performance domain
+ * @agent_id: SCMI agent ID
+ * @scmi_id: SCMI performance domain ID
+ * @addr: Output address of the doorbell register
+ * @set_mask: Output bits to set to ring the doorbell
+ * @preserve_mask: Output bits to preserve when ringing the doorbell
+ * Return SCMI_SUCCESS, or SCMI_NOT_SUPPORTED if there is no doorbell
+ */
+int32_t plat_scmi_perf_get_doorbell(unsigned int agent_id, unsigned int scmi_id,
+				    uintptr_t *addr, uint32_t *set_mask,
+				    uint32_t *preserve_mask);
+
 #endif /* SCMI_MSG_H */
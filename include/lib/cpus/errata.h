@@ -22,8 +22,23 @@
 #define ERRATUM_ID		ERRATUM_CHECK_FUNC + ERRATUM_CHECK_FUNC_SIZE
 #define ERRATUM_CVE		ERRATUM_ID + ERRATUM_ID_SIZE
 #define ERRATUM_CHOSEN		ERRATUM_CVE + ERRATUM_CVE_SIZE
+#if defined(IMAGE_BL31) && ERRATA_PLAN
+#define ERRATUM_APPLY_FUNC_SIZE	CPU_WORD_SIZE
+#else
+#define ERRATUM_APPLY_FUNC_SIZE	0
+#endif
+
 #define ERRATUM_MITIGATED	ERRATUM_CHOSEN + ERRATUM_CHOSEN_SIZE
-#define ERRATUM_ENTRY_SIZE	ERRATUM_MITIGATED + ERRATUM_MITIGATED_SIZE
+#define ERRATUM_APPLY_FUNC	ERRATUM_MITIGATED + ERRATUM_MITIGATED_SIZE
+#define ERRATUM_ENTRY_SIZE	ERRATUM_APPLY_FUNC + ERRATUM_APPLY_FUNC_SIZE
+
+/*
+ * Errata plan recorded in the per-CPU data. Bit n is set when the reset
+ * workaround of the n-th entry of the errata list applies to the CPU. The plan
+ * is only used once the valid bit is set.
+ */
+#define ERRATA_PLAN_VALID_SHIFT	63
+#define ERRATA_PLAN_MAX		ERRATA_PLAN_VALID_SHIFT
 
 #ifndef __ASSEMBLER__
 #include <lib/cassert.h>
@@ -45,10 +60,22 @@ struct erratum_entry {
 	uint8_t chosen;
 	/* TODO(errata ABI): placeholder for the mitigated field */
 	uint8_t _mitigated;
+#if defined(IMAGE_BL31) && ERRATA_PLAN
+	/* Workaround without the revision check, or NULL */
+	uintptr_t (*apply_func)(uint64_t cpu_rev);
+#endif
 } __packed;
 
 CASSERT(sizeof(struct erratum_entry) == ERRATUM_ENTRY_SIZE,
 	assert_erratum_entry_asm_c_different_sizes);
+
+#if defined(IMAGE_BL31) && ERRATA_PLAN
+#define ERRATA_PLAN_VALID	(ULL(1) << ERRATA_PLAN_VALID_SHIFT)
+
+void errata_plan_init(void);
+uint64_t errata_plan_check(struct erratum_entry *entry, long rev_var);
+#endif
+
 #else
 
 /*
@@ -75,11 +75,30 @@
  #define CTX_SAVED_ESR_EL3	U(0x48)
  #define CTX_SAVED_SPSR_EL3	U(0x50)
  #define CTX_SAVED_GPREG_LR	U(0x58)
+#if CTX_FPREGS_LAZY
+ #define CTX_FPREGS_LAZY_STATE	U(0x60)
+ #define CTX_EL3STATE_END	U(0x70) /* Align to the next 16 byte boundary */
+#else
  #define CTX_EL3STATE_END	U(0x60) /* Align to the next 16 byte boundary */
+#endif /* CTX_FPREGS_LAZY */
 #else
+#if CTX_FPREGS_LAZY
+ #define CTX_FPREGS_LAZY_STATE	U(0x48)
+#endif /* CTX_FPREGS_LAZY */
  #define CTX_EL3STATE_END	U(0x50) /* Align to the next 16 byte boundary */
 #endif /* FFH_SUPPORT */
 
+/*
+ * Flags held in CTX_FPREGS_LAZY_STATE when the FP registers are switched
+ * lazily:
+ * TRAP  : CPTR_EL3.TFP is set on exit to this context so that its first use
+ *         of the FP/SIMD registers traps to EL3.
+ * DIRTY : this context has used the FP/SIMD registers since the lazy switch
+ *         began, so the state of the previous owner has been saved.
+ */
+#define FPREGS_LAZY_TRAP	U(0x1)
+#define FPREGS_LAZY_DIRTY	U(0x2)
+
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the
  * 'el1_sys_regs' structure at their correct offsets. Note that some of the
@@ -9,6 +9,7 @@
 
 #include <assert.h>
 #include <context.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include <arch.h>
@@ -44,6 +45,12 @@ void cm_init_context_by_index(unsigned int cpu_idx,
 void cm_manage_extensions_el3(void);
 void manage_extensions_nonsecure_per_world(void);
 void cm_el3_arch_init_per_world(per_world_context_t *per_world_ctx);
+
+#if CTX_FPREGS_LAZY
+void cm_fpregs_lazy_enter(cpu_context_t *owner, cpu_context_t *ctx);
+bool cm_fpregs_lazy_exit(cpu_context_t *ctx);
+int cm_handle_fpregs_trap(cpu_context_t *ctx);
+#endif
 #endif
 
 #if CTX_INCLUDE_EL2_REGS
@@ -29,13 +29,24 @@
 #define CPU_DATA_CPU_OPS_PTR		0x10
 #endif /* ENABLE_RME */
 
+#if ERRATA_PLAN
+/* Offsets of errata_plan and errata_plan_list, size 8 bytes each */
+#define CPU_DATA_ERRATA_PLAN		(0x8 + CPU_DATA_CPU_OPS_PTR)
+#define CPU_DATA_ERRATA_PLAN_LIST	(0x8 + CPU_DATA_ERRATA_PLAN)
+#define CPU_DATA_ERRATA_PLAN_SIZE	0x10
+#else
+#define CPU_DATA_ERRATA_PLAN_SIZE	0x0
+#endif /* ERRATA_PLAN */
+
 #if ENABLE_PAUTH
 /* 8-bytes aligned offset of apiakey[2], size 16 bytes */
 #define	CPU_DATA_APIAKEY_OFFSET		(0x8 + PSCI_CPU_DATA_SIZE_ALIGNED \
+					     + CPU_DATA_ERRATA_PLAN_SIZE \
 					     + CPU_DATA_CPU_OPS_PTR)
 #define CPU_DATA_CRASH_BUF_OFFSET	(0x10 + CPU_DATA_APIAKEY_OFFSET)
 #else /* ENABLE_PAUTH */
 #define CPU_DATA_CRASH_BUF_OFFSET	(0x8 + PSCI_CPU_DATA_SIZE_ALIGNED \
+					     + CPU_DATA_ERRATA_PLAN_SIZE \
 					     + CPU_DATA_CPU_OPS_PTR)
 #endif /* ENABLE_PAUTH */
 
@@ -108,6 +119,7 @@ typedef enum context_pas {
 /*******************************************************************************
  * Cache of frequently used per-cpu data:
  *   Pointers to non-secure, realm, and secure security state contexts
+ *   Errata plan of the cpu, when ERRATA_PLAN is enabled
  *   Address of the crash stack
  * It is aligned to the cache line boundary to allow efficient concurrent
  * manipulation of these pointers on different cpus
@@ -121,6 +133,10 @@ typedef struct cpu_data {
 	void *cpu_context[CPU_DATA_CONTEXT_NUM];
 #endif /* __aarch64__ */
 	uintptr_t cpu_ops_ptr;
+#if ERRATA_PLAN
+	uint64_t errata_plan;
+	uintptr_t errata_plan_list;
+#endif
 	struct psci_cpu_data psci_svc_cpu_data;
 #if ENABLE_PAUTH
 	uint64_t apiakey[2];
@@ -166,6 +182,16 @@ CASSERT(CPU_DATA_CPU_OPS_PTR == __builtin_offsetof
 		(cpu_data_t, cpu_ops_ptr),
 		assert_cpu_data_cpu_ops_ptr_offset_mismatch);
 
+#if ERRATA_PLAN
+CASSERT(CPU_DATA_ERRATA_PLAN == __builtin_offsetof
+		(cpu_data_t, errata_plan),
+		assert_cpu_data_errata_plan_offset_mismatch);
+
+CASSERT(CPU_DATA_ERRATA_PLAN_LIST == __builtin_offsetof
+		(cpu_data_t, errata_plan_list),
+		assert_cpu_data_errata_plan_list_offset_mismatch);
+#endif
+
 #if ENABLE_RUNTIME_INSTRUMENTATION
 CASSERT(CPU_DATA_PMF_TS0_OFFSET == __builtin_offsetof
 		(cpu_data_t, cpu_data_pmf_ts[0]),
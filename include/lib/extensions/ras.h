@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited and Contributors. All rights reserved.
  * Copyright (c) 2020, NVIDIA Corporation. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -72,6 +72,8 @@
 #ifndef __ASSEMBLER__
 
 #include <assert.h>
+#include <stdbool.h>
+#include <stdint.h>
 
 #include <lib/extensions/ras_arch.h>
 
@@ -115,6 +117,27 @@ struct err_handler_data {
 typedef int (*err_record_handler_t)(const struct err_record_info *info,
 		int probe_data, const struct err_handler_data *const data);
 
+/*
+ * Error statistics of an error record group. These are maintained by the RAS
+ * framework and must not be initialised by the platform.
+ */
+struct err_record_stats {
+	/* Number of errors handled for the group */
+	uint64_t num_errors;
+
+	/* Number of error storms detected on the group */
+	uint32_t num_storms;
+
+	/* Start of the current storm detection window, in system counter ticks */
+	uint64_t window_start;
+
+	/* Number of errors handled in the current storm detection window */
+	uint32_t window_errors;
+
+	/* Whether the group is in an error storm */
+	bool storm;
+};
+
 /* Error record information */
 struct err_record_info {
 	/* Function to probe error record group for errors */
@@ -155,6 +178,9 @@ struct err_record_info {
 
 	/* Error record access mechanism */
 	unsigned int access:1;
+
+	/* Error statistics, maintained by the RAS framework */
+	struct err_record_stats stats;
 };
 
 struct err_record_mapping {
@@ -197,6 +223,7 @@ const char *ras_serr_to_str(unsigned int serr);
 int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags);
 void ras_init(void);
+int ras_get_err_record_stats(unsigned int idx, struct err_record_stats *stats);
 
 #endif /* __ASSEMBLER__ */
 
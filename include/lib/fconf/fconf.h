@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,7 @@
 #ifndef FCONF_H
 #define FCONF_H
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -27,6 +28,24 @@
 		.populate = (callback)						\
 	};
 
+#if FCONF_BLOB
+/*
+ * Same as FCONF_REGISTER_POPULATOR, for a callback which also accepts a
+ * configuration compiled into a blob (see fconf_blob.h).
+ */
+#define FCONF_REGISTER_BLOB_POPULATOR(config, name, callback)			\
+	__attribute__((used, section(".fconf_populator")))			\
+	static const struct fconf_populator (name##__populator) = {		\
+		.config_type = (#config),					\
+		.info = (#name),						\
+		.populate = (callback),						\
+		.blob = true							\
+	};
+#else
+#define FCONF_REGISTER_BLOB_POPULATOR(config, name, callback)			\
+	FCONF_REGISTER_POPULATOR(config, name, callback)
+#endif
+
 /*
  * Populator callback
  *
@@ -42,6 +61,11 @@ struct fconf_populator {
 	 * Return 0 on success, err_code < 0 otherwise.
 	 */
 	int (*populate)(uintptr_t config);
+
+#if FCONF_BLOB
+	/* The callback also accepts a compiled configuration blob */
+	bool blob;
+#endif
 };
 
 /* This function supports to load tb_fw_config and fw_config dtb */
@@ -49,13 +73,28 @@ int fconf_load_config(unsigned int image_id);
 
 /* Top level populate function
  *
- * This function takes a configuration dtb and calls all the registered
- * populator callback with it.
+ * This function takes a configuration dtb, or a compiled configuration blob
+ * when FCONF_BLOB is enabled, and calls all the registered populator callback
+ * with it.
  *
  *  Panic on error.
  */
 void fconf_populate(const char *config_type, uintptr_t config);
 
+/*
+ * Same as fconf_populate() for a configuration held in 'size' bytes. A compiled
+ * configuration blob is only accepted through this function, since its size
+ * must be checked against the memory it was loaded into.
+ */
+void fconf_populate_with_size(const char *config_type, uintptr_t config,
+			      size_t size);
+
+/*
+ * Return the size given to fconf_populate_with_size() for the configuration at
+ * 'config' while its populator callbacks run, 0 otherwise.
+ */
+size_t fconf_get_populated_size(uintptr_t config);
+
 /* FCONF specific getter */
 #define fconf__dtb_getter(prop)	fconf_dtb_info.prop
 
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef FCONF_BLOB_H
+#define FCONF_BLOB_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <lib/utils_def.h>
+
+/*
+ * Compiled firmware configuration blob.
+ *
+ * A blob is produced at build time from a configuration DTB by
+ * tools/fconf_blob/fconf_blob.py. It starts with a header followed by a
+ * sequence of records, each made of a record header and a payload whose layout
+ * depends on the record tag. All fields are little-endian and records are
+ * 8-byte aligned. The checksum is chosen so that the sum of all the 32-bit
+ * words of the blob is 0.
+ *
+ * This layout is shared with the host tool and must be kept in sync with it.
+ */
+#define FCONF_BLOB_MAGIC		U(0x42434654)	/* "TFCB" */
+#define FCONF_BLOB_VERSION		U(1)
+
+/* Record tags */
+#define FCONF_BLOB_TAG_DTB_REGISTRY	U(1)
+#define FCONF_BLOB_TAG_TBBR		U(2)
+
+struct fconf_blob_header {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t num_records;
+	uint32_t total_size;
+	uint32_t checksum;
+};
+
+struct fconf_blob_record {
+	uint32_t tag;
+	/* Size of the payload following the record header */
+	uint32_t size;
+};
+
+/* FCONF_BLOB_TAG_DTB_REGISTRY: one entry per dtb-registry node */
+struct fconf_blob_dtb_info {
+	uint64_t load_address;
+	/* All ones when the node has no secondary-load-address */
+	uint64_t secondary_load_address;
+	uint32_t max_size;
+	uint32_t id;
+};
+
+/* FCONF_BLOB_TAG_TBBR: content of the "arm,tb_fw" node */
+struct fconf_blob_tbbr {
+	uint64_t mbedtls_heap_addr;
+	uint32_t mbedtls_heap_size;
+	uint32_t disable_auth;
+};
+
+bool fconf_is_blob(uintptr_t config, size_t size);
+int fconf_blob_check(uintptr_t config, size_t size);
+const void *fconf_blob_find(uintptr_t config, uint32_t tag, uint32_t *size);
+
+#endif /* FCONF_BLOB_H */
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TF_LZ4_H
+#define TF_LZ4_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <common/image_decompress.h>
+
+#define DECOMPRESSOR_FORMAT_LZ4						\
+	{								\
+		.magic = 0x184d2204U,					\
+		.magic_mask = 0xffffffffU,				\
+		.decompressor = unlz4,					\
+	}
+
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len);
+
+#endif /* TF_LZ4_H */
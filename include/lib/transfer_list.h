@@ -25,6 +25,14 @@
 /* Alignment required by TE header start address, in bytes */
 #define TRANSFER_LIST_GRANULE U(8)
 
+/*
+ * Number of entries of the index of the TEs found by transfer_list_find(),
+ * 0 to always search from the first TE
+ */
+#ifndef TRANSFER_LIST_INDEX_SIZE
+#define TRANSFER_LIST_INDEX_SIZE U(8)
+#endif
+
 /*
  * Version of the register convention used.
  * Set to 1 for both AArch64 and AArch32 according to fw handoff spec v0.9
@@ -106,6 +114,14 @@ transfer_list_relocate(struct transfer_list_header *tl, void *addr,
 enum transfer_list_ops
 transfer_list_check_header(const struct transfer_list_header *tl);
 
+/*
+ * The functions updating a transfer list only update its checksum for the
+ * bytes they change, so the checksum must be valid on entry to each of them,
+ * which is asserted in debug builds.
+ * A caller writing to the data of a transfer entry must then call
+ * transfer_list_update_checksum() before the next update of the list, and
+ * before handing it off.
+ */
 void transfer_list_update_checksum(struct transfer_list_header *tl);
 bool transfer_list_verify_checksum(const struct transfer_list_header *tl);
 
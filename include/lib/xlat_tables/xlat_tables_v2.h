@@ -337,6 +337,22 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx,
 				uintptr_t base_va,
 				size_t size);
 
+/*
+ * Open and close a batch of dynamic mapping operations. Between both calls,
+ * mmap_add_dynamic_region*() and mmap_remove_dynamic_region*() update the
+ * translation tables right away, but the sorting of the mmap array and the
+ * final cache maintenance, barriers and TLB invalidation sync are performed
+ * only once, by mmap_commit_dynamic_batch*().
+ *
+ * Regions added in a batch must not be accessed, and the VA of regions removed
+ * in a batch must not be reused by the caller, until the batch is committed.
+ * Batches can't be nested.
+ */
+void mmap_begin_dynamic_batch(void);
+void mmap_begin_dynamic_batch_ctx(xlat_ctx_t *ctx);
+void mmap_commit_dynamic_batch(void);
+void mmap_commit_dynamic_batch_ctx(xlat_ctx_t *ctx);
+
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 /*
@@ -80,6 +80,25 @@ struct xlat_ctx {
 	 */
 #if PLAT_XLAT_TABLES_DYNAMIC
 	int *tables_mapped_regions;
+
+	/*
+	 * State of the dynamic mapping batch opened with
+	 * mmap_begin_dynamic_batch_ctx(). While a batch is active, the sorting
+	 * of the mmap array, the update of max_pa/max_va and the cache and TLB
+	 * maintenance of the dynamic mapping functions are deferred until
+	 * mmap_commit_dynamic_batch_ctx() is called.
+	 */
+	struct {
+		bool active;
+		bool unsorted;
+		bool clean_pending;
+		bool tlbi_pending;
+		bool update_max_va;
+		bool update_max_pa;
+		/* VA range unmapped since the last TLB invalidation sync. */
+		uintptr_t unmap_start_va;
+		uintptr_t unmap_end_va;
+	} batch;
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 	int next_table;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -10,7 +10,21 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <common/image_decompress.h>
+
+/* gzip member header: ID1, ID2 and the deflate compression method */
+#define DECOMPRESSOR_FORMAT_GZIP					\
+	{								\
+		.magic = 0x00088b1fU,					\
+		.magic_mask = 0x00ffffffU,				\
+		.decompressor = gunzip,					\
+	}
+
 int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	   size_t out_len, uintptr_t work_buf, size_t work_len);
+int gunzip_stream(decompressor_read_t *read, void *ctx,
+		  uintptr_t in_buf, size_t in_len,
+		  uintptr_t *out_buf, size_t out_len,
+		  uintptr_t work_buf, size_t work_len, size_t *work_used);
 
 #endif /* TF_GUNZIP_H */
@@ -118,12 +118,18 @@ void arm_setup_romlib(void);
 #define ARM_INSTANTIATE_LOCK	static DEFINE_BAKERY_LOCK(arm_lock)
 #define ARM_LOCK_GET_INSTANCE	(&arm_lock)
 
+/*
+ * Each SCMI channel has its own lock, so that the CPUs using different
+ * channels do not wait for each other.
+ */
 #if !HW_ASSISTED_COHERENCY
-#define ARM_SCMI_INSTANTIATE_LOCK	DEFINE_BAKERY_LOCK(arm_scmi_lock)
+#define ARM_SCMI_INSTANTIATE_LOCK	\
+	DEFINE_BAKERY_LOCK(arm_scmi_lock[PLAT_ARM_SCMI_CHANNEL_COUNT])
 #else
-#define ARM_SCMI_INSTANTIATE_LOCK	spinlock_t arm_scmi_lock
+#define ARM_SCMI_INSTANTIATE_LOCK	\
+	spinlock_t arm_scmi_lock[PLAT_ARM_SCMI_CHANNEL_COUNT]
 #endif
-#define ARM_SCMI_LOCK_GET_INSTANCE	(&arm_scmi_lock)
+#define ARM_SCMI_LOCK_GET_INSTANCE(_channel_id)	(&arm_scmi_lock[(_channel_id)])
 
 /*
  * These are wrapper macros to the Coherent Memory Bakery Lock API.
@@ -132,6 +132,33 @@
 					/* 0x1B3 */
 #define RMM_ATTEST_GET_PLAT_TOKEN	SMC64_RMMD_EL3_FID(U(3))
 
+/*
+ * FIDs 0x1C0 - 0x1CE are not allocated by the RMM-EL3 interface specification
+ * and are used for TF-A implementation defined commands. EL3 returns SMC_UNK
+ * for the commands it does not implement, which lets RMM probe for them.
+ */
+#define RMMD_EL3_IMPDEF_FNUM_OFFSET	U(0x10)
+#define SMC64_RMMD_EL3_IMPDEF_FID(_offset)				\
+	SMC64_RMMD_EL3_FID(RMMD_EL3_IMPDEF_FNUM_OFFSET + (_offset))
+
+/*
+ * Process a batch of RMM-EL3 commands posted by RMM in the shared buffer.
+ * RMM is expected to dedicate a slot of the shared buffer to each CPU and to
+ * post the commands as an array of struct rmm_el3_cmd_entry in it. Only the
+ * RMM_GTSI_DELEGATE and RMM_GTSI_UNDELEGATE commands can be batched.
+ * The arguments to this SMC are :
+ *    arg0 - Function ID.
+ *    arg1 - Physical address of the first command entry. It must belong to
+ *           the shared buffer.
+ *    arg2 - Number of command entries.
+ * The return arguments are :
+ *    ret0 - Status / error.
+ *    ret1 - Number of command entries processed. The status of each command
+ *           is written back to its entry.
+ */
+					/* 0x1C0 */
+#define RMM_EL3_CMD_BATCH		SMC64_RMMD_EL3_IMPDEF_FID(U(0))
+
 /* ECC Curve types for attest key generation */
 #define ATTEST_KEY_CURVE_ECC_SECP384R1		0
 
@@ -166,9 +193,22 @@
 								& 0x7FFF)
 #define RMM_EL3_IFC_VERSION_GET_MAJOR_MINOR(_version) ((_version) & 0xFFFF)
 
+/*
+ * First Boot Interface version with which this implementation provides the
+ * implementation defined commands.
+ */
+#define RMM_EL3_IMPDEF_MIN_VERSION	((U(0) << 16) | U(2))
+
 #ifndef __ASSEMBLER__
 #include <stdint.h>
 
+/* Command entry used by RMM_EL3_CMD_BATCH */
+struct rmm_el3_cmd_entry {
+	uint64_t fid;		/* Written by RMM: FID of the command */
+	uint64_t arg;		/* Written by RMM: argument of the command */
+	int64_t result;		/* Written by EL3: return status */
+};
+
 int rmmd_setup(void);
 uint64_t rmmd_rmi_handler(uint32_t smc_fid,
 		uint64_t x1,
@@ -86,6 +86,7 @@
 #define SPM_MM_NOT_SUPPORTED	 -1
 #define SPM_MM_INVALID_PARAMETER -2
 #define SPM_MM_DENIED		 -3
+#define SPM_MM_BUSY		 -4
 #define SPM_MM_NO_MEMORY	 -5
 
 #ifndef __ASSEMBLER__
@@ -109,6 +110,9 @@ uint64_t spm_mm_sp_call(uint32_t smc_fid,
 			uint64_t x2,
 			uint64_t x3);
 
+/* Number of calls that found the secure partition busy */
+uint64_t spm_mm_get_contention_count(void);
+
 #endif /* __ASSEMBLER__ */
 
 #endif /* SPM_MM_SVC_H */
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef JOBS_H
+#define JOBS_H
+
+/* No dependency */
+#define JOB_NO_DEP		(-1)
+
+/*
+ * This structure describes a unit of work to be run by the worker pool.
+ *
+ * A job is only started once the job it depends on (identified by its index
+ * in the array passed to jobs_run()) has completed successfully. The job
+ * function returns 1 on success and 0 on failure.
+ */
+typedef struct job_s job_t;
+struct job_s {
+	int (*fn)(void *arg);	/* Function to run */
+	void *arg;		/* Argument passed to the function */
+	int dep;		/* Job to wait for, or JOB_NO_DEP */
+
+	int state;		/* Internal to the worker pool */
+};
+
+/* Exported API */
+int jobs_run(job_t *jobs, unsigned int num_jobs, unsigned int num_threads);
+
+#endif /* JOBS_H */
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Per-CPU plan of the reset errata workarounds to apply on warm boot. */
+
+#include <assert.h>
+
+#include <arch_helpers.h>
+#include <common/debug.h>
+#include <lib/cpus/cpu_ops.h>
+#include <lib/cpus/errata.h>
+#include <lib/el3_runtime/cpu_data.h>
+
+/*
+ * Record in the cpu_data of the calling CPU which of its reset errata
+ * workarounds apply, so that warm_reset_handler can apply them without checking
+ * the CPU revision again. This is done once per CPU, on its first boot. Must be
+ * called after the cpu_ops pointer has been initialised in cpu_data.
+ */
+void errata_plan_init(void)
+{
+	struct cpu_ops *cpu_ops = (void *)get_cpu_data(cpu_ops_ptr);
+	struct erratum_entry *entry;
+	uint64_t plan = 0ULL;
+	unsigned int i = 0U;
+	long rev_var;
+
+	if ((get_cpu_data(errata_plan) & ERRATA_PLAN_VALID) != 0ULL) {
+		return;
+	}
+
+	assert(cpu_ops != NULL);
+
+	rev_var = cpu_get_rev_var();
+
+	for (entry = cpu_ops->errata_list_start;
+	     entry != cpu_ops->errata_list_end; entry++, i++) {
+		if (i == ERRATA_PLAN_MAX) {
+			/* The reset function keeps checking every erratum */
+			VERBOSE("Too many errata to record an errata plan\n");
+			return;
+		}
+
+		/* Same selection as the reset function */
+		if ((entry->chosen == 0U) || (entry->wa_func == NULL)) {
+			continue;
+		}
+
+		if (entry->check_func(rev_var) != ERRATA_NOT_APPLIES) {
+			plan |= ULL(1) << i;
+		}
+	}
+
+	set_cpu_data(errata_plan_list, (uintptr_t)cpu_ops->errata_list_start);
+	set_cpu_data(errata_plan, plan | ERRATA_PLAN_VALID);
+
+	/*
+	 * The plan and the cpu_ops pointer it is checked against are read with
+	 * the data cache disabled on warm boot.
+	 */
+	flush_cpu_data(cpu_ops_ptr);
+	flush_cpu_data(errata_plan_list);
+	flush_cpu_data(errata_plan);
+}
+
+/*
+ * Return whether the erratum described by 'entry', from the errata list of the
+ * calling CPU, applies to it. The errata plan of the CPU is used for the reset
+ * errata it covers, the checker function of the erratum otherwise.
+ */
+uint64_t errata_plan_check(struct erratum_entry *entry, long rev_var)
+{
+	struct cpu_ops *cpu_ops = (void *)get_cpu_data(cpu_ops_ptr);
+	uint64_t plan = get_cpu_data(errata_plan);
+	uintptr_t index;
+
+	if (((plan & ERRATA_PLAN_VALID) == 0ULL) ||
+	    (entry->chosen == 0U) || (entry->wa_func == NULL) ||
+	    (get_cpu_data(errata_plan_list) !=
+	     (uintptr_t)cpu_ops->errata_list_start)) {
+		return entry->check_func(rev_var);
+	}
+
+	index = (uintptr_t)(entry -
+		(struct erratum_entry *)cpu_ops->errata_list_start);
+	assert(index < ERRATA_PLAN_MAX);
+
+	return ((plan & (ULL(1) << index)) != 0ULL) ?
+		ERRATA_APPLIES : ERRATA_NOT_APPLIES;
+}
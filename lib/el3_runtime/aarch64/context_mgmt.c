@@ -33,6 +33,7 @@
 #include <lib/extensions/trbe.h>
 #include <lib/extensions/trf.h>
 #include <lib/utils.h>
+#include <plat/common/platform.h>
 
 #if ENABLE_FEAT_TWED
 /* Make sure delay value fits within the range(0-15) */
@@ -1821,3 +1822,85 @@ void cm_set_next_eret_context(uint32_t security_state)
 
 	cm_set_next_context(ctx);
 }
+
+#if IMAGE_BL31 && CTX_FPREGS_LAZY
+/*
+ * Context whose FP/SIMD state is live in the registers of each core but has
+ * not been saved yet, while a lazy switch is in progress.
+ */
+static cpu_context_t *fpregs_lazy_owner[PLATFORM_CORE_COUNT];
+
+/*******************************************************************************
+ * Start a lazy switch of the FP/SIMD registers from the 'owner' context to
+ * 'ctx'. Instead of saving the FP/SIMD state of 'owner' up front, CPTR_EL3.TFP
+ * is set on exit to 'ctx', so that the state is only saved if 'ctx' uses the
+ * FP/SIMD registers. This must be paired with cm_fpregs_lazy_exit().
+ ******************************************************************************/
+void cm_fpregs_lazy_enter(cpu_context_t *owner, cpu_context_t *ctx)
+{
+	unsigned int core_pos = plat_my_core_pos();
+
+	assert(owner != NULL);
+	assert(ctx != NULL);
+	assert(fpregs_lazy_owner[core_pos] == NULL);
+
+	fpregs_lazy_owner[core_pos] = owner;
+	write_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LAZY_STATE,
+		      FPREGS_LAZY_TRAP);
+}
+
+/*******************************************************************************
+ * End the lazy switch started by cm_fpregs_lazy_enter(). If 'ctx' used the
+ * FP/SIMD registers, the state of the owner context is restored. Returns true
+ * in that case.
+ ******************************************************************************/
+bool cm_fpregs_lazy_exit(cpu_context_t *ctx)
+{
+	unsigned int core_pos = plat_my_core_pos();
+	cpu_context_t *owner = fpregs_lazy_owner[core_pos];
+	el3_state_t *state = get_el3state_ctx(ctx);
+	bool dirty;
+
+	assert(owner != NULL);
+
+	dirty = (read_ctx_reg(state, CTX_FPREGS_LAZY_STATE) &
+		 FPREGS_LAZY_DIRTY) != 0U;
+	write_ctx_reg(state, CTX_FPREGS_LAZY_STATE, 0U);
+	fpregs_lazy_owner[core_pos] = NULL;
+
+	if (dirty) {
+		fpregs_context_restore(get_fpregs_ctx(owner));
+	}
+
+	return dirty;
+}
+
+/*******************************************************************************
+ * Handle the trap taken by the first use of the FP/SIMD registers by a context
+ * in a lazy switch: save the state of the owner context and let the trapping
+ * instruction run again with the FP/SIMD registers enabled.
+ ******************************************************************************/
+int cm_handle_fpregs_trap(cpu_context_t *ctx)
+{
+	unsigned int core_pos = plat_my_core_pos();
+	el3_state_t *state = get_el3state_ctx(ctx);
+	cpu_context_t *owner = fpregs_lazy_owner[core_pos];
+
+	if ((owner == NULL) ||
+	    ((read_ctx_reg(state, CTX_FPREGS_LAZY_STATE) &
+	      FPREGS_LAZY_TRAP) == 0U)) {
+		return -1;
+	}
+
+	/* EL3 accesses to the FP/SIMD registers are trapped as well */
+	write_cptr_el3(read_cptr_el3() & ~TFP_BIT);
+	isb();
+
+	fpregs_context_save(get_fpregs_ctx(owner));
+
+	/* el3_exit() no longer sets CPTR_EL3.TFP for this context */
+	write_ctx_reg(state, CTX_FPREGS_LAZY_STATE, FPREGS_LAZY_DIRTY);
+
+	return 0;
+}
+#endif /* IMAGE_BL31 && CTX_FPREGS_LAZY */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited and Contributors. All rights reserved.
  * Copyright (c) 2020, NVIDIA Corporation. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -13,12 +13,44 @@
 #include <common/debug.h>
 #include <lib/extensions/ras.h>
 #include <lib/extensions/ras_arch.h>
+#include <lib/spinlock.h>
 #include <plat/common/platform.h>
 
+#include <platform_def.h>
+
 #ifndef PLAT_RAS_PRI
 # error Platform must define RAS priority value
 #endif
 
+/*
+ * A record group is in an error storm when it signals more than
+ * PLAT_RAS_STORM_THRESHOLD errors within PLAT_RAS_STORM_WINDOW_MS. It leaves
+ * the storm once a whole window passes with fewer errors.
+ */
+#ifndef PLAT_RAS_STORM_THRESHOLD
+#define PLAT_RAS_STORM_THRESHOLD	16U
+#endif
+
+#ifndef PLAT_RAS_STORM_WINDOW_MS
+#define PLAT_RAS_STORM_WINDOW_MS	1000U
+#endif
+
+/*
+ * Maximum number of errors handled for a group in an error storm on each
+ * External Abort. This bounds the time spent in EL3 while the group keeps on
+ * signalling errors. The errors left are handled through a RAS interrupt of the
+ * group, which is pended for that purpose.
+ */
+#ifndef PLAT_RAS_STORM_SCAN_BUDGET
+#define PLAT_RAS_STORM_SCAN_BUDGET	1U
+#endif
+
+/* Protects the error statistics of all the record groups */
+static spinlock_t ras_stats_lock;
+
+/* Index of the record group which last signalled an error */
+static unsigned int ras_hot_record;
+
 /*
  * Function to convert architecturally-defined primary error code SERR,
  * bits[7:0] from ERR<n>STATUS to its corresponding error string.
@@ -60,13 +92,77 @@ const char *ras_serr_to_str(unsigned int serr)
 	return str[serr];
 }
 
+/*
+ * Account for an error handled for a record group, and update its storm state.
+ * Return whether the group is in an error storm.
+ */
+static bool ras_record_error(struct err_record_info *info)
+{
+	struct err_record_stats *stats = &info->stats;
+	uint64_t now = read_cntpct_el0();
+	uint64_t window = (read_cntfrq_el0() * PLAT_RAS_STORM_WINDOW_MS) / 1000U;
+	bool storm;
+
+	spin_lock(&ras_stats_lock);
+
+	stats->num_errors++;
+
+	if ((now - stats->window_start) >= window) {
+		if (stats->storm &&
+		    (stats->window_errors <= PLAT_RAS_STORM_THRESHOLD)) {
+			stats->storm = false;
+			NOTICE("RAS error storm ended on record group %u\n",
+			       (unsigned int)(info - err_record_mappings.err_records));
+		}
+		stats->window_start = now;
+		stats->window_errors = 0U;
+	}
+
+	stats->window_errors++;
+
+	if (!stats->storm &&
+	    (stats->window_errors > PLAT_RAS_STORM_THRESHOLD)) {
+		stats->storm = true;
+		stats->num_storms++;
+		WARN("RAS error storm on record group %u, throttling\n",
+		     (unsigned int)(info - err_record_mappings.err_records));
+	}
+
+	storm = stats->storm;
+
+	spin_unlock(&ras_stats_lock);
+
+	return storm;
+}
+
+/*
+ * Pend a RAS interrupt registered for a record group, so that the errors left
+ * in the group are handled once EL3 returns. Return whether such an interrupt
+ * was found.
+ */
+static bool ras_resignal_record(const struct err_record_info *info)
+{
+	unsigned int i;
+
+	for (i = 0U; i < ras_interrupt_mappings.num_intrs; i++) {
+		if (ras_interrupt_mappings.intrs[i].err_record == info) {
+			plat_ic_set_interrupt_pending(
+				ras_interrupt_mappings.intrs[i].intr_number);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 /* Handler that receives External Aborts on RAS-capable systems */
 int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags)
 {
-	unsigned int i, n_handled = 0;
+	unsigned int i, idx, hot, n_handled = 0, n_group;
 	int probe_data, ret;
 	struct err_record_info *info;
+	size_t num_records = err_record_mappings.num_err_records;
 
 	const struct err_handler_data err_data = {
 		.version = ERR_HANDLER_VERSION,
@@ -78,11 +174,23 @@ int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		.handle = handle
 	};
 
-	for_each_err_record_info(i, info) {
+	/*
+	 * Errors come in bursts from the same source, so start probing from
+	 * the record group which last signalled an error.
+	 */
+	hot = ras_hot_record;
+	if (hot >= num_records)
+		hot = 0U;
+
+	for (i = 0U; i < num_records; i++) {
+		idx = (unsigned int)((hot + i) % num_records);
+		info = &err_record_mappings.err_records[idx];
+
 		assert(info->probe != NULL);
 		assert(info->handler != NULL);
 
 		/* Continue probing until the record group signals no error */
+		n_group = 0U;
 		while (true) {
 			if (info->probe(info, &probe_data) == 0)
 				break;
@@ -92,13 +200,44 @@ int ras_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 			if (ret != 0)
 				return ret;
 
+			if (n_handled == 0U)
+				ras_hot_record = idx;
+
 			n_handled++;
+			n_group++;
+
+			/*
+			 * Move on to the other groups while this one storms. The
+			 * group is only left with errors pending if one of its
+			 * interrupts can be pended to handle them later.
+			 */
+			if (ras_record_error(info) &&
+			    (n_group >= PLAT_RAS_STORM_SCAN_BUDGET) &&
+			    ras_resignal_record(info))
+				break;
 		}
 	}
 
 	return (n_handled != 0U) ? 1 : 0;
 }
 
+/*
+ * Retrieve the error statistics of the record group at index 'idx' in the
+ * array registered by the platform. Return 0 on success, -1 if there is no
+ * such group.
+ */
+int ras_get_err_record_stats(unsigned int idx, struct err_record_stats *stats)
+{
+	if ((idx >= err_record_mappings.num_err_records) || (stats == NULL))
+		return -1;
+
+	spin_lock(&ras_stats_lock);
+	*stats = err_record_mappings.err_records[idx].stats;
+	spin_unlock(&ras_stats_lock);
+
+	return 0;
+}
+
 #if ENABLE_ASSERTIONS
 static void assert_interrupts_sorted(void)
 {
@@ -126,7 +265,7 @@ static int ras_interrupt_handler(uint32_t intr_raw, uint32_t flags,
 	struct ras_interrupt *ras_inrs = ras_interrupt_mappings.intrs;
 	struct ras_interrupt *selected = NULL;
 	int probe_data = 0;
-	int start, end, mid, ret __unused;
+	int start, end, mid;
 
 	const struct err_handler_data err_data = {
 		.version = ERR_HANDLER_VERSION,
@@ -160,8 +299,13 @@ static int ras_interrupt_handler(uint32_t intr_raw, uint32_t flags,
 	}
 
 	if (selected->err_record->probe != NULL) {
-		ret = selected->err_record->probe(selected->err_record, &probe_data);
-		assert(ret != 0);
+		/*
+		 * The interrupt may have been pended by ras_ea_handler() for
+		 * errors which were all handled since.
+		 */
+		if (selected->err_record->probe(selected->err_record,
+						&probe_data) == 0)
+			return 0;
 	}
 
 	/* Call error handler for the record group */
@@ -169,6 +313,13 @@ static int ras_interrupt_handler(uint32_t intr_raw, uint32_t flags,
 	(void) selected->err_record->handler(selected->err_record, probe_data,
 			&err_data);
 
+	(void) ras_record_error(selected->err_record);
+
+	/* Signal again the errors left in the group, one per interrupt */
+	if ((selected->err_record->probe != NULL) &&
+	    (selected->err_record->probe(selected->err_record, &probe_data) != 0))
+		plat_ic_set_interrupt_pending(intr_raw);
+
 	return 0;
 }
 
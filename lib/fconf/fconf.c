@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,11 +9,16 @@
 #include <common/debug.h>
 #include <common/fdt_wrappers.h>
 #include <lib/fconf/fconf.h>
+#include <lib/fconf/fconf_blob.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
 #include <libfdt.h>
 #include <plat/common/platform.h>
 #include <platform_def.h>
 
+/* Configuration being populated by fconf_populate_with_size(), and its size */
+static uintptr_t populated_config;
+static size_t populated_size;
+
 int fconf_load_config(unsigned int image_id)
 {
 	int err;
@@ -49,10 +54,29 @@ int fconf_load_config(unsigned int image_id)
 
 void fconf_populate(const char *config_type, uintptr_t config)
 {
+	/* The size of the configuration is unknown, so only a DTB is accepted */
+	fconf_populate_with_size(config_type, config, 0U);
+}
+
+void fconf_populate_with_size(const char *config_type, uintptr_t config,
+			      size_t size)
+{
+	bool is_blob = false;
+
 	assert(config != 0UL);
 
+#if FCONF_BLOB
+	if (fconf_is_blob(config, size)) {
+		if (fconf_blob_check(config, size) != 0) {
+			ERROR("FCONF: Invalid blob passed for %s\n", config_type);
+			panic();
+		}
+		is_blob = true;
+	}
+#endif
+
 	/* Check if the pointer to DTB is correct */
-	if (fdt_check_header((void *)config) != 0) {
+	if (!is_blob && (fdt_check_header((void *)config) != 0)) {
 		ERROR("FCONF: Invalid DTB file passed for %s\n", config_type);
 		panic();
 	}
@@ -64,10 +88,20 @@ void fconf_populate(const char *config_type, uintptr_t config)
 	IMPORT_SYM(struct fconf_populator *, __FCONF_POPULATOR_END__, end);
 	const struct fconf_populator *populator;
 
+	populated_config = config;
+	populated_size = size;
+
 	for (populator = start; populator != end; populator++) {
 		assert((populator->info != NULL) && (populator->populate != NULL));
 
 		if (strcmp(populator->config_type, config_type) == 0) {
+#if FCONF_BLOB
+			if (is_blob && !populator->blob) {
+				ERROR("FCONF: %s can't be read from a compiled blob\n",
+				      populator->info);
+				panic();
+			}
+#endif
 			INFO("FCONF: Reading firmware configuration information for: %s\n", populator->info);
 			if (populator->populate(config) != 0) {
 				/* TODO: handle property miss */
@@ -75,4 +109,12 @@ void fconf_populate(const char *config_type, uintptr_t config)
 			}
 		}
 	}
+
+	populated_config = 0UL;
+	populated_size = 0U;
+}
+
+size_t fconf_get_populated_size(uintptr_t config)
+{
+	return (config == populated_config) ? populated_size : 0U;
 }
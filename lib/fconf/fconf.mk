@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2019-2021, Arm Limited. All rights reserved.
+# Copyright (c) 2019-2024, Arm Limited. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -17,3 +17,8 @@ FCONF_AMU_SOURCES	+=	${FDT_WRAPPERS_SOURCES}
 
 FCONF_MPMM_SOURCES	:=	lib/fconf/fconf_mpmm_getter.c
 FCONF_MPMM_SOURCES	+=	${FDT_WRAPPERS_SOURCES}
+
+ifeq (${FCONF_BLOB},1)
+FCONF_SOURCES		+=	lib/fconf/fconf_blob.c
+FCONF_DYN_SOURCES	+=	lib/fconf/fconf_blob.c
+endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <errno.h>
+
+#include <common/debug.h>
+#include <lib/fconf/fconf_blob.h>
+
+/*
+ * Return true if the configuration held in the 'size' bytes at 'config' starts
+ * with the header of a compiled blob.
+ */
+bool fconf_is_blob(uintptr_t config, size_t size)
+{
+	const struct fconf_blob_header *hdr = (const void *)config;
+
+	if (size < sizeof(*hdr)) {
+		return false;
+	}
+
+	return hdr->magic == FCONF_BLOB_MAGIC;
+}
+
+/*
+ * Check the header, the records layout and the checksum of the blob loaded in
+ * the 'size' bytes at 'config'. Return 0 if the blob can be used, a negative
+ * error code otherwise.
+ */
+int fconf_blob_check(uintptr_t config, size_t size)
+{
+	const struct fconf_blob_header *hdr = (const void *)config;
+	const uint32_t *word = (const void *)config;
+	const struct fconf_blob_record *rec;
+	uintptr_t pos, end;
+	uint32_t sum = 0U;
+	unsigned int i;
+
+	if ((size < sizeof(*hdr)) || (hdr->magic != FCONF_BLOB_MAGIC)) {
+		return -EINVAL;
+	}
+
+	if (hdr->version != FCONF_BLOB_VERSION) {
+		ERROR("FCONF: Unsupported blob version %u\n", hdr->version);
+		return -EINVAL;
+	}
+
+	if ((hdr->total_size < sizeof(*hdr)) || (hdr->total_size > size) ||
+	    ((hdr->total_size % sizeof(uint64_t)) != 0U)) {
+		ERROR("FCONF: Invalid blob size 0x%x (image size 0x%zx)\n",
+		      hdr->total_size, size);
+		return -EINVAL;
+	}
+
+	for (i = 0U; i < (hdr->total_size / sizeof(uint32_t)); i++) {
+		sum += word[i];
+	}
+
+	if (sum != 0U) {
+		ERROR("FCONF: Blob checksum mismatch\n");
+		return -EINVAL;
+	}
+
+	pos = config + sizeof(*hdr);
+	end = config + hdr->total_size;
+
+	for (i = 0U; i < hdr->num_records; i++) {
+		rec = (const void *)pos;
+
+		if (((end - pos) < sizeof(*rec)) ||
+		    ((end - pos - sizeof(*rec)) < rec->size) ||
+		    ((rec->size % sizeof(uint64_t)) != 0U)) {
+			ERROR("FCONF: Malformed blob record %u\n", i);
+			return -EINVAL;
+		}
+
+		pos += sizeof(*rec) + rec->size;
+	}
+
+	/* The last record must end where the blob ends */
+	if (pos != end) {
+		ERROR("FCONF: Blob records do not match the blob size\n");
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/*
+ * Return the payload of the first record with the given tag in the blob at
+ * 'config', and its size in 'size', or NULL if there is none. The blob must
+ * have been checked with fconf_blob_check().
+ */
+const void *fconf_blob_find(uintptr_t config, uint32_t tag, uint32_t *size)
+{
+	const struct fconf_blob_header *hdr = (const void *)config;
+	const struct fconf_blob_record *rec;
+	uintptr_t pos = config + sizeof(*hdr);
+	unsigned int i;
+
+	assert(size != NULL);
+
+	for (i = 0U; i < hdr->num_records; i++) {
+		rec = (const void *)pos;
+
+		if (rec->tag == tag) {
+			*size = rec->size;
+			return (const void *)(pos + sizeof(*rec));
+		}
+
+		pos += sizeof(*rec) + rec->size;
+	}
+
+	return NULL;
+}
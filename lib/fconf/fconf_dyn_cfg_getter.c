@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,6 +8,7 @@
 
 #include <common/debug.h>
 #include <common/fdt_wrappers.h>
+#include <lib/fconf/fconf_blob.h>
 #include <lib/fconf/fconf_dyn_cfg_getter.h>
 #include <lib/object_pool.h>
 #include <libfdt.h>
@@ -73,6 +74,70 @@ struct dyn_cfg_dtb_info_t *dyn_cfg_dtb_info_getter(unsigned int config_id)
 	return NULL;
 }
 
+#if FCONF_BLOB
+/*
+ * Return the size of the FW_CONFIG region if 'config' is the FW_CONFIG loaded
+ * by BL1, 0 otherwise.
+ */
+static size_t fconf_bl1_fw_config_size(uintptr_t config)
+{
+	unsigned int i = dyn_cfg_dtb_info_get_index(FW_CONFIG_ID);
+
+	if ((i != FCONF_INVALID_IDX) && (dtb_infos[i].config_addr == config)) {
+		return dtb_infos[i].config_max_size;
+	}
+
+	return 0U;
+}
+
+static int fconf_populate_blob_dtb_registry(uintptr_t config)
+{
+	const struct fconf_blob_header *hdr = (const void *)config;
+	const struct fconf_blob_dtb_info *info;
+	size_t bl1_size;
+	uint32_t size;
+	unsigned int i;
+	int rc;
+
+	/*
+	 * BL1 calls this populator directly on the FW_CONFIG it has loaded, so
+	 * check the blob here too against the size of the FW_CONFIG region. Other
+	 * images go through fconf_populate_with_size(), which checked it already.
+	 */
+	bl1_size = fconf_bl1_fw_config_size(config);
+	if (bl1_size != 0U) {
+		rc = fconf_blob_check(config, bl1_size);
+		if (rc != 0) {
+			return rc;
+		}
+	}
+
+	if (dtb_infos[0].config_id == 0U) {
+		set_config_info(config, ~0UL, hdr->total_size, FW_CONFIG_ID);
+	}
+
+	info = fconf_blob_find(config, FCONF_BLOB_TAG_DTB_REGISTRY, &size);
+	if (info == NULL) {
+		ERROR("FCONF: Can't find dtb-registry record in blob\n");
+		return -FDT_ERR_NOTFOUND;
+	}
+
+	for (i = 0U; i < (size / sizeof(*info)); i++) {
+		VERBOSE("FCONF: dyn_cfg.dtb_registry record found with:\n");
+		VERBOSE("\tload-address = %lx\n",
+			(uintptr_t)info[i].load_address);
+		VERBOSE("\tmax-size = 0x%x\n", info[i].max_size);
+		VERBOSE("\tconfig-id = %u\n", info[i].id);
+
+		set_config_info((uintptr_t)info[i].load_address,
+				(uintptr_t)info[i].secondary_load_address,
+				info[i].max_size, info[i].id);
+	}
+
+	return 0;
+}
+#endif /* FCONF_BLOB */
+
 int fconf_populate_dtb_registry(uintptr_t config)
 {
 	int rc;
@@ -81,6 +146,18 @@ int fconf_populate_dtb_registry(uintptr_t config)
 	/* As libfdt use void *, we can't avoid this cast */
 	const void *dtb = (void *)config;
 
+#if FCONF_BLOB
+	size_t size = fconf_bl1_fw_config_size(config);
+
+	if (size == 0U) {
+		size = fconf_get_populated_size(config);
+	}
+
+	if (fconf_is_blob(config, size)) {
+		return fconf_populate_blob_dtb_registry(config);
+	}
+#endif
+
 	/*
 	 * In case of BL1, fw_config dtb information is already
 	 * populated in global dtb_infos array by 'set_config_info'
@@ -154,4 +231,4 @@ int fconf_populate_dtb_registry(uintptr_t config)
 	return 0;
 }
 
-FCONF_REGISTER_POPULATOR(FW_CONFIG, dyn_cfg, fconf_populate_dtb_registry);
+FCONF_REGISTER_BLOB_POPULATOR(FW_CONFIG, dyn_cfg, fconf_populate_dtb_registry);
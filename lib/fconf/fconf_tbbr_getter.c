@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2022, Arm Limited. All rights reserved.
+ * Copyright (c) 2019-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,11 +8,41 @@
 #include <common/bl_common.h>
 #include <common/debug.h>
 #include <common/fdt_wrappers.h>
+#include <lib/fconf/fconf_blob.h>
 #include <lib/fconf/fconf_tbbr_getter.h>
 #include <libfdt.h>
 
 struct tbbr_dyn_config_t tbbr_dyn_config;
 
+#if FCONF_BLOB
+static int fconf_populate_blob_tbbr_dyn_config(uintptr_t config)
+{
+	const struct fconf_blob_tbbr *tbbr;
+	uint32_t size;
+
+	tbbr = fconf_blob_find(config, FCONF_BLOB_TAG_TBBR, &size);
+	if ((tbbr == NULL) || (size < sizeof(*tbbr))) {
+		ERROR("FCONF: Can't find tbbr record in blob\n");
+		return -FDT_ERR_NOTFOUND;
+	}
+
+	/* The host tool only accepts a boolean disable_auth */
+	assert(tbbr->disable_auth <= 1U);
+	tbbr_dyn_config.disable_auth = tbbr->disable_auth;
+
+#if defined(DYN_DISABLE_AUTH)
+	if (tbbr_dyn_config.disable_auth == 1)
+		dyn_disable_auth();
+#endif
+
+	tbbr_dyn_config.mbedtls_heap_addr =
+		(void *)(uintptr_t)tbbr->mbedtls_heap_addr;
+	tbbr_dyn_config.mbedtls_heap_size = tbbr->mbedtls_heap_size;
+
+	return 0;
+}
+#endif /* FCONF_BLOB */
+
 int fconf_populate_tbbr_dyn_config(uintptr_t config)
 {
 	int err;
@@ -23,6 +53,12 @@ int fconf_populate_tbbr_dyn_config(uintptr_t config)
 	/* As libfdt use void *, we can't avoid this cast */
 	const void *dtb = (void *)config;
 
+#if FCONF_BLOB
+	if (fconf_is_blob(config, fconf_get_populated_size(config))) {
+		return fconf_populate_blob_tbbr_dyn_config(config);
+	}
+#endif
+
 	/* Assert the node offset point to "arm,tb_fw" compatible property */
 	const char *compatible_str = "arm,tb_fw";
 	node = fdt_node_offset_by_compatible(dtb, -1, compatible_str);
@@ -81,4 +117,4 @@ int fconf_populate_tbbr_dyn_config(uintptr_t config)
 	return 0;
 }
 
-FCONF_REGISTER_POPULATOR(TB_FW, tbbr, fconf_populate_tbbr_dyn_config);
+FCONF_REGISTER_BLOB_POPULATOR(TB_FW, tbbr, fconf_populate_tbbr_dyn_config);
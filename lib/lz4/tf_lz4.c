@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Decoder for the LZ4 frame format, as produced by the lz4 command line tool.
+ * See https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md and
+ * lz4_Block_format.md. Dictionaries and legacy frames are not supported.
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <common/debug.h>
+#include <tf_lz4.h>
+
+#define LZ4_FRAME_MAGIC		0x184d2204U
+#define LZ4_SKIP_MAGIC		0x184d2a50U
+#define LZ4_SKIP_MAGIC_MASK	0xfffffff0U
+
+/* Frame descriptor flags */
+#define LZ4_FLG_VERSION_MASK	0xc0U
+#define LZ4_FLG_VERSION		0x40U
+#define LZ4_FLG_BLOCK_CSUM	0x10U
+#define LZ4_FLG_CONTENT_SIZE	0x08U
+#define LZ4_FLG_CONTENT_CSUM	0x04U
+#define LZ4_FLG_RESERVED	0x02U
+#define LZ4_FLG_DICT_ID		0x01U
+#define LZ4_BD_RESERVED		0x8fU
+
+#define LZ4_BLOCK_UNCOMPRESSED	0x80000000U
+#define LZ4_MIN_MATCH		4U
+
+#define XXH_PRIME32_1		2654435761U
+#define XXH_PRIME32_2		2246822519U
+#define XXH_PRIME32_3		3266489917U
+#define XXH_PRIME32_4		668265263U
+#define XXH_PRIME32_5		374761393U
+
+static inline uint32_t read_le32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+	       ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t rotl32(uint32_t x, unsigned int r)
+{
+	return (x << r) | (x >> (32U - r));
+}
+
+static inline uint32_t xxh32_round(uint32_t acc, uint32_t input)
+{
+	acc += input * XXH_PRIME32_2;
+	return rotl32(acc, 13U) * XXH_PRIME32_1;
+}
+
+/* XXH32 hash with a seed of 0, used by all the LZ4 frame checksums */
+static uint32_t xxh32(const uint8_t *p, size_t len)
+{
+	const uint8_t *end = p + len;
+	uint32_t v1, v2, v3, v4, h;
+
+	if (len >= 16U) {
+		v1 = XXH_PRIME32_1 + XXH_PRIME32_2;
+		v2 = XXH_PRIME32_2;
+		v3 = 0U;
+		v4 = 0U - XXH_PRIME32_1;
+
+		do {
+			v1 = xxh32_round(v1, read_le32(p));
+			v2 = xxh32_round(v2, read_le32(p + 4));
+			v3 = xxh32_round(v3, read_le32(p + 8));
+			v4 = xxh32_round(v4, read_le32(p + 12));
+			p += 16;
+		} while ((size_t)(end - p) >= 16U);
+
+		h = rotl32(v1, 1U) + rotl32(v2, 7U) + rotl32(v3, 12U) +
+		    rotl32(v4, 18U);
+	} else {
+		h = XXH_PRIME32_5;
+	}
+
+	h += (uint32_t)len;
+
+	while ((size_t)(end - p) >= 4U) {
+		h += read_le32(p) * XXH_PRIME32_3;
+		h = rotl32(h, 17U) * XXH_PRIME32_4;
+		p += 4;
+	}
+
+	while (p < end) {
+		h += *p * XXH_PRIME32_5;
+		h = rotl32(h, 11U) * XXH_PRIME32_1;
+		p++;
+	}
+
+	h ^= h >> 15;
+	h *= XXH_PRIME32_2;
+	h ^= h >> 13;
+	h *= XXH_PRIME32_3;
+	h ^= h >> 16;
+
+	return h;
+}
+
+/* Read the extension bytes of a literal or match length */
+static bool lz4_read_length(const uint8_t **ip, const uint8_t *iend,
+			    size_t *len)
+{
+	uint8_t b;
+
+	do {
+		if (*ip >= iend) {
+			return false;
+		}
+		b = *(*ip)++;
+		*len += b;
+	} while (b == 0xffU);
+
+	return true;
+}
+
+/*
+ * Decode one compressed block to 'op'. Matches may refer to data decoded from
+ * previous blocks, down to 'ostart'. Return the end of the decoded data, or
+ * NULL if the block is malformed or doesn't fit before 'oend'.
+ */
+static uint8_t *lz4_decode_block(const uint8_t *ip, size_t in_len,
+				 uint8_t *op, uint8_t *ostart, uint8_t *oend)
+{
+	const uint8_t *iend = ip + in_len;
+	const uint8_t *match;
+	size_t len, offset;
+	uint8_t token;
+
+	while (ip < iend) {
+		token = *ip++;
+
+		/* Literals */
+		len = token >> 4;
+		if ((len == 15U) && !lz4_read_length(&ip, iend, &len)) {
+			return NULL;
+		}
+
+		if ((len > (size_t)(iend - ip)) || (len > (size_t)(oend - op))) {
+			return NULL;
+		}
+
+		(void)memcpy(op, ip, len);
+		ip += len;
+		op += len;
+
+		/* The last sequence of a block only has literals */
+		if (ip == iend) {
+			break;
+		}
+
+		/* Match */
+		if ((size_t)(iend - ip) < 2U) {
+			return NULL;
+		}
+
+		offset = (size_t)ip[0] | ((size_t)ip[1] << 8);
+		ip += 2;
+
+		if ((offset == 0U) || (offset > (size_t)(op - ostart))) {
+			return NULL;
+		}
+
+		len = token & 0xfU;
+		if ((len == 15U) && !lz4_read_length(&ip, iend, &len)) {
+			return NULL;
+		}
+		len += LZ4_MIN_MATCH;
+
+		if (len > (size_t)(oend - op)) {
+			return NULL;
+		}
+
+		match = op - offset;
+		if (offset >= len) {
+			(void)memcpy(op, match, len);
+			op += len;
+		} else {
+			/* Overlapping match, repeating the last bytes */
+			while (len-- != 0U) {
+				*op++ = *match++;
+			}
+		}
+	}
+
+	return op;
+}
+
+/*
+ * unlz4 - decompress LZ4 frame data
+ * @in_buf: source of compressed input. Upon exit, the end of input.
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace (unused)
+ * @work_len: length of workspace (unused)
+ *
+ * Consecutive frames are decompressed one after the other, and skippable frames
+ * are skipped.
+ */
+int unlz4(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
+	  size_t out_len, uintptr_t work_buf, size_t work_len)
+{
+	const uint8_t *ip = (const uint8_t *)*in_buf;
+	const uint8_t *iend = ip + in_len;
+	const uint8_t *desc;
+	uint8_t *ostart = (uint8_t *)*out_buf;
+	uint8_t *oend = ostart + out_len;
+	uint8_t *op = ostart, *frame;
+	uint32_t magic, size;
+	uint8_t flg;
+	int ret = 0;
+
+	while (((size_t)(iend - ip) >= 4U) && (ret == 0)) {
+		magic = read_le32(ip);
+		ip += 4;
+
+		if ((magic & LZ4_SKIP_MAGIC_MASK) == LZ4_SKIP_MAGIC) {
+			if (((size_t)(iend - ip) < 4U) ||
+			    (read_le32(ip) > (size_t)(iend - ip - 4))) {
+				ret = -EIO;
+				break;
+			}
+			ip += 4U + read_le32(ip);
+			continue;
+		}
+
+		if (magic != LZ4_FRAME_MAGIC) {
+			ERROR("lz4: bad frame magic 0x%x\n", magic);
+			ret = -EIO;
+			break;
+		}
+
+		/* Frame descriptor */
+		desc = ip;
+		if ((size_t)(iend - ip) < 3U) {
+			ret = -EIO;
+			break;
+		}
+
+		flg = ip[0];
+		if (((flg & LZ4_FLG_VERSION_MASK) != LZ4_FLG_VERSION) ||
+		    ((flg & (LZ4_FLG_RESERVED | LZ4_FLG_DICT_ID)) != 0U) ||
+		    ((ip[1] & LZ4_BD_RESERVED) != 0U)) {
+			ERROR("lz4: unsupported frame descriptor\n");
+			ret = -EIO;
+			break;
+		}
+		ip += 2;
+
+		if ((flg & LZ4_FLG_CONTENT_SIZE) != 0U) {
+			if ((size_t)(iend - ip) < 9U) {
+				ret = -EIO;
+				break;
+			}
+			ip += 8;
+		}
+
+		if (*ip != ((xxh32(desc, ip - desc) >> 8) & 0xffU)) {
+			ERROR("lz4: frame descriptor checksum mismatch\n");
+			ret = -EIO;
+			break;
+		}
+		ip++;
+
+		/* Data blocks, up to the end mark */
+		frame = op;
+		for (;;) {
+			if ((size_t)(iend - ip) < 4U) {
+				ret = -EIO;
+				break;
+			}
+
+			size = read_le32(ip);
+			ip += 4;
+
+			if (size == 0U) {
+				break;
+			}
+
+			if (((size & ~LZ4_BLOCK_UNCOMPRESSED) >
+			     (size_t)(iend - ip)) ||
+			    (((flg & LZ4_FLG_BLOCK_CSUM) != 0U) &&
+			     ((size & ~LZ4_BLOCK_UNCOMPRESSED) + 4U >
+			      (size_t)(iend - ip)))) {
+				ret = -EIO;
+				break;
+			}
+
+			if ((size & LZ4_BLOCK_UNCOMPRESSED) != 0U) {
+				size &= ~LZ4_BLOCK_UNCOMPRESSED;
+				if (size > (size_t)(oend - op)) {
+					op = NULL;
+				} else {
+					(void)memcpy(op, ip, size);
+					op += size;
+				}
+			} else {
+				op = lz4_decode_block(ip, size, op, ostart,
+						      oend);
+			}
+
+			if (op == NULL) {
+				ERROR("lz4: corrupted block or output overflow\n");
+				ret = -EIO;
+				break;
+			}
+
+			if (((flg & LZ4_FLG_BLOCK_CSUM) != 0U) &&
+			    (read_le32(ip + size) != xxh32(ip, size))) {
+				ERROR("lz4: block checksum mismatch\n");
+				ret = -EIO;
+				break;
+			}
+
+			ip += size;
+			if ((flg & LZ4_FLG_BLOCK_CSUM) != 0U) {
+				ip += 4;
+			}
+		}
+
+		if ((ret == 0) && ((flg & LZ4_FLG_CONTENT_CSUM) != 0U)) {
+			if (((size_t)(iend - ip) < 4U) ||
+			    (read_le32(ip) != xxh32(frame, op - frame))) {
+				ERROR("lz4: content checksum mismatch\n");
+				ret = -EIO;
+			} else {
+				ip += 4;
+			}
+		}
+	}
+
+	VERBOSE("lz4: %lu byte input\n", (unsigned long)(ip - (uint8_t *)*in_buf));
+
+	if (op != NULL) {
+		VERBOSE("lz4: %lu byte output\n", (unsigned long)(op - ostart));
+		*out_buf = (uintptr_t)op;
+	}
+	*in_buf = (uintptr_t)ip;
+
+	return ret;
+}
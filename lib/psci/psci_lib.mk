@@ -34,3 +34,7 @@ endif
 ifeq (${ENABLE_PSCI_STAT}, 1)
 PSCI_LIB_SOURCES		+=	lib/psci/psci_stat.c
 endif
+
+ifeq (${ERRATA_PLAN}, 1)
+PSCI_LIB_SOURCES		+=	lib/cpus/errata_plan.c
+endif
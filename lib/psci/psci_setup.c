@@ -295,6 +295,11 @@ void psci_arch_setup(void)
 	/* Initialize the cpu_ops pointer. */
 	init_cpu_ops();
 
+#if defined(IMAGE_BL31) && ERRATA_PLAN
+	/* Record the reset errata to apply on the next warm boots */
+	errata_plan_init();
+#endif
+
 	/* Having initialized cpu_ops, we can now print errata status */
 	print_errata_status();
 
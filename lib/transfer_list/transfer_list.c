@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2023, Linaro Limited and Contributors. All rights reserved.
+ * Copyright (c) 2023-2024, Linaro Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -13,6 +13,115 @@
 #include <lib/transfer_list.h>
 #include <lib/utils_def.h>
 
+#if TRANSFER_LIST_INDEX_SIZE
+/*
+ * Index of the offsets of the entries found by transfer_list_find() in the
+ * last transfer list searched, indexed by tag id modulo the index size. It is
+ * reset when entries move, and a hit is only used if the entry at the offset
+ * still has the tag, which is not the case after transfer_list_rem().
+ */
+static struct {
+	uint32_t tag_id;
+	uint32_t offset;
+} tl_index[TRANSFER_LIST_INDEX_SIZE];
+
+static uintptr_t tl_index_base;
+
+static void tl_index_reset(uintptr_t tl_base)
+{
+	memset(tl_index, 0, sizeof(tl_index));
+	tl_index_base = tl_base;
+}
+
+static struct transfer_list_entry *
+tl_index_lookup(struct transfer_list_header *tl, uint32_t tag_id)
+{
+	struct transfer_list_entry *te;
+	unsigned int i = tag_id % TRANSFER_LIST_INDEX_SIZE;
+	uint32_t offset = tl_index[i].offset;
+	size_t sz = 0;
+
+	if (tl_index_base != (uintptr_t)tl) {
+		tl_index_reset((uintptr_t)tl);
+		return NULL;
+	}
+
+	if (offset == 0 || tl_index[i].tag_id != tag_id ||
+	    offset + sizeof(*te) > tl->size) {
+		return NULL;
+	}
+
+	te = (struct transfer_list_entry *)((uintptr_t)tl + offset);
+	if (te->tag_id != tag_id || te->hdr_size < sizeof(*te) ||
+	    add_overflow(te->hdr_size, te->data_size, &sz) ||
+	    offset + sz > tl->size) {
+		return NULL;
+	}
+
+	return te;
+}
+
+static void tl_index_insert(struct transfer_list_header *tl,
+			    struct transfer_list_entry *te)
+{
+	unsigned int i = te->tag_id % TRANSFER_LIST_INDEX_SIZE;
+
+	tl_index[i].tag_id = te->tag_id;
+	tl_index[i].offset = (uintptr_t)te - (uintptr_t)tl;
+}
+#else
+static void tl_index_reset(uintptr_t tl_base)
+{
+}
+#endif /* TRANSFER_LIST_INDEX_SIZE */
+
+static uint8_t calc_byte_sum_range(const void *addr, size_t size)
+{
+	const uint8_t *b = addr;
+	uint8_t cs = 0;
+	size_t n = 0;
+
+	for (n = 0; n < size; n++) {
+		cs += b[n];
+	}
+
+	return cs;
+}
+
+/*******************************************************************************
+ * Calculate the byte sum of a transfer list
+ * Return byte sum of the transfer list
+ ******************************************************************************/
+static uint8_t calc_byte_sum(const struct transfer_list_header *tl)
+{
+	return calc_byte_sum_range(tl, tl->size);
+}
+
+/*******************************************************************************
+ * Update the checksum of a transfer list incrementally, for a region of it
+ * which does not contain the checksum: the byte sum of the region is removed
+ * from the checksum before the region is modified, and the byte sum of the
+ * modified region is added back afterwards. This avoids summing the whole
+ * transfer list after each change, but keeps the checksum valid only if it was
+ * valid before: a caller writing to a transfer entry must call
+ * transfer_list_update_checksum() before the next update.
+ ******************************************************************************/
+static void checksum_remove(struct transfer_list_header *tl, const void *addr,
+			    size_t size)
+{
+	if (tl->flags & TL_FLAGS_HAS_CHECKSUM) {
+		tl->checksum += calc_byte_sum_range(addr, size);
+	}
+}
+
+static void checksum_add(struct transfer_list_header *tl, const void *addr,
+			 size_t size)
+{
+	if (tl->flags & TL_FLAGS_HAS_CHECKSUM) {
+		tl->checksum -= calc_byte_sum_range(addr, size);
+	}
+}
+
 void transfer_list_dump(struct transfer_list_header *tl)
 {
 	struct transfer_list_entry *te = NULL;
@@ -109,6 +218,7 @@ struct transfer_list_header *transfer_list_init(void *addr, size_t max_size)
 	tl->flags = TL_FLAGS_HAS_CHECKSUM;
 
 	transfer_list_update_checksum(tl);
+	tl_index_reset((uintptr_t)tl);
 
 	return tl;
 }
@@ -147,10 +257,12 @@ transfer_list_relocate(struct transfer_list_header *tl, void *addr,
 
 	new_tl = (struct transfer_list_header *)new_addr;
 	memmove(new_tl, tl, tl->size);
-	new_tl->max_size = new_max_size;
 
+	new_tl->max_size = new_max_size;
 	transfer_list_update_checksum(new_tl);
 
+	tl_index_reset((uintptr_t)new_tl);
+
 	return new_tl;
 }
 
@@ -255,23 +367,6 @@ struct transfer_list_entry *transfer_list_next(struct transfer_list_header *tl,
 	return te;
 }
 
-/*******************************************************************************
- * Calculate the byte sum of a transfer list
- * Return byte sum of the transfer list
- ******************************************************************************/
-static uint8_t calc_byte_sum(const struct transfer_list_header *tl)
-{
-	uint8_t *b = (uint8_t *)tl;
-	uint8_t cs = 0;
-	size_t n = 0;
-
-	for (n = 0; n < tl->size; n++) {
-		cs += b[n];
-	}
-
-	return cs;
-}
-
 /*******************************************************************************
  * Update the checksum of a transfer list
  * Return updated checksum of the transfer list
@@ -308,6 +403,49 @@ bool transfer_list_verify_checksum(const struct transfer_list_header *tl)
 	return !calc_byte_sum(tl);
 }
 
+/*******************************************************************************
+ * Grow a transfer entry into the empty transfer entry following it, if any,
+ * such as a removed entry or alignment padding, so that the following entries
+ * do not need to be moved.
+ * Return true on success or false if there is not enough room
+ ******************************************************************************/
+static bool grow_into_next_empty(struct transfer_list_header *tl,
+				 struct transfer_list_entry *te,
+				 uintptr_t old_ev, uintptr_t new_ev)
+{
+	struct transfer_list_entry *empty_te = transfer_list_next(tl, te);
+	struct transfer_list_entry *dummy_te = NULL;
+	uintptr_t empty_ev = 0;
+	size_t sz = 0;
+	size_t gap = 0;
+
+	if (!empty_te || empty_te->tag_id != TL_TAG_EMPTY ||
+	    add_overflow(empty_te->hdr_size, empty_te->data_size, &sz) ||
+	    add_with_round_up_overflow(old_ev, sz, TRANSFER_LIST_GRANULE,
+				       &empty_ev) ||
+	    new_ev > empty_ev) {
+		return false;
+	}
+
+	/* the remainder of the empty TE keeps its header at the new end */
+	gap = empty_ev - new_ev;
+	sz = MIN((uintptr_t)(new_ev + sizeof(*dummy_te)), empty_ev) - old_ev;
+
+	checksum_remove(tl, (void *)old_ev, sz);
+	if (gap >= sizeof(*dummy_te)) {
+		dummy_te = (struct transfer_list_entry *)new_ev;
+		dummy_te->tag_id = TL_TAG_EMPTY;
+		dummy_te->hdr_size = sizeof(*dummy_te);
+		dummy_te->data_size = gap - sizeof(*dummy_te);
+	}
+	checksum_add(tl, (void *)old_ev, sz);
+
+	/* an entry removed before may be overwritten by the grown entry */
+	tl_index_reset((uintptr_t)tl);
+
+	return true;
+}
+
 /*******************************************************************************
  * Update the data size of a transfer entry
  * Return true on success or false on error
@@ -325,6 +463,7 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 	if (!tl || !te) {
 		return false;
 	}
+	assert(transfer_list_verify_checksum(tl));
 	tl_old_ev = (uintptr_t)tl + tl->size;
 
 	/*
@@ -342,7 +481,9 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 		return false;
 	}
 
-	if (new_ev > old_ev) {
+	if (new_ev > old_ev && grow_into_next_empty(tl, te, old_ev, new_ev)) {
+		gap = 0;
+	} else if (new_ev > old_ev) {
 		/*
 		 * move distance should be roundup
 		 * to meet the requirement of TE data max alignment
@@ -355,8 +496,17 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 			return false;
 		}
 		ru_new_ev = old_ev + mov_dis;
+
+		/* the moved entries are summed again at their new place */
+		checksum_remove(tl, (void *)old_ev, tl_old_ev - old_ev);
 		memmove((void *)ru_new_ev, (void *)old_ev, tl_old_ev - old_ev);
+		if (tl_old_ev > old_ev) {
+			tl_index_reset((uintptr_t)tl);
+		}
+
+		checksum_remove(tl, &tl->size, sizeof(tl->size));
 		tl->size += mov_dis;
+		checksum_add(tl, &tl->size, sizeof(tl->size));
 		gap = ru_new_ev - new_ev;
 	} else {
 		gap = old_ev - new_ev;
@@ -365,14 +515,25 @@ bool transfer_list_set_data_size(struct transfer_list_header *tl,
 	if (gap >= sizeof(*dummy_te)) {
 		/* create a dummy TE to fill up the gap */
 		dummy_te = (struct transfer_list_entry *)new_ev;
+		if (!mov_dis) {
+			checksum_remove(tl, dummy_te, sizeof(*dummy_te));
+		}
 		dummy_te->tag_id = TL_TAG_EMPTY;
 		dummy_te->hdr_size = sizeof(*dummy_te);
 		dummy_te->data_size = gap - sizeof(*dummy_te);
+		if (!mov_dis) {
+			checksum_add(tl, dummy_te, sizeof(*dummy_te));
+		}
+	}
+
+	if (mov_dis) {
+		checksum_add(tl, (void *)old_ev, tl_old_ev + mov_dis - old_ev);
 	}
 
+	checksum_remove(tl, te, sizeof(*te));
 	te->data_size = new_data_size;
+	checksum_add(tl, te, sizeof(*te));
 
-	transfer_list_update_checksum(tl);
 	return true;
 }
 
@@ -386,8 +547,10 @@ bool transfer_list_rem(struct transfer_list_header *tl,
 	if (!tl || !te || (uintptr_t)te > (uintptr_t)tl + tl->size) {
 		return false;
 	}
+	assert(transfer_list_verify_checksum(tl));
+	checksum_remove(tl, te, sizeof(*te));
 	te->tag_id = TL_TAG_EMPTY;
-	transfer_list_update_checksum(tl);
+	checksum_add(tl, te, sizeof(*te));
 	return true;
 }
 
@@ -409,6 +572,7 @@ struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
 	if (!tl) {
 		return NULL;
 	}
+	assert(transfer_list_verify_checksum(tl));
 
 	max_tl_ev = (uintptr_t)tl + tl->max_size;
 	tl_ev = (uintptr_t)tl + tl->size;
@@ -428,18 +592,19 @@ struct transfer_list_entry *transfer_list_add(struct transfer_list_header *tl,
 	te->tag_id = tag_id;
 	te->hdr_size = sizeof(*te);
 	te->data_size = data_size;
+
+	checksum_remove(tl, &tl->size, sizeof(tl->size));
 	tl->size += ev - tl_ev;
+	checksum_add(tl, &tl->size, sizeof(tl->size));
 
 	if (data) {
 		/* get TE data pointer */
 		te_data = transfer_list_entry_data(te);
-		if (!te_data) {
-			return NULL;
-		}
 		memmove(te_data, data, data_size);
 	}
 
-	transfer_list_update_checksum(tl);
+	/* only the new TE is added to the byte sum */
+	checksum_add(tl, te, ev - tl_ev);
 
 	return te;
 }
@@ -462,6 +627,7 @@ transfer_list_add_with_align(struct transfer_list_header *tl, uint32_t tag_id,
 	if (!tl) {
 		return NULL;
 	}
+	assert(transfer_list_verify_checksum(tl));
 
 	tl_ev = (uintptr_t)tl + tl->size;
 	ev = tl_ev + sizeof(struct transfer_list_entry);
@@ -485,8 +651,9 @@ transfer_list_add_with_align(struct transfer_list_header *tl, uint32_t tag_id,
 	te = transfer_list_add(tl, tag_id, data_size, data);
 
 	if (alignment > tl->alignment) {
+		checksum_remove(tl, &tl->alignment, sizeof(tl->alignment));
 		tl->alignment = alignment;
-		transfer_list_update_checksum(tl);
+		checksum_add(tl, &tl->alignment, sizeof(tl->alignment));
 	}
 
 	return te;
@@ -502,10 +669,25 @@ struct transfer_list_entry *transfer_list_find(struct transfer_list_header *tl,
 {
 	struct transfer_list_entry *te = NULL;
 
+#if TRANSFER_LIST_INDEX_SIZE
+	if (tl && tag_id != TL_TAG_EMPTY) {
+		te = tl_index_lookup(tl, tag_id);
+		if (te) {
+			return te;
+		}
+	}
+#endif
+
 	do {
 		te = transfer_list_next(tl, te);
 	} while (te && (te->tag_id != tag_id));
 
+#if TRANSFER_LIST_INDEX_SIZE
+	if (te && tag_id != TL_TAG_EMPTY) {
+		tl_index_insert(tl, te);
+	}
+#endif
+
 	return te;
 }
 
@@ -90,6 +90,16 @@ int mmap_remove_dynamic_region(uintptr_t base_va, size_t size)
 					base_va, size);
 }
 
+void mmap_begin_dynamic_batch(void)
+{
+	mmap_begin_dynamic_batch_ctx(&tf_xlat_ctx);
+}
+
+void mmap_commit_dynamic_batch(void)
+{
+	mmap_commit_dynamic_batch_ctx(&tf_xlat_ctx);
+}
+
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
 void __init init_xlat_tables(void)
@@ -55,12 +55,29 @@ static int xlat_table_get_index(const xlat_ctx_t *ctx, const uint64_t *table)
 	return -1;
 }
 
+/* Completes the TLB invalidations deferred by the current batch, if any. */
+static void xlat_batch_tlbi_sync(xlat_ctx_t *ctx)
+{
+	if (ctx->batch.tlbi_pending) {
+		xlat_arch_tlbi_va_sync();
+		ctx->batch.tlbi_pending = false;
+	}
+}
+
 /* Returns a pointer to an empty translation table. */
-static uint64_t *xlat_table_get_empty(const xlat_ctx_t *ctx)
+static uint64_t *xlat_table_get_empty(xlat_ctx_t *ctx)
 {
-	for (int i = 0; i < ctx->tables_num; i++)
-		if (ctx->tables_mapped_regions[i] == 0)
+	for (int i = 0; i < ctx->tables_num; i++) {
+		if (ctx->tables_mapped_regions[i] == 0) {
+			/*
+			 * The table may have been released by an unmap
+			 * operation of the current batch. Make sure that the
+			 * TLB entries pointing to it are gone before reusing it.
+			 */
+			xlat_batch_tlbi_sync(ctx);
 			return ctx->tables[i];
+		}
+	}
 
 	return NULL;
 }
@@ -561,6 +578,42 @@ static action_t xlat_tables_map_region_action(const mmap_region_t *mm,
 	}
 }
 
+#if XLAT_TABLES_CONTIG_HINT
+/*
+ * Returns true if the run of XLAT_CONTIG_ENTRIES descriptors starting at
+ * 'table_idx' can be written with the Contiguous bit set. This is the case if
+ * the run is fully covered by the region, its VA and PA are aligned to the size
+ * of the run and all of its descriptors are currently invalid. Because the run
+ * doesn't go beyond the region, it is unmapped in one go when the region is
+ * removed, and it never needs to be broken up for that.
+ */
+static bool xlat_tables_contig_run_allowed(const mmap_region_t *mm,
+		const uint64_t *table_base, unsigned int table_entries,
+		unsigned int table_idx, uintptr_t table_idx_va,
+		unsigned long long table_idx_pa, unsigned int level)
+{
+	uintptr_t mm_end_va = mm->base_va + mm->size - 1U;
+	uintptr_t run_end_va = table_idx_va + XLAT_CONTIG_SIZE(level) - 1U;
+
+	if ((table_idx + XLAT_CONTIG_ENTRIES) > table_entries)
+		return false;
+
+	if (((table_idx_va & (XLAT_CONTIG_SIZE(level) - 1U)) != 0U) ||
+	    ((table_idx_pa & (XLAT_CONTIG_SIZE(level) - 1U)) != 0U))
+		return false;
+
+	if ((mm->base_va > table_idx_va) || (mm_end_va < run_end_va))
+		return false;
+
+	for (unsigned int i = 0U; i < XLAT_CONTIG_ENTRIES; i++) {
+		if ((table_base[table_idx + i] & DESC_MASK) != INVALID_DESC)
+			return false;
+	}
+
+	return true;
+}
+#endif /* XLAT_TABLES_CONTIG_HINT */
+
 /*
  * Recursive function that writes to the translation tables and maps the
  * specified region. On success, it returns the VA of the last byte that was
@@ -584,6 +637,10 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 	uint64_t desc;
 
 	unsigned int table_idx;
+#if XLAT_TABLES_CONTIG_HINT
+	/* End index of the current run of contiguous descriptors, if any. */
+	unsigned int contig_end_idx = 0U;
+#endif
 
 	table_idx_va = xlat_tables_find_start_va(mm, table_base_va, level);
 	table_idx = xlat_tables_va_to_index(table_base_va, table_idx_va, level);
@@ -605,9 +662,26 @@ static uintptr_t xlat_tables_map_region(xlat_ctx_t *ctx, mmap_region_t *mm,
 
 		if (action == ACTION_WRITE_BLOCK_ENTRY) {
 
-			table_base[table_idx] =
-				xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
-					  level);
+			desc = xlat_desc(ctx, (uint32_t)mm->attr, table_idx_pa,
+					 level);
+#if XLAT_TABLES_CONTIG_HINT
+			/*
+			 * Decide whether a new run of contiguous descriptors
+			 * starts here before writing any of its entries, so
+			 * that valid descriptors never need to be updated.
+			 */
+			if ((table_idx >= contig_end_idx) &&
+			    xlat_tables_contig_run_allowed(mm, table_base,
+					table_entries, table_idx, table_idx_va,
+					table_idx_pa, level)) {
+				contig_end_idx = table_idx +
+						 XLAT_CONTIG_ENTRIES;
+			}
+
+			if (table_idx < contig_end_idx)
+				desc |= UPPER_ATTRS(CONT_HINT);
+#endif
+			table_base[table_idx] = desc;
 
 		} else if (action == ACTION_CREATE_NEW_TABLE) {
 			uintptr_t end_va;
@@ -949,6 +1023,76 @@ void mmap_add_ctx(xlat_ctx_t *ctx, const mmap_region_t *mm)
 
 #if PLAT_XLAT_TABLES_DYNAMIC
 
+/*
+ * Returns true if region 'a' must be placed before region 'b' in the mmap
+ * array. This is the order used by mmap_add_region_ctx() when inserting new
+ * regions: lower region VA end first, then smaller region size first.
+ */
+static bool mmap_region_precedes(const mmap_region_t *a, const mmap_region_t *b)
+{
+	uintptr_t a_end_va = a->base_va + a->size - 1U;
+	uintptr_t b_end_va = b->base_va + b->size - 1U;
+
+	if (a_end_va != b_end_va)
+		return a_end_va < b_end_va;
+
+	return a->size < b->size;
+}
+
+/*
+ * Sorts the mmap array after a batch of dynamic mapping operations appended
+ * regions to it or moved some of them around.
+ */
+static void mmap_sort_regions(xlat_ctx_t *ctx)
+{
+	mmap_region_t *mm = ctx->mmap;
+
+	if (mm[0].size == 0U)
+		return;
+
+	for (unsigned int i = 1U; mm[i].size != 0U; i++) {
+		mmap_region_t tmp = mm[i];
+		unsigned int j = i;
+
+		while ((j > 0U) && mmap_region_precedes(&tmp, &mm[j - 1U])) {
+			mm[j] = mm[j - 1U];
+			j--;
+		}
+
+		mm[j] = tmp;
+	}
+}
+
+/*
+ * Recomputes the max VA and/or PA in use by the context after some regions
+ * have been removed from it.
+ */
+static void mmap_update_max_va_pa(xlat_ctx_t *ctx, bool update_va,
+				  bool update_pa)
+{
+	const mmap_region_t *mm;
+
+	if (update_va) {
+		ctx->max_va = 0U;
+		mm = ctx->mmap;
+		while (mm->size != 0U) {
+			if ((mm->base_va + mm->size - 1U) > ctx->max_va)
+				ctx->max_va = mm->base_va + mm->size - 1U;
+			++mm;
+		}
+	}
+
+	if (update_pa) {
+		ctx->max_pa = 0U;
+		mm = ctx->mmap;
+		while (mm->size != 0U) {
+			if ((mm->base_pa + mm->size - 1U) > ctx->max_pa)
+				ctx->max_pa = mm->base_pa + mm->size - 1U;
+			++mm;
+		}
+	}
+}
+
 int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 {
 	mmap_region_t *mm_cursor = ctx->mmap;
@@ -968,24 +1112,49 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 	if (ret != 0)
 		return ret;
 
-	/*
-	 * Find the adequate entry in the mmap array in the same way done for
-	 * static regions in mmap_add_region_ctx().
-	 */
+	if (ctx->batch.active) {
+		/*
+		 * Append the region to the mmap array. It is sorted once when
+		 * the batch is committed.
+		 */
+		while (mm_cursor->size != 0U) {
+			++mm_cursor;
+		}
 
-	while (((mm_cursor->base_va + mm_cursor->size - 1U) < end_va)
-	       && (mm_cursor->size != 0U)) {
-		++mm_cursor;
-	}
+		ctx->batch.unsorted = true;
 
-	while (((mm_cursor->base_va + mm_cursor->size - 1U) == end_va) &&
-	       (mm_cursor->size != 0U) && (mm_cursor->size < mm->size)) {
-		++mm_cursor;
-	}
+		/*
+		 * Break-before-make: the TLB invalidation of any VA removed
+		 * earlier in the batch must complete before it is mapped again.
+		 */
+		if ((mm->base_va <= ctx->batch.unmap_end_va) &&
+		    (end_va >= ctx->batch.unmap_start_va)) {
+			xlat_batch_tlbi_sync(ctx);
+		}
+	} else {
+		/*
+		 * Find the adequate entry in the mmap array in the same way
+		 * done for static regions in mmap_add_region_ctx().
+		 */
 
-	/* Make room for new region by moving other regions up by one place */
-	(void)memmove(mm_cursor + 1U, mm_cursor,
-		     (uintptr_t)mm_last - (uintptr_t)mm_cursor);
+		while (((mm_cursor->base_va + mm_cursor->size - 1U) < end_va)
+		       && (mm_cursor->size != 0U)) {
+			++mm_cursor;
+		}
+
+		while (((mm_cursor->base_va + mm_cursor->size - 1U) == end_va)
+		       && (mm_cursor->size != 0U) &&
+		       (mm_cursor->size < mm->size)) {
+			++mm_cursor;
+		}
+
+		/*
+		 * Make room for new region by moving other regions up by one
+		 * place.
+		 */
+		(void)memmove(mm_cursor + 1U, mm_cursor,
+			     (uintptr_t)mm_last - (uintptr_t)mm_cursor);
+	}
 
 	/*
 	 * Check we haven't lost the empty sentinel from the end of the array.
@@ -1005,8 +1174,12 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 				0U, ctx->base_table, ctx->base_table_entries,
 				ctx->base_level);
 #if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
-		xlat_clean_dcache_range((uintptr_t)ctx->base_table,
-				   ctx->base_table_entries * sizeof(uint64_t));
+		if (ctx->batch.active) {
+			ctx->batch.clean_pending = true;
+		} else {
+			xlat_clean_dcache_range((uintptr_t)ctx->base_table,
+				ctx->base_table_entries * sizeof(uint64_t));
+		}
 #endif
 		/* Failed to map, remove mmap entry, unmap and return error. */
 		if (end_va != (mm_cursor->base_va + mm_cursor->size - 1U)) {
@@ -1044,9 +1217,12 @@ int mmap_add_dynamic_region_ctx(xlat_ctx_t *ctx, mmap_region_t *mm)
 		 * Make sure that all entries are written to the memory. There
 		 * is no need to invalidate entries when mapping dynamic regions
 		 * because new table/block/page descriptors only replace old
-		 * invalid descriptors, that aren't TLB cached.
+		 * invalid descriptors, that aren't TLB cached. In a batch, this
+		 * is done once when committing it.
 		 */
-		dsbishst();
+		if (!ctx->batch.active) {
+			dsbishst();
+		}
 	}
 
 	if (end_pa > ctx->max_pa)
@@ -1087,9 +1263,9 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size)
 {
 	mmap_region_t *mm = ctx->mmap;
-	const mmap_region_t *mm_last = mm + ctx->mmap_num;
-	int update_max_va_needed = 0;
-	int update_max_pa_needed = 0;
+	mmap_region_t *mm_last = mm + ctx->mmap_num;
+	bool update_max_va_needed = false;
+	bool update_max_pa_needed = false;
 
 	/* Check sanity of mmap array. */
 	assert(mm[ctx->mmap_num].size == 0U);
@@ -1110,9 +1286,9 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 
 	/* Check if this region is using the top VAs or PAs. */
 	if ((mm->base_va + mm->size - 1U) == ctx->max_va)
-		update_max_va_needed = 1;
+		update_max_va_needed = true;
 	if ((mm->base_pa + mm->size - 1U) == ctx->max_pa)
-		update_max_pa_needed = 1;
+		update_max_pa_needed = true;
 
 	/* Update the translation tables if needed */
 	if (ctx->initialized) {
@@ -1120,37 +1296,101 @@ int mmap_remove_dynamic_region_ctx(xlat_ctx_t *ctx, uintptr_t base_va,
 					 ctx->base_table_entries,
 					 ctx->base_level);
 #if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
-		xlat_clean_dcache_range((uintptr_t)ctx->base_table,
-			ctx->base_table_entries * sizeof(uint64_t));
+		if (ctx->batch.active) {
+			ctx->batch.clean_pending = true;
+		} else {
+			xlat_clean_dcache_range((uintptr_t)ctx->base_table,
+				ctx->base_table_entries * sizeof(uint64_t));
+		}
 #endif
-		xlat_arch_tlbi_va_sync();
+		if (ctx->batch.active) {
+			/* Defer the TLB invalidation sync to the commit. */
+			if (!ctx->batch.tlbi_pending) {
+				ctx->batch.unmap_start_va = mm->base_va;
+				ctx->batch.unmap_end_va = mm->base_va +
+							  mm->size - 1U;
+				ctx->batch.tlbi_pending = true;
+			} else {
+				ctx->batch.unmap_start_va =
+					MIN(ctx->batch.unmap_start_va,
+					    mm->base_va);
+				ctx->batch.unmap_end_va =
+					MAX(ctx->batch.unmap_end_va,
+					    mm->base_va + mm->size - 1U);
+			}
+		} else {
+			xlat_arch_tlbi_va_sync();
+		}
+	}
+
+	if (ctx->batch.active) {
+		/*
+		 * Fill the hole with the last region of the array instead of
+		 * moving all the following regions down. The array is sorted
+		 * again when the batch is committed.
+		 */
+		mm_last = mm;
+		while ((mm_last + 1)->size != 0U) {
+			++mm_last;
+		}
+
+		*mm = *mm_last;
+		(void)memset(mm_last, 0, sizeof(*mm_last));
+
+		ctx->batch.unsorted = true;
+		ctx->batch.update_max_va |= update_max_va_needed;
+		ctx->batch.update_max_pa |= update_max_pa_needed;
+
+		return 0;
 	}
 
 	/* Remove this region by moving the rest down by one place. */
 	(void)memmove(mm, mm + 1U, (uintptr_t)mm_last - (uintptr_t)mm);
 
 	/* Check if we need to update the max VAs and PAs */
-	if (update_max_va_needed == 1) {
-		ctx->max_va = 0U;
-		mm = ctx->mmap;
-		while (mm->size != 0U) {
-			if ((mm->base_va + mm->size - 1U) > ctx->max_va)
-				ctx->max_va = mm->base_va + mm->size - 1U;
-			++mm;
-		}
+	mmap_update_max_va_pa(ctx, update_max_va_needed,
+			      update_max_pa_needed);
+
+	return 0;
+}
+
+void mmap_begin_dynamic_batch_ctx(xlat_ctx_t *ctx)
+{
+	/* Batches can't be nested. */
+	assert(!ctx->batch.active);
+
+	(void)memset(&ctx->batch, 0, sizeof(ctx->batch));
+	ctx->batch.active = true;
+}
+
+void mmap_commit_dynamic_batch_ctx(xlat_ctx_t *ctx)
+{
+	assert(ctx->batch.active);
+
+#if !(HW_ASSISTED_COHERENCY || WARMBOOT_ENABLE_DCACHE_EARLY)
+	if (ctx->batch.clean_pending) {
+		xlat_clean_dcache_range((uintptr_t)ctx->base_table,
+			ctx->base_table_entries * sizeof(uint64_t));
 	}
+#endif
 
-	if (update_max_pa_needed == 1) {
-		ctx->max_pa = 0U;
-		mm = ctx->mmap;
-		while (mm->size != 0U) {
-			if ((mm->base_pa + mm->size - 1U) > ctx->max_pa)
-				ctx->max_pa = mm->base_pa + mm->size - 1U;
-			++mm;
-		}
+	/*
+	 * Make sure that all entries written by the batch have reached memory
+	 * and that all the TLB invalidations it issued have completed.
+	 */
+	if (ctx->initialized) {
+		dsbishst();
 	}
+	xlat_batch_tlbi_sync(ctx);
 
-	return 0;
+	if (ctx->batch.unsorted) {
+		mmap_sort_regions(ctx);
+	}
+
+	mmap_update_max_va_pa(ctx, ctx->batch.update_max_va,
+			      ctx->batch.update_max_pa);
+
+	ctx->batch.active = false;
 }
 
 void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
@@ -1181,6 +1421,8 @@ void xlat_setup_dynamic_ctx(xlat_ctx_t *ctx, unsigned long long pa_max,
 	ctx->max_pa = 0;
 	ctx->max_va = 0;
 	ctx->initialized = 0;
+
+	(void)memset(&ctx->batch, 0, sizeof(ctx->batch));
 }
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
@@ -1193,6 +1435,9 @@ void __init init_xlat_tables_ctx(xlat_ctx_t *ctx)
 	       (ctx->xlat_regime == EL2_REGIME) ||
 	       (ctx->xlat_regime == EL1_EL0_REGIME));
 	assert(!is_mmu_enabled_ctx(ctx));
+#if PLAT_XLAT_TABLES_DYNAMIC
+	assert(!ctx->batch.active);
+#endif
 
 	mmap_region_t *mm = ctx->mmap;
 
@@ -38,6 +38,17 @@
 
 #endif /* PLAT_XLAT_TABLES_DYNAMIC */
 
+#if XLAT_TABLES_CONTIG_HINT
+/*
+ * Number of adjacent block or page descriptors that can be grouped with the
+ * Contiguous bit with the 4KB translation granule, and size of the VA range
+ * covered by such a run at the given level.
+ */
+#define XLAT_CONTIG_ENTRIES		U(16)
+#define XLAT_CONTIG_SIZE(level)		\
+	(XLAT_CONTIG_ENTRIES * XLAT_BLOCK_SIZE(level))
+#endif /* XLAT_TABLES_CONTIG_HINT */
+
 extern uint64_t mmu_cfg_params[MMU_CFG_PARAM_MAX];
 
 /* Determine the physical address space encoded in the 'attr' parameter. */
@@ -120,6 +120,12 @@ static void xlat_desc_print(const xlat_ctx_t *ctx, uint64_t desc)
 		printf("-GP");
 	}
 #endif
+
+#if XLAT_TABLES_CONTIG_HINT
+	if ((desc & UPPER_ATTRS(CONT_HINT)) != 0ULL) {
+		printf("-CONT");
+	}
+#endif
 }
 
 static const char * const level_spacers[] = {
@@ -444,6 +450,105 @@ int xlat_get_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 }
 
 
+#if XLAT_TABLES_CONTIG_HINT
+/*
+ * Replace the XLAT_CONTIG_ENTRIES page descriptors starting at 'run' with the
+ * ones in 'descs', following a break-before-make sequence for all of them.
+ */
+static void xlat_contig_run_write(const xlat_ctx_t *ctx, uint64_t *run,
+				  uintptr_t run_va, const uint64_t *descs)
+{
+	for (unsigned int i = 0U; i < XLAT_CONTIG_ENTRIES; i++) {
+		run[i] = INVALID_DESC;
+	}
+#if !HW_ASSISTED_COHERENCY
+	clean_dcache_range((uintptr_t)run, XLAT_CONTIG_ENTRIES * sizeof(uint64_t));
+#endif
+	for (unsigned int i = 0U; i < XLAT_CONTIG_ENTRIES; i++) {
+		xlat_arch_tlbi_va(run_va + (i * PAGE_SIZE), ctx->xlat_regime);
+	}
+	xlat_arch_tlbi_va_sync();
+
+	for (unsigned int i = 0U; i < XLAT_CONTIG_ENTRIES; i++) {
+		run[i] = descs[i];
+	}
+#if !HW_ASSISTED_COHERENCY
+	clean_dcache_range((uintptr_t)run, XLAT_CONTIG_ENTRIES * sizeof(uint64_t));
+#endif
+}
+
+/*
+ * Clear the Contiguous bit of the run of page descriptors that contains the
+ * given entry, so that the attributes of some of its pages can be changed.
+ */
+static void xlat_contig_run_split(const xlat_ctx_t *ctx, uint64_t *entry,
+				  uintptr_t va)
+{
+	unsigned int offset = (unsigned int)((va >> PAGE_SIZE_SHIFT) %
+					     XLAT_CONTIG_ENTRIES);
+	uint64_t *run = entry - offset;
+	uint64_t descs[XLAT_CONTIG_ENTRIES];
+
+	for (unsigned int i = 0U; i < XLAT_CONTIG_ENTRIES; i++) {
+		descs[i] = run[i] & ~UPPER_ATTRS(CONT_HINT);
+	}
+
+	xlat_contig_run_write(ctx, run, va - (offset * PAGE_SIZE), descs);
+}
+
+/*
+ * Set the Contiguous bit again on the run of page descriptors starting at
+ * 'run_va' if, after an attribute change, all of its pages share the same
+ * attributes again. The run must be fully covered by a single mmap region so
+ * that it is never partially unmapped.
+ */
+static void xlat_contig_run_merge(const xlat_ctx_t *ctx, uintptr_t run_va,
+				  unsigned long long virt_addr_space_size)
+{
+	uintptr_t run_end_va = run_va + XLAT_CONTIG_SIZE(XLAT_TABLE_LEVEL_MAX)
+				- 1U;
+	const mmap_region_t *mm;
+	uint64_t descs[XLAT_CONTIG_ENTRIES];
+	uint64_t *run;
+	unsigned int level;
+
+	for (mm = ctx->mmap; mm->size != 0U; mm++) {
+		if ((mm->base_va <= run_va) &&
+		    ((mm->base_va + mm->size - 1U) >= run_end_va)) {
+			break;
+		}
+	}
+
+	if (mm->size == 0U) {
+		return;
+	}
+
+	run = find_xlat_table_entry(run_va, ctx->base_table,
+				    ctx->base_table_entries,
+				    virt_addr_space_size, &level);
+	if ((run == NULL) || (level != XLAT_TABLE_LEVEL_MAX) ||
+	    ((run[0] & TABLE_ADDR_MASK) &
+	     (XLAT_CONTIG_SIZE(XLAT_TABLE_LEVEL_MAX) - 1U)) != 0U) {
+		return;
+	}
+
+	for (unsigned int i = 0U; i < XLAT_CONTIG_ENTRIES; i++) {
+		if (((run[i] & DESC_MASK) != PAGE_DESC) ||
+		    ((run[i] & UPPER_ATTRS(CONT_HINT)) != 0U) ||
+		    ((run[i] & ~TABLE_ADDR_MASK) !=
+		     (run[0] & ~TABLE_ADDR_MASK)) ||
+		    ((run[i] & TABLE_ADDR_MASK) !=
+		     ((run[0] & TABLE_ADDR_MASK) + (i * PAGE_SIZE)))) {
+			return;
+		}
+
+		descs[i] = run[i] | UPPER_ATTRS(CONT_HINT);
+	}
+
+	xlat_contig_run_write(ctx, run, run_va, descs);
+}
+#endif /* XLAT_TABLES_CONTIG_HINT */
+
 int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 				   size_t size, uint32_t attr)
 {
@@ -547,6 +652,16 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		(void) xlat_get_mem_attributes_internal(ctx, base_va, &old_attr,
 					    &entry, &addr_pa, &level);
 
+#if XLAT_TABLES_CONTIG_HINT
+		/*
+		 * All the descriptors of a contiguous run must have the same
+		 * attributes. Break the run up before changing this page.
+		 */
+		if ((*entry & UPPER_ATTRS(CONT_HINT)) != 0U) {
+			xlat_contig_run_split(ctx, entry, base_va);
+		}
+#endif
+
 		/*
 		 * From attr, only MT_RO/MT_RW, MT_EXECUTE/MT_EXECUTE_NEVER and
 		 * MT_USER/MT_PRIVILEGED are taken into account. Any other
@@ -585,6 +700,16 @@ int xlat_change_mem_attributes_ctx(const xlat_ctx_t *ctx, uintptr_t base_va,
 		base_va += PAGE_SIZE;
 	}
 
+#if XLAT_TABLES_CONTIG_HINT
+	/* Rebuild the contiguous runs covering the updated pages, if possible. */
+	for (uintptr_t run_va = round_down(base_va_original,
+				XLAT_CONTIG_SIZE(XLAT_TABLE_LEVEL_MAX));
+	     run_va < base_va;
+	     run_va += XLAT_CONTIG_SIZE(XLAT_TABLE_LEVEL_MAX)) {
+		xlat_contig_run_merge(ctx, run_va, virt_addr_space_size);
+	}
+#endif
+
 	/* Ensure that the last descriptor written is seen by the system. */
 	dsbish();
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2018-2024, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include <common/debug.h>
+#include <common/image_decompress.h>
 #include <common/tf_crc32.h>
 #include <lib/utils.h>
 #include <tf_gunzip.h>
@@ -102,6 +103,87 @@ int gunzip(uintptr_t *in_buf, size_t in_len, uintptr_t *out_buf,
 	return ret;
 }
 
+/*
+ * gunzip_stream - decompress gzip data read in chunks
+ * @read: callback reading the next chunk of compressed input
+ * @ctx: context passed to @read
+ * @in_buf: buffer receiving the chunks of compressed input
+ * @in_len: length of in_buf
+ * @out_buf: destination of decompressed output. Upon exit, the end of output.
+ * @out_len: length of out_buf
+ * @work_buf: workspace
+ * @work_len: length of workspace
+ * @work_used: upon exit, length of workspace actually used
+ */
+int gunzip_stream(decompressor_read_t *read, void *ctx,
+		  uintptr_t in_buf, size_t in_len,
+		  uintptr_t *out_buf, size_t out_len,
+		  uintptr_t work_buf, size_t work_len, size_t *work_used)
+{
+	z_stream stream;
+	size_t len;
+	int zret, ret;
+
+	zalloc_start = work_buf;
+	zalloc_end = work_buf + work_len;
+	zalloc_current = zalloc_start;
+
+	stream.next_in = Z_NULL;
+	stream.avail_in = 0U;
+	stream.next_out = (typeof(stream.next_out))*out_buf;
+	stream.avail_out = out_len;
+	stream.zalloc = zcalloc;
+	stream.zfree = zfree;
+	stream.opaque = (voidpf)0;
+
+	zret = inflateInit(&stream);
+	if (zret != Z_OK) {
+		ERROR("zlib: inflate init failed (ret = %d)\n", zret);
+		return (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+
+	do {
+		/* Refill the input buffer once inflate() has consumed it */
+		if (stream.avail_in == 0U) {
+			ret = read(ctx, in_buf, in_len, &len);
+			if (ret != 0) {
+				goto exit;
+			}
+
+			if (len == 0U) {
+				ERROR("zlib: truncated input\n");
+				ret = -EIO;
+				goto exit;
+			}
+
+			stream.next_in = (typeof(stream.next_in))in_buf;
+			stream.avail_in = len;
+		}
+
+		zret = inflate(&stream, Z_NO_FLUSH);
+	} while (zret == Z_OK);
+
+	if (zret == Z_STREAM_END) {
+		ret = 0;
+	} else {
+		if (stream.msg)
+			ERROR("%s\n", stream.msg);
+		ERROR("zlib: inflate failed (ret = %d)\n", zret);
+		ret = (zret == Z_MEM_ERROR) ? -ENOMEM : -EIO;
+	}
+
+exit:
+	VERBOSE("zlib: %lu byte input\n", stream.total_in);
+	VERBOSE("zlib: %lu byte output\n", stream.total_out);
+
+	*out_buf = (uintptr_t)stream.next_out;
+	*work_used = zalloc_current - zalloc_start;
+
+	inflateEnd(&stream);
+
+	return ret;
+}
+
 /* Wrapper function to calculate CRC
  * @crc: previous accumulated CRC
  * @buf: buffer base address
@@ -289,6 +289,15 @@ endef
 
 GZIP_SUFFIX := .gz
 
+# LZ4
+define LZ4_RULE
+$(1): $(2)
+	$(ECHO) "  LZ4     $$@"
+	$(Q)lz4 -9 -f -c $$< > $$@
+endef
+
+LZ4_SUFFIX := .lz4
+
 ################################################################################
 # Auxiliary macros to build TF images from sources
 ################################################################################
@@ -658,6 +667,17 @@ $(DOBJ): $(DPRE) $(filter-out %.d,$(MAKEFILE_LIST)) | fdt_dirs
 
 endef
 
+# MAKE_FCONF_BLOB compiles a configuration DTB into an fconf blob
+#   $(1) = output blob file
+#   $(2) = input DTB file
+define MAKE_FCONF_BLOB
+
+$(1): $(2) $(FCONFTOOL) | fdt_dirs
+	$${ECHO} "  FCONF   $$<"
+	$$(Q)$$(PYTHON) $$(FCONFTOOL) -o $$@ $$<
+
+endef
+
 # MAKE_DTBS builds flattened device tree sources
 #   $(1) = output directory
 #   $(2) = list of flattened device tree source files
@@ -63,6 +63,9 @@ CTX_INCLUDE_AARCH32_REGS	:= 1
 # Include FP registers in cpu context
 CTX_INCLUDE_FPREGS		:= 0
 
+# Only save the FP registers of a world when another world first uses them
+CTX_FPREGS_LAZY			:= 0
+
 # Debug build
 DEBUG				:= 0
 
@@ -124,6 +127,12 @@ FAULT_INJECTION_SUPPORT		:= 0
 # Flag to enable architectural features detection mechanism
 FEATURE_DETECTION		:= 0
 
+# Flag to pass compiled firmware configuration blobs instead of DTBs
+FCONF_BLOB			:= 0
+
+# Flag to let the FDT wrappers use an offset index of large device trees
+FDT_INDEX			:= 0
+
 # Byte alignment that each component in FIP is aligned to
 FIP_ALIGN			:= 0
 
@@ -241,12 +250,24 @@ SPD				:= none
 # Enable the Management Mode (MM)-based Secure Partition Manager implementation
 SPM_MM				:= 0
 
+# Number of execution contexts of the SPM-MM Secure Partition. Values above 1
+# require a reentrant partition.
+SPM_MM_SP_CONTEXTS		:= 1
+
+# Return SPM_MM_BUSY from MM_COMMUNICATE instead of waiting for the SPM-MM
+# Secure Partition when all of its execution contexts are busy.
+SPM_MM_BUSY_RETRY		:= 0
+
 # Use the FF-A SPMC implementation in EL3.
 SPMC_AT_EL3			:= 0
 
 # Enable SEL0 SP when SPMC is enabled at EL3
 SPMC_AT_EL3_SEL0_SP		:=0
 
+# Number of direct requests to a SEL0 SP the SPMC at EL3 can hold pending while
+# the SP is busy. 0 returns FFA_ERROR_BUSY instead.
+SPMC_AT_EL3_DIR_REQ_QUEUE	:= 0
+
 # Use SPM at S-EL2 as a default config for SPMD
 SPMD_SPM_AT_SEL2		:= 1
 
@@ -282,6 +303,10 @@ USE_ROMLIB			:= 0
 # level makefile where we can check for incompatible features/build options.
 ALLOW_RO_XLAT_TABLES		:= 0
 
+# Build option to set the Contiguous bit on runs of translation table
+# descriptors that map adjacent memory with the same attributes.
+XLAT_TABLES_CONTIG_HINT		:= 0
+
 # Chain of trust.
 COT				:= tbbr
 
@@ -324,6 +349,10 @@ SUPPORT_STACK_MEMTAG		:= no
 # Select workaround for AT speculative behaviour.
 ERRATA_SPECULATIVE_AT		:= 0
 
+# Record the reset errata that apply to each CPU and only apply those on warm
+# boot, without checking the CPU revision again.
+ERRATA_PLAN			:= 0
+
 # Trap RAS error record access from Non secure
 RAS_TRAP_NS_ERR_REC_ACCESS	:= 0
 
@@ -375,6 +404,10 @@ ENABLE_SPMD_LP			:= 0
 # By default, disable PSA crypto (use MbedTLS legacy crypto API).
 PSA_CRYPTO			:= 0
 
+# By default, calculate hashes in software rather than with the Cryptographic
+# Extension instructions.
+ARM_CE_HASH			:= 0
+
 # getc() support from the console(s).
 # Disabled by default because it constitutes an attack vector into TF-A. It
 # should only be enabled if there is a use case for it.
@@ -21,6 +21,8 @@
 #
 # Build options added by this file:
 #
+#   CERT_CREATE_HASH_CACHE
+#   CERT_CREATE_JOBS
 #   KEY_ALG
 #   KEY_SIZE
 #   ROT_KEY
@@ -69,6 +71,10 @@ endif
 # Add the keys to the cert_create command line options (private keys are NOT
 # packed in the FIP). Developers can use their own keys by specifying the proper
 # build option in the command line when building the Trusted Firmware
+$(if ${CERT_CREATE_JOBS},$(eval $(call CERT_ADD_CMD_OPT,${CERT_CREATE_JOBS},--jobs)))
+$(if ${CERT_CREATE_JOBS},$(eval $(call CERT_ADD_CMD_OPT,${CERT_CREATE_JOBS},--jobs,FWU_)))
+$(if ${CERT_CREATE_HASH_CACHE},$(eval $(call CERT_ADD_CMD_OPT,${CERT_CREATE_HASH_CACHE},--hash-cache)))
+$(if ${CERT_CREATE_HASH_CACHE},$(eval $(call CERT_ADD_CMD_OPT,${CERT_CREATE_HASH_CACHE},--hash-cache,FWU_)))
 $(if ${KEY_ALG},$(eval $(call CERT_ADD_CMD_OPT,${KEY_ALG},--key-alg)))
 $(if ${KEY_ALG},$(eval $(call CERT_ADD_CMD_OPT,${KEY_ALG},--key-alg,FWU_)))
 $(if ${KEY_SIZE},$(eval $(call CERT_ADD_CMD_OPT,${KEY_SIZE},--key-size)))
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2023, Arm Limited. All rights reserved.
+ * Copyright (c) 2020-2024, Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -44,7 +44,7 @@ int fconf_populate_gicv3_config(uintptr_t config)
 	 * Populating fconf strucutures dynamically is not supported for legacy
 	 * systems which use GICv2 IP. Simply skip extracting GIC properties.
 	 */
-	node = fdt_node_offset_by_compatible(hw_config_dtb, -1, "arm,gic-v3");
+	node = fdtw_node_offset_by_compatible(hw_config_dtb, -1, "arm,gic-v3");
 	if (node < 0) {
 		WARN("FCONF: Unable to locate node with arm,gic-v3 compatible property\n");
 		return 0;
@@ -80,7 +80,7 @@ int fconf_populate_topology(uintptr_t config)
 	const void *hw_config_dtb = (const void *)config;
 
 	/* Find the offset of the node containing "arm,psci-1.0" compatible property */
-	node = fdt_node_offset_by_compatible(hw_config_dtb, -1, "arm,psci-1.0");
+	node = fdtw_node_offset_by_compatible(hw_config_dtb, -1, "arm,psci-1.0");
 	if (node < 0) {
 		ERROR("FCONF: Unable to locate node with arm,psci-1.0 compatible property\n");
 		return node;
@@ -99,7 +99,7 @@ int fconf_populate_topology(uintptr_t config)
 	assert(max_pwr_lvl <= MPIDR_AFFLVL2);
 
 	/* Find the offset of the "cpus" node */
-	node = fdt_path_offset(hw_config_dtb, "/cpus");
+	node = fdtw_path_offset(hw_config_dtb, "/cpus");
 	if (node < 0) {
 		ERROR("FCONF: Node '%s' not found in hardware configuration dtb\n", "cpus");
 		return node;
@@ -212,7 +212,7 @@ int fconf_populate_uart_config(uintptr_t config)
 	}
 
 	/* Find the offset of the uart serial node */
-	uart_node = fdt_path_offset(hw_config_dtb, path);
+	uart_node = fdtw_path_offset(hw_config_dtb, path);
 	if (uart_node < 0) {
 		ERROR("FCONF: Failed to locate uart serial node using its path\n");
 		return -1;
@@ -254,7 +254,7 @@ int fconf_populate_uart_config(uintptr_t config)
 		return err;
 	}
 
-	node = fdt_node_offset_by_phandle(hw_config_dtb, phandle);
+	node = fdtw_node_offset_by_phandle(hw_config_dtb, phandle);
 	if (node < 0) {
 		ERROR("FCONF: Failed to locate clk node using its path\n");
 		return node;
@@ -287,7 +287,7 @@ int fconf_populate_cpu_timer(uintptr_t config)
 	/* Find the node offset point to "arm,armv8-timer" compatible property,
 	 * a per-core architected timer attached to a GIC to deliver its per-processor
 	 * interrupts via PPIs */
-	node = fdt_node_offset_by_compatible(hw_config_dtb, -1, "arm,armv8-timer");
+	node = fdtw_node_offset_by_compatible(hw_config_dtb, -1, "arm,armv8-timer");
 	if (node < 0) {
 		ERROR("FCONF: Unrecognized hardware configuration dtb (%d)\n", node);
 		return node;
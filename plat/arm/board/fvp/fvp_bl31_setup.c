@@ -8,6 +8,7 @@
 
 #include <common/bl_common.h>
 #include <common/debug.h>
+#include <common/fdt_wrappers.h>
 #include <drivers/arm/smmu_v3.h>
 #include <fconf_hw_config_getter.h>
 #include <lib/fconf/fconf.h>
@@ -22,6 +23,14 @@
 
 static const struct dyn_cfg_dtb_info_t *hw_config_info __unused;
 
+#if FDT_INDEX
+/* Number of HW_CONFIG nodes which can be indexed */
+#define FVP_HW_CONFIG_INDEX_NODES	U(256)
+
+static uint64_t hw_config_index[FDTW_INDEX_SIZE(FVP_HW_CONFIG_INDEX_NODES) /
+				sizeof(uint64_t)];
+#endif
+
 void __init bl31_early_platform_setup2(u_register_t arg0,
 		u_register_t arg1, u_register_t arg2, u_register_t arg3)
 {
@@ -36,7 +45,8 @@ void __init bl31_early_platform_setup2(u_register_t arg0,
 
 	INFO("BL31 FCONF: FW_CONFIG address = %lx\n", (uintptr_t)arg1);
 	/* Fill the properties struct with the info from the config dtb */
-	fconf_populate("FW_CONFIG", arg1);
+	fconf_populate_with_size("FW_CONFIG", arg1,
+				 ARM_FW_CONFIG_LIMIT - ARM_FW_CONFIG_BASE);
 
 	soc_fw_config_info = FCONF_GET_PROPERTY(dyn_cfg, dtb, SOC_FW_CONFIG_ID);
 	if (soc_fw_config_info != NULL) {
@@ -137,9 +147,21 @@ void __init bl31_plat_arch_setup(void)
 		panic();
 	}
 
+#if FDT_INDEX
+	/* Index HW_CONFIG so that its populators don't walk it repeatedly */
+	rc = fdtw_index_init((void *)hw_config_info->config_addr,
+			     hw_config_index, sizeof(hw_config_index));
+	if (rc != 0) {
+		WARN("Can't index HW_CONFIG device tree (%d).\n", rc);
+	}
+#endif
+
 	/* Populate HW_CONFIG device tree with the mapped address */
 	fconf_populate("HW_CONFIG", hw_config_info->config_addr);
 
+	/* The index must not outlive the mapping of HW_CONFIG */
+	fdtw_index_invalidate((void *)hw_config_info->config_addr);
+
 	/* unmap the HW_CONFIG memory region */
 	rc = mmap_remove_dynamic_region(hw_config_base_align, mapped_size_align);
 	if (rc != 0) {
@@ -342,6 +342,11 @@ FDT_SOURCES		+=	$(addprefix plat/arm/board/fvp/fdts/,	\
 				)
 
 FVP_FW_CONFIG		:=	${BUILD_PLAT}/fdts/${PLAT}_fw_config.dtb
+ifeq (${FCONF_BLOB},1)
+# Package FW_CONFIG compiled into an fconf blob
+$(eval $(call MAKE_FCONF_BLOB,${BUILD_PLAT}/fdts/${PLAT}_fw_config.bin,${FVP_FW_CONFIG}))
+FVP_FW_CONFIG		:=	${BUILD_PLAT}/fdts/${PLAT}_fw_config.bin
+endif
 FVP_SOC_FW_CONFIG	:=	${BUILD_PLAT}/fdts/${PLAT}_soc_fw_config.dtb
 FVP_NT_FW_CONFIG	:=	${BUILD_PLAT}/fdts/${PLAT}_nt_fw_config.dtb
 
@@ -26,7 +26,8 @@ void plat_arm_sp_min_early_platform_setup(u_register_t arg0, u_register_t arg1,
 
 	INFO("SP_MIN FCONF: FW_CONFIG address = %lx\n", (uintptr_t)arg1);
 	/* Fill the properties struct with the info from the config dtb */
-	fconf_populate("FW_CONFIG", arg1);
+	fconf_populate_with_size("FW_CONFIG", arg1,
+				 ARM_FW_CONFIG_LIMIT - ARM_FW_CONFIG_BASE);
 
 	tos_fw_config_info = FCONF_GET_PROPERTY(dyn_cfg, dtb, TOS_FW_CONFIG_ID);
 	if (tos_fw_config_info != NULL) {
@@ -199,7 +199,9 @@ void arm_bl1_platform_setup(void)
 	}
 
 	transfer_list_update_checksum(secure_tl);
-	fconf_populate("TB_FW", (uintptr_t)transfer_list_entry_data(te));
+	fconf_populate_with_size("TB_FW",
+				 (uintptr_t)transfer_list_entry_data(te),
+				 te->data_size);
 #else
 	/* Set global DTB info for fixed fw_config information */
 	fw_config_max_size = ARM_FW_CONFIG_LIMIT - ARM_FW_CONFIG_BASE;
@@ -249,6 +251,10 @@ void arm_bl1_platform_setup(void)
 #if CRYPTO_SUPPORT
 	/* Share the Mbed TLS heap info with other images */
 	arm_bl1_set_mbedtls_heap();
+#if TRANSFER_LIST
+	/* Refresh the checksum following the update of TB_FW_CONFIG in the TL. */
+	transfer_list_update_checksum(secure_tl);
+#endif /* TRANSFER_LIST */
 #endif /* CRYPTO_SUPPORT */
 
 	/*
@@ -280,6 +286,18 @@ void bl1_plat_prepare_exit(entry_point_info_t *ep_info)
 	dsbsy();
 	sev();
 #endif
+
+#if TRANSFER_LIST && MEASURED_BOOT
+	/*
+	 * bl1_plat_mboot_finish() writes the Event Log information into
+	 * TB_FW_CONFIG after BL2 has been loaded. Refresh the checksum of the
+	 * TL holding it, and flush the TL again.
+	 */
+	if (secure_tl != NULL) {
+		transfer_list_update_checksum(secure_tl);
+		flush_dcache_range((uintptr_t)secure_tl, secure_tl->size);
+	}
+#endif /* TRANSFER_LIST && MEASURED_BOOT */
 }
 
 /*
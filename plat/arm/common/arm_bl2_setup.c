@@ -242,17 +242,21 @@ void bl2_plat_arch_setup(void)
 	te = transfer_list_find(secure_tl, TL_TAG_TB_FW_CONFIG);
 	assert(te != NULL);
 
-	fconf_populate("TB_FW", (uintptr_t)transfer_list_entry_data(te));
+	fconf_populate_with_size("TB_FW",
+				 (uintptr_t)transfer_list_entry_data(te),
+				 te->data_size);
 	transfer_list_rem(secure_tl, te);
 #else
 	/* Fill the properties struct with the info from the config dtb */
-	fconf_populate("FW_CONFIG", config_base);
+	fconf_populate_with_size("FW_CONFIG", config_base,
+				 ARM_FW_CONFIG_LIMIT - ARM_FW_CONFIG_BASE);
 
 	/* TB_FW_CONFIG was also loaded by BL1 */
 	tb_fw_config_info = FCONF_GET_PROPERTY(dyn_cfg, dtb, TB_FW_CONFIG_ID);
 	assert(tb_fw_config_info != NULL);
 
-	fconf_populate("TB_FW", tb_fw_config_info->config_addr);
+	fconf_populate_with_size("TB_FW", tb_fw_config_info->config_addr,
+				 tb_fw_config_info->config_max_size);
 #endif
 }
 
@@ -73,6 +73,9 @@ void arm_transfer_list_populate_ep_info(bl_mem_params_node_t *next_param_node,
 				next_param_node->image_info.image_max_size;
 		}
 
+		/* Refresh the checksum following the update of the entry. */
+		transfer_list_update_checksum(secure_tl);
+
 		next_exe_img_id = next_param_node->next_handoff_image_id;
 	}
 
@@ -11,6 +11,9 @@ CSS_LOAD_SCP_IMAGES	?=	1
 # By default, SCMI driver is disabled for CSS platforms
 CSS_USE_SCMI_SDS_DRIVER	?=	0
 
+# By default, CPUs wait for the response of SCP to their power down requests
+CSS_SCMI_POSTED_PWR_STATE_SET	?=	0
+
 PLAT_INCLUDES		+=	-Iinclude/plat/arm/css/common/aarch64
 
 
@@ -81,6 +84,10 @@ endif
 $(eval $(call assert_boolean,CSS_USE_SCMI_SDS_DRIVER))
 $(eval $(call add_define,CSS_USE_SCMI_SDS_DRIVER))
 
+# Process CSS_SCMI_POSTED_PWR_STATE_SET flag
+$(eval $(call assert_boolean,CSS_SCMI_POSTED_PWR_STATE_SET))
+$(eval $(call add_define,CSS_SCMI_POSTED_PWR_STATE_SET))
+
 # Process CSS_NON_SECURE_UART flag
 # This undocumented build option is only to enable debug access to the UART
 # from non secure code, which is useful on some platforms.
@@ -1,5 +1,5 @@
 #
-# Copyright (c) 2017-2023, ARM Limited and Contributors. All rights reserved.
+# Copyright (c) 2017-2024, ARM Limited and Contributors. All rights reserved.
 #
 # SPDX-License-Identifier: BSD-3-Clause
 #
@@ -116,6 +116,10 @@ $(ROTPK_HASH): $(ROT_KEY)
 
 endif
 
+ifeq (${FIP_GZIP}-${FIP_LZ4},1-1)
+$(error FIP_GZIP and FIP_LZ4 cannot be enabled together)
+endif
+
 ifeq (${FIP_GZIP},1)
 
 include lib/zlib/zlib.mk
@@ -125,6 +129,15 @@ BL2_SOURCES		+=	common/image_decompress.c		\
 
 $(eval $(call add_define,UNIPHIER_DECOMPRESS_GZIP))
 
+# Decompress the images while they are read from the storage
+UNIPHIER_GZIP_STREAM	?= 0
+ifeq (${UNIPHIER_GZIP_STREAM},1)
+ifeq (${TRUSTED_BOARD_BOOT},1)
+$(error UNIPHIER_GZIP_STREAM cannot be used with TRUSTED_BOARD_BOOT)
+endif
+$(eval $(call add_define,UNIPHIER_GZIP_STREAM))
+endif
+
 # compress all images loaded by BL2
 SCP_BL2_PRE_TOOL_FILTER	:= GZIP
 BL31_PRE_TOOL_FILTER	:= GZIP
@@ -133,6 +146,27 @@ BL33_PRE_TOOL_FILTER	:= GZIP
 
 endif
 
+ifeq (${FIP_LZ4},1)
+
+ifeq (${UNIPHIER_GZIP_STREAM},1)
+$(error UNIPHIER_GZIP_STREAM cannot be used with FIP_LZ4)
+endif
+
+include lib/lz4/lz4.mk
+
+BL2_SOURCES		+=	common/image_decompress.c		\
+				$(LZ4_SOURCES)
+
+$(eval $(call add_define,UNIPHIER_DECOMPRESS_LZ4))
+
+# compress all images loaded by BL2
+SCP_BL2_PRE_TOOL_FILTER	:= LZ4
+BL31_PRE_TOOL_FILTER	:= LZ4
+BL32_PRE_TOOL_FILTER	:= LZ4
+BL33_PRE_TOOL_FILTER	:= LZ4
+
+endif
+
 .PHONY: bl2_gzip
 bl2_gzip: $(BUILD_PLAT)/bl2.bin.gz
 %.gz: %
@@ -1,10 +1,11 @@
 /*
- * Copyright (c) 2017-2020, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2024, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
 #include <errno.h>
+#include <stdbool.h>
 
 #include <platform_def.h>
 
@@ -18,15 +19,38 @@
 #ifdef UNIPHIER_DECOMPRESS_GZIP
 #include <tf_gunzip.h>
 #endif
+#ifdef UNIPHIER_DECOMPRESS_LZ4
+#include <tf_lz4.h>
+#endif
 
 #include "uniphier.h"
 
 #define UNIPHIER_IMAGE_BUF_OFFSET	0x03800000UL
 #define UNIPHIER_IMAGE_BUF_SIZE		0x00800000UL
+#define UNIPHIER_IMAGE_CHUNK_SIZE	0x00010000UL
 
 static uintptr_t uniphier_mem_base = UNIPHIER_MEM_BASE;
 static unsigned int uniphier_soc = UNIPHIER_SOC_UNKNOWN;
 static int uniphier_bl2_kick_scp;
+#ifdef UNIPHIER_GZIP_STREAM
+static bool uniphier_stream_pending;
+#endif
+
+#if defined(UNIPHIER_DECOMPRESS_GZIP) || defined(UNIPHIER_DECOMPRESS_LZ4)
+#define UNIPHIER_DECOMPRESS
+#endif
+
+#if defined(UNIPHIER_DECOMPRESS) && !defined(UNIPHIER_GZIP_STREAM)
+/* The format of each compressed image is recognized by its magic bytes */
+static const decompressor_format_t uniphier_decompressors[] = {
+#ifdef UNIPHIER_DECOMPRESS_GZIP
+	DECOMPRESSOR_FORMAT_GZIP,
+#endif
+#ifdef UNIPHIER_DECOMPRESS_LZ4
+	DECOMPRESSOR_FORMAT_LZ4,
+#endif
+};
+#endif
 
 void bl2_el3_early_platform_setup(u_register_t x0, u_register_t x1,
 				  u_register_t x2, u_register_t x3)
@@ -110,7 +134,7 @@ bl_params_t *plat_get_next_bl_params(void)
 
 void bl2_plat_preload_setup(void)
 {
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_DECOMPRESS
 	uintptr_t buf_base = uniphier_mem_base + UNIPHIER_IMAGE_BUF_OFFSET;
 	int ret;
 
@@ -120,7 +144,14 @@ void bl2_plat_preload_setup(void)
 	if (ret)
 		plat_error_handler(ret);
 
-	image_decompress_init(buf_base, UNIPHIER_IMAGE_BUF_SIZE, gunzip);
+#ifdef UNIPHIER_GZIP_STREAM
+	image_decompress_stream_init(buf_base, UNIPHIER_IMAGE_BUF_SIZE,
+				     UNIPHIER_IMAGE_CHUNK_SIZE, gunzip_stream);
+#else
+	image_decompress_init_formats(buf_base, UNIPHIER_IMAGE_BUF_SIZE,
+				      uniphier_decompressors,
+				      ARRAY_SIZE(uniphier_decompressors));
+#endif
 #endif
 
 	uniphier_init_image_descs(uniphier_mem_base);
@@ -140,7 +171,13 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 	if (ret)
 		return ret;
 
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_GZIP_STREAM
+	/* The image is read and decompressed by the post image load hook */
+	if (!(image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
+		image_info->h.attr |= IMAGE_ATTRIB_SKIP_LOADING;
+		uniphier_stream_pending = true;
+	}
+#elif defined(UNIPHIER_DECOMPRESS)
 	image_decompress_prepare(image_info);
 #endif
 	return 0;
@@ -149,7 +186,18 @@ int bl2_plat_handle_pre_image_load(unsigned int image_id)
 int bl2_plat_handle_post_image_load(unsigned int image_id)
 {
 	struct image_info *image_info = uniphier_get_image_info(image_id);
-#ifdef UNIPHIER_DECOMPRESS_GZIP
+#ifdef UNIPHIER_GZIP_STREAM
+	int ret;
+
+	if (uniphier_stream_pending) {
+		uniphier_stream_pending = false;
+		image_info->h.attr &= ~IMAGE_ATTRIB_SKIP_LOADING;
+
+		ret = image_decompress_stream(image_id, image_info);
+		if (ret)
+			return ret;
+	}
+#elif defined(UNIPHIER_DECOMPRESS)
 	int ret;
 
 	if (!(image_info->h.attr & IMAGE_ATTRIB_SKIP_LOADING)) {
@@ -660,7 +660,13 @@ REGISTER_CRYPTO_LIB("stm32_crypto_lib",
 		    crypto_verify_signature,
 		    crypto_verify_hash,
 		    NULL,
+		    NULL,
+		    NULL,
+		    NULL,
 		    crypto_auth_decrypt,
+		    NULL,
+		    NULL,
+		    NULL,
 		    crypto_convert_pk);
 
 #else /* No decryption support */
@@ -670,5 +676,11 @@ REGISTER_CRYPTO_LIB("stm32_crypto_lib",
 		    crypto_verify_hash,
 		    NULL,
 		    NULL,
+		    NULL,
+		    NULL,
+		    NULL,
+		    NULL,
+		    NULL,
+		    NULL,
 		    crypto_convert_pk);
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2022 Arm Limited. All rights reserved.
+ * Copyright (c) 2022-2024 Arm Limited. All rights reserved.
  *
  * SPDX-License-Identifier:    BSD-3-Clause
  *
@@ -18,6 +18,14 @@
 #include "drtm_measurements.h"
 #include <lib/xlat_tables/xlat_tables_v2.h>
 
+/*
+ * Size of the window through which the DLME image is mapped to be measured.
+ * Must be a multiple of the page size.
+ */
+#ifndef PLAT_DRTM_DLME_MAP_WINDOW_SIZE
+#define PLAT_DRTM_DLME_MAP_WINDOW_SIZE	U(0x200000)
+#endif
+
 /* Event Log buffer */
 static uint8_t drtm_event_log[PLAT_DRTM_EVENT_LOG_MAX_SIZE];
 
@@ -61,6 +69,65 @@ static int drtm_event_log_measure_and_record(uintptr_t data_base,
 	return 0;
 }
 
+/*
+ * Measure the DLME image by mapping it through a window of
+ * PLAT_DRTM_DLME_MAP_WINDOW_SIZE bytes at most, and hashing it incrementally.
+ * The window is mapped at the same virtual address for each part of the image.
+ *
+ * @param[in] dlme_img_paddr    Physical address of the DLME image
+ * @param[in] dlme_img_size     Size of the DLME image
+ * @param[out] hash_data        Measurement of the DLME image
+ * @return:
+ *      0 = success
+ *    < 0 = error mapping the image
+ */
+static int drtm_measure_dlme_img(uintptr_t dlme_img_paddr,
+				 size_t dlme_img_size,
+				 unsigned char hash_data[CRYPTO_MD_MAX_SIZE])
+{
+	int rc;
+	uintptr_t window_va = 0U;
+	size_t off, part_size, map_size;
+
+	rc = event_log_measure_init();
+	CHECK_RC(rc, event_log_measure_init);
+
+	for (off = 0U; off < dlme_img_size; off += part_size) {
+		part_size = MIN(dlme_img_size - off,
+				(size_t)PLAT_DRTM_DLME_MAP_WINDOW_SIZE);
+		map_size = page_align(part_size, UP);
+
+		if (off == 0U) {
+			rc = mmap_add_dynamic_region_alloc_va(dlme_img_paddr,
+							      &window_va,
+							      map_size,
+							      MT_RO_DATA | MT_NS);
+		} else {
+			rc = mmap_add_dynamic_region(dlme_img_paddr + off,
+						     window_va, map_size,
+						     MT_RO_DATA | MT_NS);
+		}
+		if (rc != 0) {
+			WARN("DRTM: %s: mmap_add_dynamic_region() failed rc=%d\n",
+			     __func__, rc);
+			/* The measurement must be finished once started */
+			(void)event_log_measure_finish(hash_data);
+			return rc;
+		}
+
+		rc = event_log_measure_update(window_va, part_size);
+		CHECK_RC(rc, event_log_measure_update);
+
+		rc = mmap_remove_dynamic_region(window_va, map_size);
+		CHECK_RC(rc, mmap_remove_dynamic_region);
+	}
+
+	rc = event_log_measure_finish(hash_data);
+	CHECK_RC(rc, event_log_measure_finish);
+
+	return 0;
+}
+
 /*
  * Initialise Event Log global variables, used during the recording
  * of various payload measurements into the Event Log buffer
@@ -83,6 +150,7 @@ enum drtm_retc drtm_take_measurements(const struct_drtm_dl_args *a)
 	uintptr_t dlme_img_mapping;
 	uint64_t dlme_img_ep;
 	size_t dlme_img_mapping_bytes;
+	unsigned char hash_data[CRYPTO_MD_MAX_SIZE];
 	uint8_t drtm_null_data = 0U;
 	uint8_t pcr_schema = DL_ARGS_GET_PCR_SCHEMA(a);
 	const char *drtm_event_arm_sep_data = "ARM_DRTM";
@@ -165,23 +233,36 @@ enum drtm_retc drtm_take_measurements(const struct_drtm_dl_args *a)
 		 drtm_event_log_measure_and_record(DRTM_EVENT_ARM_DCE_PUBKEY));
 
 	/* PCR-18: Measure the DLME image. */
-	dlme_img_mapping_bytes = page_align(a->dlme_img_size, UP);
-	rc = mmap_add_dynamic_region_alloc_va(a->dlme_paddr + a->dlme_img_off,
-					      &dlme_img_mapping,
-					      dlme_img_mapping_bytes, MT_RO_DATA | MT_NS);
-	if (rc) {
-		WARN("DRTM: %s: mmap_add_dynamic_region() failed rc=%d\n",
-		     __func__, rc);
-		return INTERNAL_ERROR;
-	}
+	if (crypto_mod_calc_hash_has_steps()) {
+		event_log_metadata_t metadata = {0};
 
-	rc = drtm_event_log_measure_and_record(dlme_img_mapping, a->dlme_img_size,
-					       DRTM_EVENT_ARM_DLME, NULL,
-					       PCR_18);
-	CHECK_RC(rc, drtm_event_log_measure_and_record(DRTM_EVENT_ARM_DLME));
+		rc = drtm_measure_dlme_img(a->dlme_paddr + a->dlme_img_off,
+					   a->dlme_img_size, hash_data);
+		if (rc != 0) {
+			return INTERNAL_ERROR;
+		}
 
-	rc = mmap_remove_dynamic_region(dlme_img_mapping, dlme_img_mapping_bytes);
-	CHECK_RC(rc, mmap_remove_dynamic_region);
+		metadata.pcr = PCR_18;
+		event_log_record(hash_data, DRTM_EVENT_ARM_DLME, &metadata);
+	} else {
+		dlme_img_mapping_bytes = page_align(a->dlme_img_size, UP);
+		rc = mmap_add_dynamic_region_alloc_va(a->dlme_paddr + a->dlme_img_off,
+						      &dlme_img_mapping,
+						      dlme_img_mapping_bytes, MT_RO_DATA | MT_NS);
+		if (rc) {
+			WARN("DRTM: %s: mmap_add_dynamic_region() failed rc=%d\n",
+			     __func__, rc);
+			return INTERNAL_ERROR;
+		}
+
+		rc = drtm_event_log_measure_and_record(dlme_img_mapping, a->dlme_img_size,
+						       DRTM_EVENT_ARM_DLME, NULL,
+						       PCR_18);
+		CHECK_RC(rc, drtm_event_log_measure_and_record(DRTM_EVENT_ARM_DLME));
+
+		rc = mmap_remove_dynamic_region(dlme_img_mapping, dlme_img_mapping_bytes);
+		CHECK_RC(rc, mmap_remove_dynamic_region);
+	}
 
 	/* PCR-18: Measure the DLME image entry point. */
 	dlme_img_ep = DL_ARGS_GET_DLME_ENTRY_POINT(a);
@@ -8,6 +8,7 @@
 #include "cpu_errata_info.h"
 #include <lib/cpus/cpu_ops.h>
 #include <lib/cpus/errata.h>
+#include <lib/el3_runtime/cpu_data.h>
 #include <lib/smccc.h>
 #include <lib/utils_def.h>
 #include <services/errata_abi_svc.h>
@@ -183,7 +184,12 @@ int32_t verify_errata_implemented(uint32_t errata_id, uint32_t forward_flag)
 	}
 #endif
 
+#if ERRATA_PLAN
+	/* Avoid searching the cpu_ops again */
+	cpu_ops = (void *)get_cpu_data(cpu_ops_ptr);
+#else
 	cpu_ops = get_cpu_ops_ptr();
+#endif
 	assert(cpu_ops != NULL);
 
 	entry = cpu_ops->errata_list_start;
@@ -196,7 +202,11 @@ int32_t verify_errata_implemented(uint32_t errata_id, uint32_t forward_flag)
 
 	while ((entry <= end) && (ret_val == EM_UNKNOWN_ERRATUM)) {
 		if (entry->id == errata_id) {
+#if ERRATA_PLAN
+			if (errata_plan_check(entry, rev_var)) {
+#else
 			if (entry->check_func(rev_var)) {
+#endif
 				if (entry->chosen)
 					return EM_HIGHER_EL_MITIGATION;
 				else
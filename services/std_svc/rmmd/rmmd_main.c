@@ -435,6 +435,84 @@ static int gpt_to_gts_error(int error, uint32_t smc_fid, uint64_t address)
 	return ret;
 }
 
+/*
+ * Process a batch of commands posted by RMM in the shared buffer, writing the
+ * status of each command back into its entry. Commands are processed in order
+ * and a failing command does not prevent the following ones from being
+ * processed, so RMM only needs to trap into EL3 once per batch.
+ */
+static int rmmd_process_cmd_batch(uint64_t buf_pa, uint64_t num_cmds,
+				  uint64_t *num_done)
+{
+	struct rmm_el3_cmd_entry *cmds;
+	uintptr_t shared_buf_base;
+	size_t shared_buf_size;
+	uint64_t i;
+
+	*num_done = 0UL;
+
+	shared_buf_size = plat_rmmd_get_el3_rmm_shared_mem(&shared_buf_base);
+
+	/* Validate the command array against the shared buffer */
+	if ((buf_pa < shared_buf_base) ||
+	    (buf_pa >= (shared_buf_base + shared_buf_size)) ||
+	    !is_aligned(buf_pa, sizeof(uint64_t))) {
+		ERROR("RMMD: Command batch PA out of range\n");
+		return E_RMM_BAD_ADDR;
+	}
+
+	if ((num_cmds == 0UL) ||
+	    (num_cmds > ((shared_buf_base + shared_buf_size - buf_pa) /
+			 sizeof(struct rmm_el3_cmd_entry)))) {
+		ERROR("RMMD: Invalid command batch length\n");
+		return E_RMM_INVAL;
+	}
+
+	cmds = (struct rmm_el3_cmd_entry *)buf_pa;
+
+	for (i = 0UL; i < num_cmds; i++) {
+		/* Take a copy, RMM may still be writing to the buffer */
+		uint64_t fid = cmds[i].fid;
+		uint64_t arg = cmds[i].arg;
+		int ret;
+
+		switch (fid) {
+		case RMM_GTSI_DELEGATE:
+			ret = gpt_delegate_pas(arg, PAGE_SIZE_4KB,
+					       SMC_FROM_REALM);
+			ret = gpt_to_gts_error(ret, (uint32_t)fid, arg);
+			break;
+		case RMM_GTSI_UNDELEGATE:
+			ret = gpt_undelegate_pas(arg, PAGE_SIZE_4KB,
+						 SMC_FROM_REALM);
+			ret = gpt_to_gts_error(ret, (uint32_t)fid, arg);
+			break;
+		default:
+			WARN("RMMD: Unsupported batched command 0x%"PRIx64"\n",
+			     fid);
+			ret = E_RMM_UNK;
+			break;
+		}
+
+		cmds[i].result = ret;
+	}
+
+	*num_done = num_cmds;
+
+	return E_RMM_OK;
+}
+
+/*
+ * Implementation defined commands are only available if the Boot Interface
+ * version implemented by EL3 provides them. The version passed to RMM in the
+ * entry point arguments is only valid at cold boot, so it is not used here.
+ */
+static bool rmmd_impdef_cmds_available(void)
+{
+	return RMM_EL3_IFC_VERSION_GET_MAJOR_MINOR(RMM_EL3_INTERFACE_VERSION) >=
+		RMM_EL3_IMPDEF_MIN_VERSION;
+}
+
 /*******************************************************************************
  * This function handles RMM-EL3 interface SMCs
  ******************************************************************************/
@@ -472,6 +550,13 @@ uint64_t rmmd_rmm_el3_handler(uint32_t smc_fid, uint64_t x1, uint64_t x2,
 	case RMM_ATTEST_GET_REALM_KEY:
 		ret = rmmd_attest_get_signing_key(x1, &x2, x3);
 		SMC_RET2(handle, ret, x2);
+	case RMM_EL3_CMD_BATCH:
+		if (!rmmd_impdef_cmds_available()) {
+			WARN("RMMD: Unsupported RMM-EL3 call 0x%08x\n", smc_fid);
+			SMC_RET1(handle, SMC_UNK);
+		}
+		ret = rmmd_process_cmd_batch(x1, x2, &x2);
+		SMC_RET2(handle, ret, x2);
 
 	case RMM_BOOT_COMPLETE:
 		VERBOSE("RMMD: running rmmd_rmm_sync_exit\n");
@@ -58,6 +58,25 @@ CASSERT((PAGE_SIZE % FFA_PAGE_SIZE) == 0, assert_aligned_page_size);
 #define FFA_PM_MSG_SUB_CPU_SUSPEND		U(1 << 1)
 #define FFA_PM_MSG_SUB_CPU_SUSPEND_RESUME	U(1 << 2)
 
+/*
+ * Time a core keeps its turn in the queue of direct requests to a S-EL0 SP
+ * without retrying its request.
+ */
+#ifndef SPMC_AT_EL3_DIR_REQ_QUEUE_TIMEOUT_US
+#define SPMC_AT_EL3_DIR_REQ_QUEUE_TIMEOUT_US	U(1000)
+#endif
+
+/*
+ * Entry of the queue of direct requests to a S-EL0 SP.
+ */
+struct dir_req_queue_entry {
+	/* Linear ID of the requesting core. */
+	uint16_t linear_id;
+
+	/* Time after which the core loses its turn if it has not retried. */
+	uint64_t expiry;
+};
+
 /*
  * Runtime states of an execution context as per the FF-A v1.1 specification.
  */
@@ -171,6 +190,15 @@ struct secure_partition_desc {
 	/* Lock to protect the runtime state of a S-EL0 SP execution context. */
 	spinlock_t rt_state_lock;
 
+#if SPMC_AT_EL3_DIR_REQ_QUEUE
+	/*
+	 * Cores whose direct request found the execution context of a S-EL0 SP
+	 * busy, in arrival order. Protected by rt_state_lock.
+	 */
+	struct dir_req_queue_entry dir_req_queue[SPMC_AT_EL3_DIR_REQ_QUEUE];
+	unsigned int dir_req_queue_len;
+#endif
+
 	/* Pointer to translation table context of a S-EL0 SP. */
 	xlat_ctx_t *xlat_ctx_handle;
 
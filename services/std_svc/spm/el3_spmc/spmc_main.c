@@ -16,6 +16,7 @@
 #include <common/fdt_wrappers.h>
 #include <common/runtime_svc.h>
 #include <common/uuid.h>
+#include <drivers/delay_timer.h>
 #include <lib/el3_runtime/context_mgmt.h>
 #include <lib/smccc.h>
 #include <lib/utils.h>
@@ -330,6 +331,99 @@ static bool direct_msg_validate_lp_resp(uint16_t origin_id, uint16_t lp_id,
 	return true;
 }
 
+#if SPMC_AT_EL3_DIR_REQ_QUEUE
+/*******************************************************************************
+ * Helper function to remove the cores that did not retry their direct request
+ * in time from the queue of a S-EL0 SP, so that they do not hold the turn of
+ * the cores behind them. Must be called with the runtime state lock of the SP
+ * held.
+ ******************************************************************************/
+static void direct_req_queue_expire(struct secure_partition_desc *sp)
+{
+	unsigned int i, j = 0U;
+
+	for (i = 0U; i < sp->dir_req_queue_len; i++) {
+		if (!timeout_elapsed(sp->dir_req_queue[i].expiry)) {
+			sp->dir_req_queue[j++] = sp->dir_req_queue[i];
+		}
+	}
+
+	sp->dir_req_queue_len = j;
+}
+
+/*******************************************************************************
+ * Helper function to decide whether a direct request to a S-EL0 SP can be
+ * forwarded to its execution context. Requests are forwarded in arrival order:
+ * a core whose request finds the SP busy, or finds other cores ahead of it,
+ * is added to the queue and its request fails with FFA_ERROR_BUSY. It keeps
+ * its turn for SPMC_AT_EL3_DIR_REQ_QUEUE_TIMEOUT_US after each attempt, and
+ * its request is forwarded once it is at the head of the queue and the SP is
+ * waiting. No core waits in EL3. Must be called with the runtime state lock
+ * of the SP held. Returns true if the request can be forwarded to the SP.
+ ******************************************************************************/
+static bool direct_req_queue_take_turn(struct secure_partition_desc *sp,
+				       unsigned int idx)
+{
+	uint16_t linear_id = (uint16_t)plat_my_core_pos();
+	unsigned int i, j;
+
+	assert(sp->runtime_el == S_EL0);
+
+	direct_req_queue_expire(sp);
+
+	for (i = 0U; i < sp->dir_req_queue_len; i++) {
+		if (sp->dir_req_queue[i].linear_id == linear_id) {
+			break;
+		}
+	}
+
+	if ((sp->ec[idx].rt_state == RT_STATE_WAITING) && (i == 0U)) {
+		/* Our turn, leave the queue if we were in it. */
+		if (sp->dir_req_queue_len != 0U) {
+			sp->dir_req_queue_len--;
+			for (j = 0U; j < sp->dir_req_queue_len; j++) {
+				sp->dir_req_queue[j] = sp->dir_req_queue[j + 1U];
+			}
+		}
+		return true;
+	}
+
+	if (i == sp->dir_req_queue_len) {
+		if (sp->dir_req_queue_len == SPMC_AT_EL3_DIR_REQ_QUEUE) {
+			/* No room left, the request is not ordered. */
+			return false;
+		}
+		sp->dir_req_queue[i].linear_id = linear_id;
+		sp->dir_req_queue_len++;
+	}
+
+	sp->dir_req_queue[i].expiry =
+		timeout_init_us(SPMC_AT_EL3_DIR_REQ_QUEUE_TIMEOUT_US);
+
+	return false;
+}
+
+/*******************************************************************************
+ * Helper function to check whether direct requests are queued on a S-EL0 SP.
+ * Must be called with the runtime state lock of the SP held.
+ ******************************************************************************/
+static bool direct_req_queue_pending(struct secure_partition_desc *sp)
+{
+	return sp->dir_req_queue_len != 0U;
+}
+#else
+static inline bool direct_req_queue_pending(struct secure_partition_desc *sp)
+{
+	return false;
+}
+
+static inline bool direct_req_queue_take_turn(struct secure_partition_desc *sp,
+					      unsigned int idx)
+{
+	return false;
+}
+#endif /* SPMC_AT_EL3_DIR_REQ_QUEUE */
+
 /*******************************************************************************
  * Handle direct request messages and route to the appropriate destination.
  ******************************************************************************/
@@ -409,18 +503,26 @@ static uint64_t direct_req_smc_handler(uint32_t smc_fid,
 
 	/*
 	 * Check that the target execution context is in a waiting state before
-	 * forwarding the direct request to it.
+	 * forwarding the direct request to it. The execution context of a S-EL0
+	 * SP is shared by all cores, so the requests to it are forwarded in
+	 * arrival order if possible.
 	 */
 	idx = get_ec_index(sp);
-	if (sp->ec[idx].rt_state != RT_STATE_WAITING) {
-		VERBOSE("SP context on core%u is not waiting (%u).\n",
-			idx, sp->ec[idx].rt_model);
+	if ((sp->ec[idx].rt_state != RT_STATE_WAITING) ||
+	    ((sp->runtime_el == S_EL0) && direct_req_queue_pending(sp))) {
+		if ((sp->runtime_el != S_EL0) ||
+		    (sp->ec[idx].rt_state == RT_STATE_PREEMPTED) ||
+		    (sp->ec[idx].rt_state == RT_STATE_BLOCKED) ||
+		    !direct_req_queue_take_turn(sp, idx)) {
+			VERBOSE("SP context on core%u is not waiting (%u).\n",
+				idx, sp->ec[idx].rt_model);
+
+			if (sp->runtime_el == S_EL0) {
+				spin_unlock(&sp->rt_state_lock);
+			}
 
-		if (sp->runtime_el == S_EL0) {
-			spin_unlock(&sp->rt_state_lock);
+			return spmc_ffa_error_return(handle, FFA_ERROR_BUSY);
 		}
-
-		return spmc_ffa_error_return(handle, FFA_ERROR_BUSY);
 	}
 
 	/*
@@ -797,6 +899,12 @@ static uint64_t rxtx_map_handler(uint32_t smc_fid,
 		goto err;
 	}
 
+	/*
+	 * Map both buffers in a single batch so that the translation tables
+	 * are synchronised once for the pair.
+	 */
+	mmap_begin_dynamic_batch();
+
 	/* memmap the TX buffer as read only. */
 	ret = mmap_add_dynamic_region(tx_address, /* PA */
 			tx_address, /* VA */
@@ -807,6 +915,7 @@ static uint64_t rxtx_map_handler(uint32_t smc_fid,
 		error_code = (ret == -ENOMEM) ? FFA_ERROR_NO_MEMORY :
 						FFA_ERROR_INVALID_PARAMETER;
 		WARN("Unable to map TX buffer: %d\n", error_code);
+		mmap_commit_dynamic_batch();
 		goto err;
 	}
 
@@ -822,9 +931,12 @@ static uint64_t rxtx_map_handler(uint32_t smc_fid,
 		WARN("Unable to map RX buffer: %d\n", error_code);
 		/* Unmap the TX buffer again. */
 		mmap_remove_dynamic_region(tx_address, buf_size);
+		mmap_commit_dynamic_batch();
 		goto err;
 	}
 
+	mmap_commit_dynamic_batch();
+
 	mbox->tx_buffer = (void *) tx_address;
 	mbox->rx_buffer = (void *) rx_address;
 	mbox->rxtx_page_count = page_count;
@@ -869,6 +981,8 @@ static uint64_t rxtx_unmap_handler(uint32_t smc_fid,
 					     FFA_ERROR_INVALID_PARAMETER);
 	}
 
+	mmap_begin_dynamic_batch();
+
 	/* Unmap RX Buffer */
 	if (mmap_remove_dynamic_region((uintptr_t) mbox->rx_buffer,
 				       buf_size) != 0) {
@@ -886,6 +1000,8 @@ static uint64_t rxtx_unmap_handler(uint32_t smc_fid,
 	mbox->tx_buffer = 0;
 	mbox->rxtx_page_count = 0;
 
+	mmap_commit_dynamic_batch();
+
 	spin_unlock(&mbox->lock);
 	SMC_RET1(handle, FFA_SUCCESS_SMC32);
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2022, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2024, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -25,10 +25,21 @@
 #include "spm_common.h"
 #include "spm_mm_private.h"
 
+CASSERT(SPM_MM_SP_CONTEXTS >= 1, assert_spm_mm_sp_contexts_valid);
+
 /*******************************************************************************
- * Secure Partition context information.
+ * Secure Partition execution contexts. A reentrant partition can be given
+ * several execution contexts, in which case several cores can execute in the
+ * partition at the same time.
  ******************************************************************************/
-static sp_context_t sp_ctx;
+static sp_context_t sp_ctx[SPM_MM_SP_CONTEXTS];
+
+/* Execution context entered by each core. */
+static sp_context_t *sp_cur_ctx[PLATFORM_CORE_COUNT];
+
+/* Number of calls that found all the execution contexts busy. */
+static uint64_t sp_contention_count;
+static spinlock_t sp_contention_lock;
 
 /*******************************************************************************
  * Set state of a Secure Partition context.
@@ -40,27 +51,6 @@ void sp_state_set(sp_context_t *sp_ptr, sp_state_t state)
 	spin_unlock(&(sp_ptr->state_lock));
 }
 
-/*******************************************************************************
- * Wait until the state of a Secure Partition is the specified one and change it
- * to the desired state.
- ******************************************************************************/
-void sp_state_wait_switch(sp_context_t *sp_ptr, sp_state_t from, sp_state_t to)
-{
-	int success = 0;
-
-	while (success == 0) {
-		spin_lock(&(sp_ptr->state_lock));
-
-		if (sp_ptr->state == from) {
-			sp_ptr->state = to;
-
-			success = 1;
-		}
-
-		spin_unlock(&(sp_ptr->state_lock));
-	}
-}
-
 /*******************************************************************************
  * Check if the state of a Secure Partition is the specified one and, if so,
  * change it to the desired state. Returns 0 on success, -1 on error.
@@ -93,6 +83,7 @@ static uint64_t spm_sp_synchronous_entry(sp_context_t *ctx)
 	assert(ctx != NULL);
 
 	/* Assign the context of the SP to this CPU */
+	sp_cur_ctx[plat_my_core_pos()] = ctx;
 	cm_set_context(&(ctx->cpu_ctx), SECURE);
 
 	/* Restore the context assigned above */
@@ -118,7 +109,9 @@ static uint64_t spm_sp_synchronous_entry(sp_context_t *ctx)
  ******************************************************************************/
 __dead2 static void spm_sp_synchronous_exit(uint64_t rc)
 {
-	sp_context_t *ctx = &sp_ctx;
+	sp_context_t *ctx = sp_cur_ctx[plat_my_core_pos()];
+
+	assert(ctx != NULL);
 
 	/*
 	 * The SPM must have initiated the original request through a
@@ -135,19 +128,27 @@ __dead2 static void spm_sp_synchronous_exit(uint64_t rc)
  ******************************************************************************/
 static int32_t spm_init(void)
 {
-	uint64_t rc;
+	uint64_t rc = 0U;
 	sp_context_t *ctx;
+	unsigned int i;
 
 	INFO("Secure Partition init...\n");
 
-	ctx = &sp_ctx;
+	/*
+	 * Enter each execution context in turn. The first one initialises the
+	 * partition, the others only have to set up their own stack and event
+	 * loop.
+	 */
+	for (i = 0U; (i < SPM_MM_SP_CONTEXTS) && (rc == 0U); i++) {
+		ctx = &sp_ctx[i];
 
-	ctx->state = SP_STATE_RESET;
+		ctx->state = SP_STATE_RESET;
 
-	rc = spm_sp_synchronous_entry(ctx);
-	assert(rc == 0);
+		rc = spm_sp_synchronous_entry(ctx);
+		assert(rc == 0);
 
-	ctx->state = SP_STATE_IDLE;
+		ctx->state = SP_STATE_IDLE;
+	}
 
 	INFO("Secure Partition initialized.\n");
 
@@ -160,6 +161,7 @@ static int32_t spm_init(void)
 int32_t spm_mm_setup(void)
 {
 	sp_context_t *ctx;
+	unsigned int i;
 
 	/* Disable MMU at EL1 (initialized by BL2) */
 	disable_mmu_icache_el1();
@@ -167,13 +169,18 @@ int32_t spm_mm_setup(void)
 	/* Initialize context of the SP */
 	INFO("Secure Partition context setup start...\n");
 
-	ctx = &sp_ctx;
+	ctx = &sp_ctx[0];
 
 	/* Assign translation tables context. */
 	ctx->xlat_ctx_handle = spm_get_sp_xlat_context();
 
 	spm_sp_setup(ctx);
 
+	/* The other execution contexts are derived from the first one. */
+	for (i = 1U; i < SPM_MM_SP_CONTEXTS; i++) {
+		spm_sp_setup_secondary_ctx(&sp_ctx[i], ctx, i);
+	}
+
 	/* Register init function for deferred init.  */
 	bl31_register_bl32_init(&spm_init);
 
@@ -183,14 +190,76 @@ int32_t spm_mm_setup(void)
 }
 
 /*******************************************************************************
- * Function to perform a call to a Secure Partition.
+ * Return the number of calls into the Secure Partition that found all of its
+ * execution contexts busy.
  ******************************************************************************/
-uint64_t spm_mm_sp_call(uint32_t smc_fid, uint64_t x1, uint64_t x2, uint64_t x3)
+uint64_t spm_mm_get_contention_count(void)
+{
+	uint64_t count;
+
+	spin_lock(&sp_contention_lock);
+	count = sp_contention_count;
+	spin_unlock(&sp_contention_lock);
+
+	return count;
+}
+
+/*******************************************************************************
+ * Claim an idle execution context of the Secure Partition, trying first the
+ * one matching the calling core. If all of them are busy, either wait for one
+ * to become idle or return NULL, depending on 'wait'.
+ ******************************************************************************/
+static sp_context_t *spm_mm_claim_ctx(bool wait)
+{
+	unsigned int start = plat_my_core_pos() % SPM_MM_SP_CONTEXTS;
+	bool contended = false;
+	sp_context_t *ctx;
+	unsigned int i;
+
+	for (;;) {
+		for (i = 0U; i < SPM_MM_SP_CONTEXTS; i++) {
+			ctx = &sp_ctx[(start + i) % SPM_MM_SP_CONTEXTS];
+			if (sp_state_try_switch(ctx, SP_STATE_IDLE,
+						SP_STATE_BUSY) == 0) {
+				return ctx;
+			}
+		}
+
+		if (!contended) {
+			contended = true;
+
+			spin_lock(&sp_contention_lock);
+			sp_contention_count++;
+			spin_unlock(&sp_contention_lock);
+		}
+
+		if (!wait) {
+			return NULL;
+		}
+	}
+}
+
+/*******************************************************************************
+ * Function to perform a call to a claimed execution context of a Secure
+ * Partition.
+ ******************************************************************************/
+static uint64_t spm_mm_sp_call_ctx(sp_context_t *sp_ptr, uint32_t smc_fid,
+				   uint64_t x1, uint64_t x2, uint64_t x3)
 {
 	uint64_t rc;
-	sp_context_t *sp_ptr = &sp_ctx;
 
-#if CTX_INCLUDE_FPREGS
+	assert(sp_ptr->state == SP_STATE_BUSY);
+
+	/* Set values for registers on SP entry */
+	cpu_context_t *cpu_ctx = &(sp_ptr->cpu_ctx);
+
+#if CTX_FPREGS_LAZY
+	/*
+	 * Only save the non secure FP registers if the SP uses them, on the
+	 * first FP/SIMD access trap.
+	 */
+	cm_fpregs_lazy_enter(cm_get_context(NON_SECURE), cpu_ctx);
+#elif CTX_INCLUDE_FPREGS
 	/*
 	 * SP runs to completion, no need to restore FP registers of secure context.
 	 * Save FP registers only for non secure context.
@@ -198,12 +267,6 @@ uint64_t spm_mm_sp_call(uint32_t smc_fid, uint64_t x1, uint64_t x2, uint64_t x3)
 	fpregs_context_save(get_fpregs_ctx(cm_get_context(NON_SECURE)));
 #endif
 
-	/* Wait until the Secure Partition is idle and set it to busy. */
-	sp_state_wait_switch(sp_ptr, SP_STATE_IDLE, SP_STATE_BUSY);
-
-	/* Set values for registers on SP entry */
-	cpu_context_t *cpu_ctx = &(sp_ptr->cpu_ctx);
-
 	write_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X0, smc_fid);
 	write_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X1, x1);
 	write_ctx_reg(get_gpregs_ctx(cpu_ctx), CTX_GPREG_X2, x2);
@@ -216,7 +279,10 @@ uint64_t spm_mm_sp_call(uint32_t smc_fid, uint64_t x1, uint64_t x2, uint64_t x3)
 	assert(sp_ptr->state == SP_STATE_BUSY);
 	sp_state_set(sp_ptr, SP_STATE_IDLE);
 
-#if CTX_INCLUDE_FPREGS
+#if CTX_FPREGS_LAZY
+	/* Restore the non secure FP registers if the SP has used them */
+	(void)cm_fpregs_lazy_exit(cpu_ctx);
+#elif CTX_INCLUDE_FPREGS
 	/*
 	 * SP runs to completion, no need to save FP registers of secure context.
 	 * Restore only non secure world FP registers.
@@ -227,6 +293,17 @@ uint64_t spm_mm_sp_call(uint32_t smc_fid, uint64_t x1, uint64_t x2, uint64_t x3)
 	return rc;
 }
 
+/*******************************************************************************
+ * Function to perform a call to a Secure Partition. Waits for one of its
+ * execution contexts to become idle.
+ ******************************************************************************/
+uint64_t spm_mm_sp_call(uint32_t smc_fid, uint64_t x1, uint64_t x2, uint64_t x3)
+{
+	sp_context_t *sp_ptr = spm_mm_claim_ctx(true);
+
+	return spm_mm_sp_call_ctx(sp_ptr, smc_fid, x1, x2, x3);
+}
+
 /*******************************************************************************
  * MM_COMMUNICATE handler
  ******************************************************************************/
@@ -234,6 +311,7 @@ static uint64_t mm_communicate(uint32_t smc_fid, uint64_t mm_cookie,
 			       uint64_t comm_buffer_address,
 			       uint64_t comm_size_address, void *handle)
 {
+	sp_context_t *sp_ptr;
 	uint64_t rc;
 
 	/* Cookie. Reserved for future use. It must be zero. */
@@ -253,10 +331,22 @@ static uint64_t mm_communicate(uint32_t smc_fid, uint64_t mm_cookie,
 
 	/*
 	 * The current secure partition design mandates
-	 * - at any point, only a single core can be
-	 *   executing in the secure partition.
+	 * - at any point, only one core can be executing
+	 *   in each execution context of the secure
+	 *   partition.
 	 * - a core cannot be preempted by an interrupt
 	 *   while executing in secure partition.
+	 * Claim an execution context, or ask the caller to
+	 * retry later if they are all busy and
+	 * SPM_MM_BUSY_RETRY is enabled.
+	 */
+	sp_ptr = spm_mm_claim_ctx(SPM_MM_BUSY_RETRY == 0);
+	if (sp_ptr == NULL) {
+		VERBOSE("MM_COMMUNICATE: Secure Partition busy\n");
+		SMC_RET1(handle, SPM_MM_BUSY);
+	}
+
+	/*
 	 * Raise the running priority of the core to the
 	 * interrupt level configured for secure partition
 	 * so as to block any interrupt from preempting this
@@ -267,8 +357,8 @@ static uint64_t mm_communicate(uint32_t smc_fid, uint64_t mm_cookie,
 	/* Save the Normal world context */
 	cm_el1_sysregs_context_save(NON_SECURE);
 
-	rc = spm_mm_sp_call(smc_fid, comm_buffer_address, comm_size_address,
-			    plat_my_core_pos());
+	rc = spm_mm_sp_call_ctx(sp_ptr, smc_fid, comm_buffer_address,
+				comm_size_address, plat_my_core_pos());
 
 	/* Restore non-secure state */
 	cm_el1_sysregs_context_restore(NON_SECURE);
@@ -301,6 +391,7 @@ uint64_t spm_mm_smc_handler(uint32_t smc_fid,
 	ns = is_caller_non_secure(flags);
 
 	if (ns == SMC_FROM_SECURE) {
+		sp_context_t *sp_ptr = sp_cur_ctx[plat_my_core_pos()];
 
 		/* Handle SMCs from Secure world. */
 
@@ -320,24 +411,24 @@ uint64_t spm_mm_smc_handler(uint32_t smc_fid,
 		case MM_SP_MEMORY_ATTRIBUTES_GET_AARCH64:
 			INFO("Received MM_SP_MEMORY_ATTRIBUTES_GET_AARCH64 SMC\n");
 
-			if (sp_ctx.state != SP_STATE_RESET) {
+			if (sp_ptr->state != SP_STATE_RESET) {
 				WARN("MM_SP_MEMORY_ATTRIBUTES_GET_AARCH64 is available at boot time only\n");
 				SMC_RET1(handle, SPM_MM_NOT_SUPPORTED);
 			}
 			SMC_RET1(handle,
 				 spm_memory_attributes_get_smc_handler(
-					 &sp_ctx, x1));
+					 sp_ptr, x1));
 
 		case MM_SP_MEMORY_ATTRIBUTES_SET_AARCH64:
 			INFO("Received MM_SP_MEMORY_ATTRIBUTES_SET_AARCH64 SMC\n");
 
-			if (sp_ctx.state != SP_STATE_RESET) {
+			if (sp_ptr->state != SP_STATE_RESET) {
 				WARN("MM_SP_MEMORY_ATTRIBUTES_SET_AARCH64 is available at boot time only\n");
 				SMC_RET1(handle, SPM_MM_NOT_SUPPORTED);
 			}
 			SMC_RET1(handle,
 				 spm_memory_attributes_set_smc_handler(
-					&sp_ctx, x1, x2, x3));
+					sp_ptr, x1, x2, x3));
 		default:
 			break;
 		}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2023, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2024, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -54,6 +54,9 @@ typedef struct sp_context {
 
 
 void spm_sp_setup(sp_context_t *sp_ctx);
+void spm_sp_setup_secondary_ctx(sp_context_t *sp_ctx,
+				const sp_context_t *primary_ctx,
+				unsigned int index);
 
 int32_t spm_memory_attributes_get_smc_handler(sp_context_t *sp_ctx,
 					      uintptr_t base_va);
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017-2023, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2017-2024, ARM Limited and Contributors. All rights reserved.
  * Copyright (c) 2021, NVIDIA Corporation. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -258,3 +258,30 @@ void spm_sp_setup(sp_context_t *sp_ctx)
 			sp_mp_info[index].flags |= MP_INFO_FLAG_PRIMARY_CPU;
 	}
 }
+
+/*
+ * Setup an additional execution context of a reentrant Secure Partition from
+ * the context set up by spm_sp_setup(). The translation tables are shared and
+ * the context only differs by its stack and by X4, which holds the index of the
+ * execution context (0 for the context that initialises the partition).
+ */
+void spm_sp_setup_secondary_ctx(sp_context_t *sp_ctx,
+				const sp_context_t *primary_ctx,
+				unsigned int index)
+{
+	cpu_context_t *ctx = &(sp_ctx->cpu_ctx);
+
+	const spm_mm_boot_info_t *sp_boot_info =
+			plat_get_secure_partition_boot_info(NULL);
+
+	/* Each execution context needs a stack of its own. */
+	assert(index < sp_boot_info->num_cpus);
+
+	memcpy(ctx, &(primary_ctx->cpu_ctx), sizeof(*ctx));
+	sp_ctx->xlat_ctx_handle = primary_ctx->xlat_ctx_handle;
+
+	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_X4, index);
+	write_ctx_reg(get_gpregs_ctx(ctx), CTX_GPREG_SP_EL0,
+		      sp_boot_info->sp_stack_base +
+		      ((index + 1U) * sp_boot_info->sp_pcpu_stack_size));
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2024, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -8,5 +8,8 @@
 #define SHA_H
 
 int sha_file(int md_alg, const char *filename, unsigned char *md);
+int sha_cache_load(const char *filename);
+int sha_cache_save(void);
+void sha_cache_cleanup(void);
 
 #endif /* SHA_H */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2024, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -23,6 +24,7 @@
 #include "cmd_opt.h"
 #include "debug.h"
 #include "ext.h"
+#include "jobs.h"
 #include "key.h"
 #include "sha.h"
 
@@ -65,6 +67,13 @@ static int key_size;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static int num_threads;
+static const char *hash_cache_fn;
+
+/* Image hash algorithm and the image digests, indexed by extension */
+static const EVP_MD *md_info;
+static unsigned int md_len;
+static unsigned char (*ext_md)[SHA512_DIGEST_LENGTH];
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
@@ -176,6 +185,18 @@ static int get_hash_alg(const char *hash_alg_str)
 	return -1;
 }
 
+static int get_num_threads(const char *num_threads_str)
+{
+	char *end;
+	long num;
+
+	num = strtol(num_threads_str, &end, 10);
+	if ((*end != '\0') || (num <= 0) || (num > INT_MAX))
+		return -1;
+
+	return num;
+}
+
 static void check_cmd_params(void)
 {
 	cert_t *cert;
@@ -297,25 +318,192 @@ static const cmd_opt_t common_cmd_opt[] = {
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of threads used to create keys, hash images and sign "
+		"certificates (default: 1)"
+	},
+	{
+		{ "hash-cache", required_argument, NULL, 'c' },
+		"File caching the image hashes. Images whose size, inode "
+		"and timestamps are unchanged are not hashed again"
 	}
 };
 
-int main(int argc, char *argv[])
+/* Create a new key. Run by the worker pool */
+static int create_key(void *arg)
+{
+	key_t *key = arg;
+
+	NOTICE("Creating new key for '%s'\n", key->desc);
+	if (!key_create(key, key_alg, key_size)) {
+		ERROR("Error creating key '%s'\n", key->desc);
+		return 0;
+	}
+
+	return 1;
+}
+
+/* Calculate the hash of the image of an extension. Run by the worker pool */
+static int hash_image(void *arg)
+{
+	ext_t *ext = arg;
+
+	if (!sha_file(hash_alg, ext->arg, ext_md[ext - extensions])) {
+		ERROR("Cannot calculate hash of %s\n", ext->arg);
+		return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Create and sign a certificate. Run by the worker pool once the issuer
+ * certificate, if any, has been created and all the images have been hashed.
+ */
+static int create_cert(void *arg)
 {
 	STACK_OF(X509_EXTENSION) * sk;
 	X509_EXTENSION *cert_ext = NULL;
+	cert_t *cert = arg;
+	ext_t *ext;
+	unsigned char *md;
+	int j, ext_nid, nvctr;
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext = &extensions[cert->ext[j]];
+
+		/* Get OpenSSL internal ID for this extension */
+		CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->optional && ext->arg == NULL) {
+				/* Skip this NVCounter */
+				continue;
+			} else {
+				/* Checked by `check_cmd_params` */
+				assert(ext->arg != NULL);
+				nvctr = atoi(ext->arg);
+				CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if ((ext->arg == NULL) && !ext->optional) {
+				/* Do not include this hash in the certificate */
+				continue;
+			}
+			/*
+			 * Images have been hashed beforehand. Optional images
+			 * not provided get a hash filled with zeros.
+			 */
+			md = ext_md[cert->ext[j]];
+			CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, md,
+					md_len));
+			break;
+		case EXT_TYPE_PKEY:
+			CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			exit(1);
+		}
+
+		/* Push the extension into the stack */
+		sk_X509_EXTENSION_push(sk, cert_ext);
+	}
+
+	/* Create certificate. Signed with corresponding key */
+	if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
+		ERROR("Cannot create %s\n", cert->cn);
+		exit(1);
+	}
+
+	for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
+			cert_ext = sk_X509_EXTENSION_pop(sk)) {
+		X509_EXTENSION_free(cert_ext);
+	}
+
+	sk_X509_EXTENSION_free(sk);
+
+	return 1;
+}
+
+/* States of a certificate whose job has not been added yet */
+#define CERT_JOB_PENDING		(-2)
+#define CERT_JOB_VISITING		(-3)
+
+/*
+ * Add the job creating the certificate 'idx', after the job creating its
+ * issuer so that every certificate depends on its issuer and the jobs are in
+ * topological order. 'cert_job' holds the job of each certificate, JOB_NO_DEP
+ * for the certificates that are not requested. Return 0 if the issuers of the
+ * certificate form a cycle.
+ */
+static int add_cert_job(job_t *jobs, unsigned int *num_jobs, int *cert_job,
+			int idx)
+{
+	cert_t *cert = &certs[idx];
+	int dep = JOB_NO_DEP;
+
+	if (cert_job[idx] == CERT_JOB_VISITING) {
+		ERROR("Cycle in the issuers of certificate '%s'\n", cert->cn);
+		return 0;
+	}
+
+	if (cert_job[idx] != CERT_JOB_PENDING) {
+		/* Job already added, or certificate not requested */
+		return 1;
+	}
+
+	/* A root certificate is its own issuer */
+	if (cert->issuer != idx) {
+		cert_job[idx] = CERT_JOB_VISITING;
+		if (!add_cert_job(jobs, num_jobs, cert_job, cert->issuer)) {
+			return 0;
+		}
+		dep = cert_job[cert->issuer];
+	}
+
+	jobs[*num_jobs].fn = create_cert;
+	jobs[*num_jobs].arg = cert;
+	jobs[*num_jobs].dep = dep;
+	cert_job[idx] = *num_jobs;
+	(*num_jobs)++;
+
+	return 1;
+}
+
+int main(int argc, char *argv[])
+{
 	ext_t *ext;
 	key_t *key;
 	cert_t *cert;
 	FILE *file;
-	int i, j, ext_nid, nvctr;
+	int i;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	const char *cur_opt;
 	unsigned int err_code;
-	unsigned char md[SHA512_DIGEST_LENGTH];
-	unsigned int  md_len;
-	const EVP_MD *md_info;
+	job_t *jobs;
+	int *cert_job;
+	unsigned int num_jobs;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -324,6 +512,7 @@ int main(int argc, char *argv[])
 	key_alg = KEY_ALG_RSA;
 	hash_alg = HASH_ALG_SHA256;
 	key_size = -1;
+	num_threads = 1;
 
 	/* Add common command line options */
 	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
@@ -353,7 +542,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:b:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:b:c:hj:knps:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -375,9 +564,19 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'c':
+			hash_cache_fn = optarg;
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
+		case 'j':
+			num_threads = get_num_threads(optarg);
+			if (num_threads < 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -437,7 +636,21 @@ int main(int argc, char *argv[])
 		md_len  = SHA256_DIGEST_LENGTH;
 	}
 
+	/*
+	 * Keys, image hashes and certificates are processed as jobs by a pool of
+	 * worker threads. There can be at most one job per key, per extension
+	 * and per certificate.
+	 */
+	jobs = malloc((num_keys + num_extensions + num_certs) * sizeof(jobs[0]));
+	cert_job = malloc(num_certs * sizeof(cert_job[0]));
+	ext_md = calloc(num_extensions, sizeof(ext_md[0]));
+	if ((jobs == NULL) || (cert_job == NULL) || (ext_md == NULL)) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		exit(1);
+	}
+
 	/* Load private keys from files (or generate new ones) */
+	num_jobs = 0;
 	for (i = 0 ; i < num_keys ; i++) {
 #if !USING_OPENSSL3
 		if (!key_new(&keys[i])) {
@@ -464,12 +677,11 @@ int main(int argc, char *argv[])
 		/* File does not exist, could not be opened or no filename was
 		 * given */
 		if (new_keys) {
-			/* Try to create a new key */
-			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg, key_size)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
+			/* Queue the creation of a new key */
+			jobs[num_jobs].fn = create_key;
+			jobs[num_jobs].arg = &keys[i];
+			jobs[num_jobs].dep = JOB_NO_DEP;
+			num_jobs++;
 		} else {
 			if (err_code == KEY_ERR_OPEN) {
 				ERROR("Error opening '%s'\n", keys[i].fn);
@@ -480,95 +692,56 @@ int main(int argc, char *argv[])
 		}
 	}
 
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
-
-		cert = &certs[i];
-
-		if (cert->fn == NULL) {
-			/* Certificate not requested. Skip to the next one */
-			continue;
+	/* Hash the images in parallel with the creation of the keys */
+	if (hash_cache_fn != NULL) {
+		if (!sha_cache_load(hash_cache_fn)) {
+			ERROR("Cannot load hash cache %s\n", hash_cache_fn);
+			exit(1);
 		}
+	}
 
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
-		for (j = 0 ; j < cert->num_ext ; j++) {
-
-			ext = &extensions[cert->ext[j]];
+	for (i = 0 ; i < num_extensions ; i++) {
+		ext = &extensions[i];
+		if ((ext->type == EXT_TYPE_HASH) && (ext->arg != NULL)) {
+			jobs[num_jobs].fn = hash_image;
+			jobs[num_jobs].arg = ext;
+			jobs[num_jobs].dep = JOB_NO_DEP;
+			num_jobs++;
+		}
+	}
 
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
+	if (!jobs_run(jobs, num_jobs, num_threads)) {
+		exit(1);
+	}
 
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->optional && ext->arg == NULL) {
-					/* Skip this NVCounter */
-					continue;
-				} else {
-					/* Checked by `check_cmd_params` */
-					assert(ext->arg != NULL);
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
-				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA512_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						continue;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						md_len));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
-			}
+	if (!sha_cache_save()) {
+		WARN("Cannot save hash cache %s\n", hash_cache_fn);
+	}
 
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
-		}
+	/*
+	 * Create the certificates. A certificate is created after its issuer
+	 * certificate, which is used to sign it. If the issuer certificate is
+	 * not requested, the certificate is self signed.
+	 */
+	for (i = 0 ; i < num_certs ; i++) {
+		/* Skip the certificates that are not requested */
+		cert_job[i] = (certs[i].fn == NULL) ? JOB_NO_DEP :
+						      CERT_JOB_PENDING;
+	}
 
-		/* Create certificate. Signed with corresponding key */
-		if (!cert_new(hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
+	num_jobs = 0;
+	for (i = 0 ; i < num_certs ; i++) {
+		if (!add_cert_job(jobs, &num_jobs, cert_job, i)) {
 			exit(1);
 		}
+	}
 
-		for (cert_ext = sk_X509_EXTENSION_pop(sk); cert_ext != NULL;
-				cert_ext = sk_X509_EXTENSION_pop(sk)) {
-			X509_EXTENSION_free(cert_ext);
-		}
-
-		sk_X509_EXTENSION_free(sk);
+	if (!jobs_run(jobs, num_jobs, num_threads)) {
+		exit(1);
 	}
 
+	free(cert_job);
+	free(jobs);
 
 	/* Print the certificates */
 	if (print_cert) {
@@ -620,5 +793,9 @@ int main(int argc, char *argv[])
 
 	cert_cleanup();
 
+	sha_cache_cleanup();
+
+	free(ext_md);
+
 	return 0;
 }
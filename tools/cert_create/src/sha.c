@@ -1,12 +1,24 @@
 /*
- * Copyright (c) 2015-2022, Arm Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2024, Arm Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+/* Needed for the nanosecond timestamps of struct stat with -std=c99 */
+#ifndef __APPLE__
+#define _POSIX_C_SOURCE	200809L
+#endif
+
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
 #include "debug.h"
 #include "key.h"
+#include "sha.h"
 #if USING_OPENSSL3
 #include <openssl/evp.h>
 #include <openssl/obj_mac.h>
@@ -16,6 +28,47 @@
 
 #define BUFFER_SIZE	256
 
+/* Hash cache file format: one entry per line, '#' starts a comment */
+#define CACHE_HEADER		"# cert_create hash cache v2\n"
+#define CACHE_LINE_MAX		4096
+#define MAX_DIGEST_SIZE		64
+
+#ifdef __APPLE__
+#define st_mtim			st_mtimespec
+#define st_ctim			st_ctimespec
+#endif
+
+/*
+ * Identity of a file. Rewriting the file changes its modification and status
+ * change times, and replacing it with another file changes its inode number.
+ */
+typedef struct sha_file_id_s {
+	long long size;
+	long long ino;
+	long long mtime_sec;
+	long long mtime_nsec;
+	long long ctime_sec;
+	long long ctime_nsec;
+} sha_file_id_t;
+
+/*
+ * Hash cache entry. A cached digest is only used if the identity of the file
+ * has not changed since the digest was computed.
+ */
+typedef struct sha_cache_entry_s {
+	char *path;
+	int md_alg;
+	sha_file_id_t id;
+	unsigned char md[MAX_DIGEST_SIZE];
+} sha_cache_entry_t;
+
+/* Hash cache state, protected by 'cache_lock' */
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static const char *cache_fn;
+static sha_cache_entry_t *cache;
+static unsigned int cache_num, cache_max;
+static int cache_dirty;
+
 #if USING_OPENSSL3
 static int get_algorithm_nid(int hash_alg)
 {
@@ -27,7 +80,234 @@ static int get_algorithm_nid(int hash_alg)
 }
 #endif
 
-int sha_file(int md_alg, const char *filename, unsigned char *md)
+static int get_digest_size(int md_alg)
+{
+	switch (md_alg) {
+	case HASH_ALG_SHA384:
+		return 48;
+	case HASH_ALG_SHA512:
+		return 64;
+	default:
+		return 32;
+	}
+}
+
+static void get_file_id(const struct stat *st, sha_file_id_t *id)
+{
+	id->size = (long long)st->st_size;
+	id->ino = (long long)st->st_ino;
+	id->mtime_sec = (long long)st->st_mtim.tv_sec;
+	id->mtime_nsec = (long long)st->st_mtim.tv_nsec;
+	id->ctime_sec = (long long)st->st_ctim.tv_sec;
+	id->ctime_nsec = (long long)st->st_ctim.tv_nsec;
+}
+
+static int file_id_equal(const sha_file_id_t *a, const sha_file_id_t *b)
+{
+	return (a->size == b->size) && (a->ino == b->ino) &&
+	       (a->mtime_sec == b->mtime_sec) &&
+	       (a->mtime_nsec == b->mtime_nsec) &&
+	       (a->ctime_sec == b->ctime_sec) &&
+	       (a->ctime_nsec == b->ctime_nsec);
+}
+
+static sha_cache_entry_t *cache_find(const char *path, int md_alg)
+{
+	unsigned int i;
+
+	for (i = 0; i < cache_num; i++) {
+		if ((cache[i].md_alg == md_alg) &&
+		    (strcmp(cache[i].path, path) == 0)) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Add or update a cache entry. Must be called with 'cache_lock' held */
+static int cache_update(const char *path, int md_alg, const sha_file_id_t *id,
+			const unsigned char *md)
+{
+	sha_cache_entry_t *entry, *tmp;
+
+	entry = cache_find(path, md_alg);
+	if (entry == NULL) {
+		if (cache_num == cache_max) {
+			cache_max = (cache_max == 0U) ? 16U : (cache_max * 2U);
+			tmp = realloc(cache, cache_max * sizeof(cache[0]));
+			if (tmp == NULL) {
+				ERROR("%s:%d Failed to allocate memory.\n",
+				      __func__, __LINE__);
+				return 0;
+			}
+			cache = tmp;
+		}
+
+		entry = &cache[cache_num];
+		entry->path = malloc(strlen(path) + 1);
+		if (entry->path == NULL) {
+			ERROR("%s:%d Failed to allocate memory.\n",
+			      __func__, __LINE__);
+			return 0;
+		}
+		strcpy(entry->path, path);
+		entry->md_alg = md_alg;
+		cache_num++;
+	}
+
+	entry->id = *id;
+	memcpy(entry->md, md, get_digest_size(md_alg));
+
+	return 1;
+}
+
+/*
+ * Load the hash cache from 'filename'. The cache is used by sha_file() and
+ * written back by sha_cache_save(). A missing cache file is not an error.
+ */
+int sha_cache_load(const char *filename)
+{
+	char line[CACHE_LINE_MAX];
+	unsigned char md[MAX_DIGEST_SIZE];
+	sha_file_id_t id;
+	char hex[(2 * MAX_DIGEST_SIZE) + 1];
+	int md_alg, path_off, i, len;
+	unsigned int byte;
+	FILE *file;
+
+	cache_fn = filename;
+
+	file = fopen(filename, "r");
+	if (file == NULL) {
+		VERBOSE("Hash cache %s not found\n", filename);
+		return 1;
+	}
+
+	/* Entries written in another format are dropped */
+	if ((fgets(line, sizeof(line), file) == NULL) ||
+	    (strcmp(line, CACHE_HEADER) != 0)) {
+		VERBOSE("Ignoring hash cache %s of an unknown format\n",
+			filename);
+		fclose(file);
+		return 1;
+	}
+
+	while (fgets(line, sizeof(line), file) != NULL) {
+		if ((line[0] == '#') || (line[0] == '\n')) {
+			continue;
+		}
+
+		line[strcspn(line, "\n")] = '\0';
+		if (sscanf(line, "%d %lld %lld %lld %lld %lld %lld %128s %n",
+			   &md_alg, &id.size, &id.ino, &id.mtime_sec,
+			   &id.mtime_nsec, &id.ctime_sec, &id.ctime_nsec, hex,
+			   &path_off) != 8) {
+			WARN("Ignoring malformed hash cache entry\n");
+			continue;
+		}
+
+		len = get_digest_size(md_alg);
+		if ((md_alg < HASH_ALG_SHA256) || (md_alg > HASH_ALG_SHA512) ||
+		    (strlen(hex) != (2U * len)) || (line[path_off] == '\0')) {
+			WARN("Ignoring malformed hash cache entry\n");
+			continue;
+		}
+
+		for (i = 0; i < len; i++) {
+			if (sscanf(&hex[2 * i], "%2x", &byte) != 1) {
+				break;
+			}
+			md[i] = (unsigned char)byte;
+		}
+		if (i != len) {
+			WARN("Ignoring malformed hash cache entry\n");
+			continue;
+		}
+
+		if (!cache_update(&line[path_off], md_alg, &id, md)) {
+			fclose(file);
+			return 0;
+		}
+	}
+
+	fclose(file);
+	cache_dirty = 0;
+
+	return 1;
+}
+
+/* Write the hash cache back to its file if it has been updated */
+int sha_cache_save(void)
+{
+	char *tmp_fn;
+	unsigned int i;
+	int j, ret = 1;
+	FILE *file;
+
+	if ((cache_fn == NULL) || !cache_dirty) {
+		return 1;
+	}
+
+	/* Write to a temporary file first so a failure leaves the cache intact */
+	tmp_fn = malloc(strlen(cache_fn) + sizeof(".tmp"));
+	if (tmp_fn == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		return 0;
+	}
+	sprintf(tmp_fn, "%s.tmp", cache_fn);
+
+	file = fopen(tmp_fn, "w");
+	if (file == NULL) {
+		ERROR("Cannot create file %s\n", tmp_fn);
+		free(tmp_fn);
+		return 0;
+	}
+
+	fputs(CACHE_HEADER, file);
+	for (i = 0; i < cache_num; i++) {
+		fprintf(file, "%d %lld %lld %lld %lld %lld %lld ",
+			cache[i].md_alg, cache[i].id.size, cache[i].id.ino,
+			cache[i].id.mtime_sec, cache[i].id.mtime_nsec,
+			cache[i].id.ctime_sec, cache[i].id.ctime_nsec);
+		for (j = 0; j < get_digest_size(cache[i].md_alg); j++) {
+			fprintf(file, "%02x", cache[i].md[j]);
+		}
+		fprintf(file, " %s\n", cache[i].path);
+	}
+
+	if (fclose(file) != 0) {
+		ERROR("Cannot write file %s\n", tmp_fn);
+		ret = 0;
+	} else if (rename(tmp_fn, cache_fn) != 0) {
+		ERROR("Cannot update file %s\n", cache_fn);
+		ret = 0;
+	}
+
+	if (ret == 0) {
+		remove(tmp_fn);
+	}
+	free(tmp_fn);
+
+	return ret;
+}
+
+void sha_cache_cleanup(void)
+{
+	unsigned int i;
+
+	for (i = 0; i < cache_num; i++) {
+		free(cache[i].path);
+	}
+	free(cache);
+	cache = NULL;
+	cache_num = 0U;
+	cache_max = 0U;
+	cache_fn = NULL;
+}
+
+static int sha_file_compute(int md_alg, const char *filename,
+			    unsigned char *md)
 {
 	FILE *inFile;
 	int bytes;
@@ -116,3 +396,69 @@ err:
 #endif
 }
 
+
+/*
+ * Calculate the hash of a file. If a hash cache has been loaded, the digest is
+ * taken from it when the identity of the file (size, inode number, modification
+ * and status change times) matches the cached entry. This function can be
+ * called concurrently from several threads.
+ */
+int sha_file(int md_alg, const char *filename, unsigned char *md)
+{
+	sha_cache_entry_t *entry;
+	sha_file_id_t id, id_after;
+	struct stat st;
+	time_t start;
+	int hit = 0;
+
+	if ((cache_fn == NULL) || (filename == NULL) || (md == NULL) ||
+	    (stat(filename, &st) != 0)) {
+		return sha_file_compute(md_alg, filename, md);
+	}
+	get_file_id(&st, &id);
+
+	pthread_mutex_lock(&cache_lock);
+	entry = cache_find(filename, md_alg);
+	if ((entry != NULL) && file_id_equal(&entry->id, &id)) {
+		memcpy(md, entry->md, get_digest_size(md_alg));
+		hit = 1;
+	}
+	pthread_mutex_unlock(&cache_lock);
+
+	if (hit) {
+		VERBOSE("Using cached hash of %s\n", filename);
+		return 1;
+	}
+
+	start = time(NULL);
+
+	if (!sha_file_compute(md_alg, filename, md)) {
+		return 0;
+	}
+
+	/* Do not cache the digest if the file changed while being hashed */
+	if (stat(filename, &st) != 0) {
+		return 1;
+	}
+	get_file_id(&st, &id_after);
+	if (!file_id_equal(&id_after, &id)) {
+		return 1;
+	}
+
+	/*
+	 * Nor if the file was modified too recently: on file systems with coarse
+	 * timestamps, a later rewrite could leave its identity unchanged.
+	 */
+	if ((start == (time_t)-1) || (id.mtime_sec >= ((long long)start - 1)) ||
+	    (id.ctime_sec >= ((long long)start - 1))) {
+		return 1;
+	}
+
+	pthread_mutex_lock(&cache_lock);
+	if (cache_update(filename, md_alg, &id, md)) {
+		cache_dirty = 1;
+	}
+	pthread_mutex_unlock(&cache_lock);
+
+	return 1;
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2024, Arm Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdlib.h>
+
+#include "debug.h"
+#include "jobs.h"
+
+/* Job states */
+enum {
+	JOB_PENDING,
+	JOB_RUNNING,
+	JOB_DONE,
+	JOB_FAILED
+};
+
+/* Worker pool shared state, protected by 'lock' */
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static job_t *pool_jobs;
+static unsigned int pool_num_jobs;
+static int pool_failed;
+
+/*
+ * Return the first pending job whose dependency has completed, or NULL if
+ * there is none. '*pending' is set if there are pending jobs left.
+ */
+static job_t *get_ready_job(int *pending)
+{
+	job_t *job;
+	unsigned int i;
+
+	*pending = 0;
+
+	for (i = 0; i < pool_num_jobs; i++) {
+		job = &pool_jobs[i];
+		if (job->state != JOB_PENDING) {
+			continue;
+		}
+
+		*pending = 1;
+		if ((job->dep == JOB_NO_DEP) ||
+		    (pool_jobs[job->dep].state == JOB_DONE)) {
+			return job;
+		}
+	}
+
+	return NULL;
+}
+
+static void *worker(void *arg)
+{
+	job_t *job;
+	int pending, ok;
+
+	(void)arg;
+
+	pthread_mutex_lock(&lock);
+	while (!pool_failed) {
+		job = get_ready_job(&pending);
+		if (job == NULL) {
+			if (!pending) {
+				break;
+			}
+			/* Wait for a running job to complete */
+			pthread_cond_wait(&cond, &lock);
+			continue;
+		}
+
+		job->state = JOB_RUNNING;
+		pthread_mutex_unlock(&lock);
+
+		ok = job->fn(job->arg);
+
+		pthread_mutex_lock(&lock);
+		job->state = ok ? JOB_DONE : JOB_FAILED;
+		if (!ok) {
+			pool_failed = 1;
+		}
+		pthread_cond_broadcast(&cond);
+	}
+	pthread_mutex_unlock(&lock);
+
+	return NULL;
+}
+
+/*
+ * Run the jobs in the array using up to 'num_threads' worker threads. A job
+ * may only depend on a job that precedes it in the array, so running the jobs
+ * in array order always satisfies the dependencies. This is what happens when
+ * a single thread is requested.
+ *
+ * Return 1 if all the jobs completed successfully, 0 otherwise. No new job is
+ * started after a failure.
+ */
+int jobs_run(job_t *jobs, unsigned int num_jobs, unsigned int num_threads)
+{
+	pthread_t *threads;
+	unsigned int i, num_started;
+
+	for (i = 0; i < num_jobs; i++) {
+		assert((jobs[i].dep == JOB_NO_DEP) ||
+		       ((jobs[i].dep >= 0) && ((unsigned int)jobs[i].dep < i)));
+		jobs[i].state = JOB_PENDING;
+	}
+
+	if (num_threads > num_jobs) {
+		num_threads = num_jobs;
+	}
+
+	if (num_threads <= 1) {
+		for (i = 0; i < num_jobs; i++) {
+			if (!jobs[i].fn(jobs[i].arg)) {
+				return 0;
+			}
+			jobs[i].state = JOB_DONE;
+		}
+		return 1;
+	}
+
+	threads = malloc(num_threads * sizeof(threads[0]));
+	if (threads == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		return 0;
+	}
+
+	pool_jobs = jobs;
+	pool_num_jobs = num_jobs;
+	pool_failed = 0;
+
+	for (num_started = 0; num_started < num_threads; num_started++) {
+		if (pthread_create(&threads[num_started], NULL, worker,
+				   NULL) != 0) {
+			WARN("Cannot create worker thread\n");
+			break;
+		}
+	}
+
+	/* Make progress even if no worker could be started */
+	if (num_started == 0) {
+		worker(NULL);
+	}
+
+	for (i = 0; i < num_started; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	free(threads);
+
+	return !pool_failed;
+}
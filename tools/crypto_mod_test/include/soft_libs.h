@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef SOFT_LIBS_H
+#define SOFT_LIBS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <drivers/auth/crypto_mod.h>
+
+/*
+ * Both libraries compute the same toy digest and the same toy cipher, and
+ * mark the last byte of their output with their own identifier, so that the
+ * test can tell which one ran an operation.
+ */
+#define SOFT_LIB_ID		0x5aU
+#define SOFT_ACCEL_ID		0xa5U
+
+#define TOY_HASH_SEED		0xcbf29ce484222325ULL
+
+/* Key length handled by the accelerator, others fall back to the library */
+#define SOFT_ACCEL_KEY_LEN	16U
+
+/* Number of operations run by each library */
+struct soft_lib_stats {
+	unsigned int calls;
+};
+
+extern struct soft_lib_stats soft_lib_stats;
+extern struct soft_lib_stats soft_accel_stats;
+
+extern const crypto_lib_desc_t soft_accel_lib_desc;
+
+/* Helpers shared by both libraries */
+void toy_hash(uint64_t *state, const void *data, size_t len);
+void toy_hash_output(uint64_t state, unsigned char output[CRYPTO_MD_MAX_SIZE],
+		     uint8_t id);
+void toy_cipher(void *data, size_t len, const void *key, unsigned int key_len,
+		size_t offset);
+
+#endif /* SOFT_LIBS_H */
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test of the dispatch of the crypto module between the registered
+ * library and an offload library. Each operation must run on the accelerator
+ * when it handles the algorithm, fall back to the registered library when it
+ * does not, and give the same result either way.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <drivers/auth/crypto_mod.h>
+
+#include "soft_libs.h"
+
+#define DATA_SIZE		200U
+#define STEP_SIZE		32U
+
+static const crypto_lib_desc_t *const test_offload_libs[] = {
+	&soft_accel_lib_desc,
+};
+
+REGISTER_CRYPTO_OFFLOAD_LIBS(test_offload_libs);
+
+static int failed;
+
+#define CHECK(_cond)							\
+	do {								\
+		if (!(_cond)) {						\
+			printf("FAIL: %s:%d: %s\n", __func__, __LINE__,	\
+			       #_cond);					\
+			failed = 1;					\
+		}							\
+	} while (0)
+
+static uint8_t data[DATA_SIZE];
+
+/* Run an operation and return which libraries ran it, as a bitmap */
+#define RAN_LIB		1U
+#define RAN_ACCEL	2U
+
+static struct soft_lib_stats lib_before, accel_before;
+
+static void start(void)
+{
+	lib_before = soft_lib_stats;
+	accel_before = soft_accel_stats;
+}
+
+static unsigned int ran(void)
+{
+	return ((soft_lib_stats.calls != lib_before.calls) ? RAN_LIB : 0U) |
+	       ((soft_accel_stats.calls != accel_before.calls) ? RAN_ACCEL : 0U);
+}
+
+static void test_calc_hash(void)
+{
+	unsigned char out256[CRYPTO_MD_MAX_SIZE], out384[CRYPTO_MD_MAX_SIZE];
+
+	start();
+	CHECK(crypto_mod_calc_hash(CRYPTO_MD_SHA256, data, DATA_SIZE,
+				   out256) == CRYPTO_SUCCESS);
+	CHECK(ran() == RAN_ACCEL);
+	CHECK(out256[CRYPTO_MD_MAX_SIZE - 1U] == SOFT_ACCEL_ID);
+
+	start();
+	CHECK(crypto_mod_calc_hash(CRYPTO_MD_SHA384, data, DATA_SIZE,
+				   out384) == CRYPTO_SUCCESS);
+	CHECK(ran() == RAN_LIB);
+	CHECK(out384[CRYPTO_MD_MAX_SIZE - 1U] == SOFT_LIB_ID);
+
+	/* Same digest whichever library computed it */
+	CHECK(memcmp(out256, out384, CRYPTO_MD_MAX_SIZE - 1U) == 0);
+}
+
+static void test_calc_hash_steps(void)
+{
+	unsigned char whole[CRYPTO_MD_MAX_SIZE], steps[CRYPTO_MD_MAX_SIZE];
+	unsigned int off;
+
+	CHECK(crypto_mod_calc_hash_has_steps());
+
+	CHECK(crypto_mod_calc_hash(CRYPTO_MD_SHA256, data, DATA_SIZE,
+				   whole) == CRYPTO_SUCCESS);
+
+	start();
+	CHECK(crypto_mod_calc_hash_init(CRYPTO_MD_SHA256) == CRYPTO_SUCCESS);
+	for (off = 0U; off < DATA_SIZE; off += STEP_SIZE) {
+		unsigned int len = DATA_SIZE - off;
+
+		if (len > STEP_SIZE) {
+			len = STEP_SIZE;
+		}
+		CHECK(crypto_mod_calc_hash_update(data + off, len) ==
+		      CRYPTO_SUCCESS);
+	}
+	CHECK(crypto_mod_calc_hash_finish(steps) == CRYPTO_SUCCESS);
+	CHECK(ran() == RAN_ACCEL);
+	CHECK(memcmp(whole, steps, CRYPTO_MD_MAX_SIZE) == 0);
+
+	/* Neither library hashes SHA-512 in several steps */
+	start();
+	CHECK(crypto_mod_calc_hash_init(CRYPTO_MD_SHA512) ==
+	      CRYPTO_ERR_NOT_SUPPORTED);
+	CHECK(ran() == 0U);
+}
+
+static void test_verify(void)
+{
+	uint64_t digest = TOY_HASH_SEED;
+	uint8_t sig_alg = 0U, pk = 0U;
+
+	toy_hash(&digest, data, DATA_SIZE);
+
+	/* The accelerator verifies nothing, so both go to the library */
+	start();
+	CHECK(crypto_mod_verify_hash(data, DATA_SIZE, &digest,
+				     sizeof(digest)) == CRYPTO_SUCCESS);
+	CHECK(crypto_mod_verify_signature(data, DATA_SIZE, &digest,
+					  sizeof(digest), &sig_alg, 1U, &pk,
+					  1U) == CRYPTO_SUCCESS);
+	CHECK(ran() == RAN_LIB);
+
+	digest ^= 1U;
+	CHECK(crypto_mod_verify_hash(data, DATA_SIZE, &digest,
+				     sizeof(digest)) == CRYPTO_ERR_HASH);
+}
+
+static void test_auth_decrypt(void)
+{
+	uint8_t key[SOFT_ACCEL_KEY_LEN], iv[CRYPTO_MAX_IV_SIZE] = { 0 };
+	uint8_t tag[CRYPTO_MAX_TAG_SIZE] = { 0 };
+	uint8_t buf[DATA_SIZE];
+	unsigned int i, off;
+
+	for (i = 0U; i < sizeof(key); i++) {
+		key[i] = (uint8_t)(0x30U + i);
+	}
+
+	/*
+	 * The registered library has no authenticated decryption: this must
+	 * not trip on it while the accelerator handles the key.
+	 */
+	memcpy(buf, data, DATA_SIZE);
+	toy_cipher(buf, DATA_SIZE, key, sizeof(key), 0U);
+	start();
+	CHECK(crypto_mod_auth_decrypt(CRYPTO_GCM_DECRYPT, buf, DATA_SIZE, key,
+				      sizeof(key), 0U, iv, sizeof(iv), tag,
+				      sizeof(tag)) == CRYPTO_SUCCESS);
+	CHECK(ran() == RAN_ACCEL);
+	CHECK(memcmp(buf, data, DATA_SIZE) == 0);
+
+	/* Same in several steps */
+	CHECK(crypto_mod_auth_decrypt_has_steps());
+	toy_cipher(buf, DATA_SIZE, key, sizeof(key), 0U);
+	start();
+	CHECK(crypto_mod_auth_decrypt_init(CRYPTO_GCM_DECRYPT, key,
+					   sizeof(key), 0U, iv,
+					   sizeof(iv)) == CRYPTO_SUCCESS);
+	for (off = 0U; off < DATA_SIZE; off += CRYPTO_DEC_BLOCK_SIZE) {
+		unsigned int len = DATA_SIZE - off;
+
+		if (len > CRYPTO_DEC_BLOCK_SIZE) {
+			len = CRYPTO_DEC_BLOCK_SIZE;
+		}
+		CHECK(crypto_mod_auth_decrypt_update(buf + off, len) ==
+		      CRYPTO_SUCCESS);
+	}
+	CHECK(crypto_mod_auth_decrypt_finish(tag, sizeof(tag)) ==
+	      CRYPTO_SUCCESS);
+	CHECK(ran() == RAN_ACCEL);
+	CHECK(memcmp(buf, data, DATA_SIZE) == 0);
+
+	/* No library handles other key lengths in several steps */
+	start();
+	CHECK(crypto_mod_auth_decrypt_init(CRYPTO_GCM_DECRYPT, key,
+					   sizeof(key) - 1U, 0U, iv,
+					   sizeof(iv)) ==
+	      CRYPTO_ERR_NOT_SUPPORTED);
+	CHECK(ran() == 0U);
+}
+
+int main(void)
+{
+	unsigned int i;
+
+	for (i = 0U; i < DATA_SIZE; i++) {
+		data[i] = (uint8_t)(i * 7U + 3U);
+	}
+
+	crypto_mod_init();
+
+	test_calc_hash();
+	test_calc_hash_steps();
+	test_verify();
+	test_auth_decrypt();
+
+	if (failed != 0) {
+		return 1;
+	}
+
+	printf("PASS: operations offloaded to the accelerator or falling back\n");
+
+	return 0;
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Software "accelerator" registered as an offload library. Like a hash
+ * engine, it only handles SHA-256, in one or several steps, and like a
+ * cipher engine it only handles one key length. It returns
+ * CRYPTO_ERR_NOT_SUPPORTED for everything else.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <drivers/auth/crypto_mod.h>
+
+#include "soft_libs.h"
+
+struct soft_lib_stats soft_accel_stats;
+
+static uint64_t hash_state;
+static bool hash_active;
+
+static const uint8_t *dec_key;
+static unsigned int dec_key_len;
+static size_t dec_offset;
+static bool dec_active;
+
+static int soft_accel_calc_hash(enum crypto_md_algo md_alg, void *data_ptr,
+				unsigned int data_len,
+				unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	uint64_t state = TOY_HASH_SEED;
+
+	if (md_alg != CRYPTO_MD_SHA256) {
+		return CRYPTO_ERR_NOT_SUPPORTED;
+	}
+
+	soft_accel_stats.calls++;
+
+	toy_hash(&state, data_ptr, data_len);
+	toy_hash_output(state, output, SOFT_ACCEL_ID);
+
+	return CRYPTO_SUCCESS;
+}
+
+static int soft_accel_calc_hash_init(enum crypto_md_algo md_alg)
+{
+	if (md_alg != CRYPTO_MD_SHA256) {
+		return CRYPTO_ERR_NOT_SUPPORTED;
+	}
+
+	soft_accel_stats.calls++;
+
+	hash_state = TOY_HASH_SEED;
+	hash_active = true;
+
+	return CRYPTO_SUCCESS;
+}
+
+static int soft_accel_calc_hash_update(const void *data_ptr, size_t len)
+{
+	if (!hash_active) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	soft_accel_stats.calls++;
+
+	toy_hash(&hash_state, data_ptr, len);
+
+	return CRYPTO_SUCCESS;
+}
+
+static int soft_accel_calc_hash_finish(unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	if (!hash_active) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	soft_accel_stats.calls++;
+
+	toy_hash_output(hash_state, output, SOFT_ACCEL_ID);
+	hash_active = false;
+
+	return CRYPTO_SUCCESS;
+}
+
+static int soft_accel_auth_decrypt(enum crypto_dec_algo dec_algo,
+				   void *data_ptr, size_t len, const void *key,
+				   unsigned int key_len, unsigned int key_flags,
+				   const void *iv, unsigned int iv_len,
+				   const void *tag, unsigned int tag_len)
+{
+	if ((dec_algo != CRYPTO_GCM_DECRYPT) ||
+	    (key_len != SOFT_ACCEL_KEY_LEN)) {
+		return CRYPTO_ERR_NOT_SUPPORTED;
+	}
+
+	soft_accel_stats.calls++;
+
+	toy_cipher(data_ptr, len, key, key_len, 0U);
+
+	return CRYPTO_SUCCESS;
+}
+
+static int soft_accel_auth_decrypt_init(enum crypto_dec_algo dec_algo,
+					const void *key, unsigned int key_len,
+					unsigned int key_flags, const void *iv,
+					unsigned int iv_len)
+{
+	if ((dec_algo != CRYPTO_GCM_DECRYPT) ||
+	    (key_len != SOFT_ACCEL_KEY_LEN)) {
+		return CRYPTO_ERR_NOT_SUPPORTED;
+	}
+
+	soft_accel_stats.calls++;
+
+	dec_key = key;
+	dec_key_len = key_len;
+	dec_offset = 0U;
+	dec_active = true;
+
+	return CRYPTO_SUCCESS;
+}
+
+static int soft_accel_auth_decrypt_update(void *data_ptr, size_t len)
+{
+	if (!dec_active) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	soft_accel_stats.calls++;
+
+	toy_cipher(data_ptr, len, dec_key, dec_key_len, dec_offset);
+	dec_offset += len;
+
+	return CRYPTO_SUCCESS;
+}
+
+static int soft_accel_auth_decrypt_finish(const void *tag,
+					  unsigned int tag_len)
+{
+	if (!dec_active) {
+		return CRYPTO_ERR_DECRYPTION;
+	}
+
+	soft_accel_stats.calls++;
+
+	dec_active = false;
+
+	return CRYPTO_SUCCESS;
+}
+
+const crypto_lib_desc_t soft_accel_lib_desc = {
+	.name = "soft_accel",
+	.calc_hash = soft_accel_calc_hash,
+	.calc_hash_init = soft_accel_calc_hash_init,
+	.calc_hash_update = soft_accel_calc_hash_update,
+	.calc_hash_finish = soft_accel_calc_hash_finish,
+	.auth_decrypt = soft_accel_auth_decrypt,
+	.auth_decrypt_init = soft_accel_auth_decrypt_init,
+	.auth_decrypt_update = soft_accel_auth_decrypt_update,
+	.auth_decrypt_finish = soft_accel_auth_decrypt_finish,
+};
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Software library registered with REGISTER_CRYPTO_LIB(), standing in for
+ * mbed TLS. It hashes in one step only and has no authenticated decryption,
+ * which it leaves to the accelerator.
+ */
+
+#include <string.h>
+
+#include <drivers/auth/crypto_mod.h>
+
+#include "soft_libs.h"
+
+#define TOY_HASH_PRIME		0x100000001b3ULL
+
+struct soft_lib_stats soft_lib_stats;
+
+void toy_hash(uint64_t *state, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		*state = (*state ^ p[i]) * TOY_HASH_PRIME;
+	}
+}
+
+void toy_hash_output(uint64_t state, unsigned char output[CRYPTO_MD_MAX_SIZE],
+		     uint8_t id)
+{
+	memset(output, 0, CRYPTO_MD_MAX_SIZE);
+	memcpy(output, &state, sizeof(state));
+	output[CRYPTO_MD_MAX_SIZE - 1U] = id;
+}
+
+void toy_cipher(void *data, size_t len, const void *key, unsigned int key_len,
+		size_t offset)
+{
+	const uint8_t *k = key;
+	uint8_t *p = data;
+	size_t i;
+
+	for (i = 0U; i < len; i++) {
+		p[i] ^= k[(offset + i) % key_len];
+	}
+}
+
+static void soft_lib_init(void)
+{
+}
+
+static int soft_lib_verify_signature(void *data_ptr, unsigned int data_len,
+				     void *sig_ptr, unsigned int sig_len,
+				     void *sig_alg, unsigned int sig_alg_len,
+				     void *pk_ptr, unsigned int pk_len)
+{
+	uint64_t state = TOY_HASH_SEED;
+
+	soft_lib_stats.calls++;
+
+	/* The "signature" is the toy digest of the data */
+	toy_hash(&state, data_ptr, data_len);
+	if ((sig_len != sizeof(state)) ||
+	    (memcmp(sig_ptr, &state, sizeof(state)) != 0)) {
+		return CRYPTO_ERR_SIGNATURE;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int soft_lib_verify_hash(void *data_ptr, unsigned int data_len,
+				void *digest_info_ptr,
+				unsigned int digest_info_len)
+{
+	uint64_t state = TOY_HASH_SEED;
+
+	soft_lib_stats.calls++;
+
+	toy_hash(&state, data_ptr, data_len);
+	if ((digest_info_len != sizeof(state)) ||
+	    (memcmp(digest_info_ptr, &state, sizeof(state)) != 0)) {
+		return CRYPTO_ERR_HASH;
+	}
+
+	return CRYPTO_SUCCESS;
+}
+
+static int soft_lib_calc_hash(enum crypto_md_algo md_alg, void *data_ptr,
+			      unsigned int data_len,
+			      unsigned char output[CRYPTO_MD_MAX_SIZE])
+{
+	uint64_t state = TOY_HASH_SEED;
+
+	soft_lib_stats.calls++;
+
+	toy_hash(&state, data_ptr, data_len);
+	toy_hash_output(state, output, SOFT_LIB_ID);
+
+	return CRYPTO_SUCCESS;
+}
+
+REGISTER_CRYPTO_LIB("soft_lib", soft_lib_init, soft_lib_verify_signature,
+		    soft_lib_verify_hash, soft_lib_calc_hash, NULL, NULL, NULL,
+		    NULL, NULL, NULL, NULL, NULL);
@@ -15,5 +15,7 @@ enum {
 
 int encrypt_file(unsigned short fw_enc_status, int enc_alg, char *key_string,
 		 char *nonce_string, const char *ip_name, const char *op_name);
+int encrypt_manifest(unsigned short fw_enc_status, int enc_alg,
+		     const char *manifest_name, unsigned int num_threads);
 
 #endif /* ENCRYPT_H */
@@ -5,44 +5,75 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <ctype.h>
 #include <firmware_encrypted.h>
 #include <openssl/evp.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "debug.h"
 #include "encrypt.h"
+#include "jobs.h"
 
-#define BUFFER_SIZE		256
+/*
+ * Images are streamed through the cipher in chunks of this size, so the
+ * memory used per image does not depend on the size of the image.
+ */
+#define CHUNK_SIZE		(64 * 1024)
 #define IV_SIZE			12
 #define IV_STRING_SIZE		24
 #define TAG_SIZE		16
 #define KEY_SIZE		32
 #define KEY_STRING_SIZE		64
 
-static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
-		       char *nonce_string, const char *ip_name,
-		       const char *op_name)
+/* Maximum length of a line in a manifest file */
+#define MANIFEST_LINE_SIZE	4096
+/* Number of whitespace separated fields in a manifest line */
+#define MANIFEST_NUM_FIELDS	4
+
+/* Image to be encrypted */
+typedef struct enc_image_s {
+	char *ip_name;
+	char *op_name;
+	unsigned char key[KEY_SIZE];
+	unsigned char iv[IV_SIZE];
+	unsigned short fw_enc_status;
+} enc_image_t;
+
+static char *strdup(const char *str)
 {
-	FILE *ip_file;
-	FILE *op_file;
-	EVP_CIPHER_CTX *ctx;
-	unsigned char data[BUFFER_SIZE], enc_data[BUFFER_SIZE];
-	unsigned char key[KEY_SIZE], iv[IV_SIZE], tag[TAG_SIZE];
-	int bytes, enc_len = 0, i, j, ret = 0;
-	struct fw_enc_hdr header;
+	int n = strlen(str) + 1;
+	char *dup = malloc(n);
+	if (dup) {
+		strcpy(dup, str);
+	}
+	return dup;
+}
 
-	memset(&header, 0, sizeof(struct fw_enc_hdr));
+static int parse_hex(const char *string, unsigned char *buf, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++) {
+		if (sscanf(&string[2 * i], "%02hhx", &buf[i]) != 1) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
 
+static int parse_key_iv(const char *key_string, const char *nonce_string,
+			enc_image_t *image)
+{
 	if (strlen(key_string) != KEY_STRING_SIZE) {
 		ERROR("Unsupported key size: %lu\n", strlen(key_string));
 		return -1;
 	}
 
-	for (i = 0, j = 0; i < KEY_SIZE; i++, j += 2) {
-		if (sscanf(&key_string[j], "%02hhx", &key[i]) != 1) {
-			ERROR("Incorrect key format\n");
-			return -1;
-		}
+	if (parse_hex(key_string, image->key, KEY_SIZE) != 0) {
+		ERROR("Incorrect key format\n");
+		return -1;
 	}
 
 	if (strlen(nonce_string) != IV_STRING_SIZE) {
@@ -50,106 +81,133 @@ static int gcm_encrypt(unsigned short fw_enc_status, char *key_string,
 		return -1;
 	}
 
-	for (i = 0, j = 0; i < IV_SIZE; i++, j += 2) {
-		if (sscanf(&nonce_string[j], "%02hhx", &iv[i]) != 1) {
-			ERROR("Incorrect IV format\n");
-			return -1;
-		}
+	if (parse_hex(nonce_string, image->iv, IV_SIZE) != 0) {
+		ERROR("Incorrect IV format\n");
+		return -1;
 	}
 
-	ip_file = fopen(ip_name, "rb");
+	return 0;
+}
+
+static int gcm_encrypt(const enc_image_t *image)
+{
+	FILE *ip_file;
+	FILE *op_file;
+	EVP_CIPHER_CTX *ctx;
+	unsigned char *data, *enc_data;
+	unsigned char tag[TAG_SIZE];
+	size_t bytes;
+	int enc_len = 0, ret = -1;
+	struct fw_enc_hdr header;
+
+	memset(&header, 0, sizeof(struct fw_enc_hdr));
+
+	ip_file = fopen(image->ip_name, "rb");
 	if (ip_file == NULL) {
-		ERROR("Cannot read %s\n", ip_name);
+		ERROR("Cannot read %s\n", image->ip_name);
 		return -1;
 	}
 
-	op_file = fopen(op_name, "wb");
+	op_file = fopen(image->op_name, "wb");
 	if (op_file == NULL) {
-		ERROR("Cannot write %s\n", op_name);
+		ERROR("Cannot write %s\n", image->op_name);
 		fclose(ip_file);
 		return -1;
 	}
 
-	ret = fseek(op_file, sizeof(struct fw_enc_hdr), SEEK_SET);
-	if (ret) {
-		ERROR("fseek failed\n");
-		goto out_file;
+	/*
+	 * GCM is a stream mode: EVP_EncryptUpdate() outputs as many bytes as
+	 * it is given, and EVP_EncryptFinal_ex() outputs none.
+	 */
+	data = malloc(CHUNK_SIZE);
+	enc_data = malloc(CHUNK_SIZE);
+	ctx = EVP_CIPHER_CTX_new();
+	if ((data == NULL) || (enc_data == NULL) || (ctx == NULL)) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		goto out;
 	}
 
-	ctx = EVP_CIPHER_CTX_new();
-	if (ctx == NULL) {
-		ERROR("EVP_CIPHER_CTX_new failed\n");
-		ret = -1;
-		goto out_file;
+	if (fseek(op_file, sizeof(struct fw_enc_hdr), SEEK_SET) != 0) {
+		ERROR("fseek failed\n");
+		goto out;
 	}
 
-	ret = EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), NULL, NULL, NULL);
-	if (ret != 1) {
+	if (EVP_EncryptInit_ex(ctx, EVP_aes_256_gcm(), NULL, NULL,
+			       NULL) != 1) {
 		ERROR("EVP_EncryptInit_ex failed\n");
-		ret = -1;
 		goto out;
 	}
 
-	ret = EVP_EncryptInit_ex(ctx, NULL, NULL, key, iv);
-	if (ret != 1) {
+	if (EVP_EncryptInit_ex(ctx, NULL, NULL, image->key, image->iv) != 1) {
 		ERROR("EVP_EncryptInit_ex failed\n");
 		goto out;
 	}
 
-	while ((bytes = fread(data, 1, BUFFER_SIZE, ip_file)) != 0) {
-		ret = EVP_EncryptUpdate(ctx, enc_data, &enc_len, data, bytes);
-		if (ret != 1) {
+	while ((bytes = fread(data, 1, CHUNK_SIZE, ip_file)) != 0) {
+		if (EVP_EncryptUpdate(ctx, enc_data, &enc_len, data,
+				      bytes) != 1) {
 			ERROR("EVP_EncryptUpdate failed\n");
-			ret = -1;
 			goto out;
 		}
 
-		fwrite(enc_data, 1, enc_len, op_file);
+		if (fwrite(enc_data, 1, enc_len, op_file) != (size_t)enc_len) {
+			ERROR("Cannot write %s\n", image->op_name);
+			goto out;
+		}
 	}
 
-	ret = EVP_EncryptFinal_ex(ctx, enc_data, &enc_len);
-	if (ret != 1) {
+	if (ferror(ip_file)) {
+		ERROR("Cannot read %s\n", image->ip_name);
+		goto out;
+	}
+
+	if (EVP_EncryptFinal_ex(ctx, enc_data, &enc_len) != 1) {
 		ERROR("EVP_EncryptFinal_ex failed\n");
-		ret = -1;
 		goto out;
 	}
 
-	ret = EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, TAG_SIZE, tag);
-	if (ret != 1) {
+	if (EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, TAG_SIZE,
+				tag) != 1) {
 		ERROR("EVP_CIPHER_CTX_ctrl failed\n");
-		ret = -1;
 		goto out;
 	}
 
 	header.magic = ENC_HEADER_MAGIC;
-	header.flags |= fw_enc_status & FW_ENC_STATUS_FLAG_MASK;
+	header.flags |= image->fw_enc_status & FW_ENC_STATUS_FLAG_MASK;
 	header.dec_algo = KEY_ALG_GCM;
 	header.iv_len = IV_SIZE;
 	header.tag_len = TAG_SIZE;
-	memcpy(header.iv, iv, IV_SIZE);
+	memcpy(header.iv, image->iv, IV_SIZE);
 	memcpy(header.tag, tag, TAG_SIZE);
 
-	ret = fseek(op_file, 0, SEEK_SET);
-	if (ret) {
+	if (fseek(op_file, 0, SEEK_SET) != 0) {
 		ERROR("fseek failed\n");
 		goto out;
 	}
 
-	fwrite(&header, 1, sizeof(struct fw_enc_hdr), op_file);
+	if (fwrite(&header, 1, sizeof(struct fw_enc_hdr), op_file) !=
+	    sizeof(struct fw_enc_hdr)) {
+		ERROR("Cannot write %s\n", image->op_name);
+		goto out;
+	}
+
+	ret = 0;
 
 out:
 	EVP_CIPHER_CTX_free(ctx);
+	free(enc_data);
+	free(data);
 
-out_file:
 	fclose(ip_file);
-	fclose(op_file);
+	if ((fclose(op_file) != 0) && (ret == 0)) {
+		ERROR("Cannot write %s\n", image->op_name);
+		ret = -1;
+	}
 
-	/*
-	 * EVP_* APIs returns 1 as success but enctool considers
-	 * 0 as success.
-	 */
-	if (ret == 1)
-		ret = 0;
+	/* Do not leave a truncated image behind */
+	if (ret != 0) {
+		remove(image->op_name);
+	}
 
 	return ret;
 }
@@ -157,11 +215,209 @@ out_file:
 int encrypt_file(unsigned short fw_enc_status, int enc_alg, char *key_string,
 		 char *nonce_string, const char *ip_name, const char *op_name)
 {
+	enc_image_t image;
+
 	switch (enc_alg) {
 	case KEY_ALG_GCM:
-		return gcm_encrypt(fw_enc_status, key_string, nonce_string,
-				   ip_name, op_name);
+		if (parse_key_iv(key_string, nonce_string, &image) != 0) {
+			return -1;
+		}
+		image.ip_name = (char *)ip_name;
+		image.op_name = (char *)op_name;
+		image.fw_enc_status = fw_enc_status;
+		return gcm_encrypt(&image);
 	default:
 		return -1;
 	}
 }
+
+/* Encrypt one image of a manifest. Run by the worker pool */
+static int encrypt_image(void *arg)
+{
+	enc_image_t *image = arg;
+
+	if (gcm_encrypt(image) != 0) {
+		ERROR("Cannot encrypt %s\n", image->ip_name);
+		return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Split a manifest line into whitespace separated fields. Return the number
+ * of fields found, or -1 if there are more than 'max_fields'.
+ */
+static int split_line(char *line, char **fields, int max_fields)
+{
+	int num = 0;
+
+	while (1) {
+		while (isspace((unsigned char)*line)) {
+			*line++ = '\0';
+		}
+
+		if ((*line == '\0') || (*line == '#')) {
+			return num;
+		}
+
+		if (num == max_fields) {
+			return -1;
+		}
+
+		fields[num++] = line;
+		while ((*line != '\0') && !isspace((unsigned char)*line)) {
+			line++;
+		}
+	}
+}
+
+/*
+ * Check a manifest entry against the previous ones. AES-GCM must never be
+ * used twice with the same key and nonce, and two images cannot be written
+ * to the same file.
+ */
+static int check_image(const enc_image_t *images, unsigned int num,
+		       const enc_image_t *image)
+{
+	unsigned int i;
+
+	for (i = 0; i < num; i++) {
+		if ((memcmp(images[i].key, image->key, KEY_SIZE) == 0) &&
+		    (memcmp(images[i].iv, image->iv, IV_SIZE) == 0)) {
+			ERROR("%s and %s use the same key and nonce\n",
+			      images[i].ip_name, image->ip_name);
+			return -1;
+		}
+
+		if (strcmp(images[i].op_name, image->op_name) == 0) {
+			ERROR("%s is the output of more than one image\n",
+			      image->op_name);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * Encrypt the images listed in a manifest file using up to 'num_threads'
+ * worker threads. Each non-empty line of the manifest describes one image:
+ *
+ *   <input file> <output file> <key> <nonce>
+ *
+ * The key and nonce are hex strings, as on the command line. A field starting
+ * with '#' starts a comment that runs to the end of the line.
+ */
+int encrypt_manifest(unsigned short fw_enc_status, int enc_alg,
+		     const char *manifest_name, unsigned int num_threads)
+{
+	FILE *manifest;
+	char line[MANIFEST_LINE_SIZE];
+	char *fields[MANIFEST_NUM_FIELDS];
+	enc_image_t *images = NULL, *tmp, *image;
+	job_t *jobs = NULL;
+	unsigned int num_images = 0, line_num = 0, i;
+	int num_fields, ret = -1;
+
+	if (enc_alg != KEY_ALG_GCM) {
+		return -1;
+	}
+
+	manifest = fopen(manifest_name, "r");
+	if (manifest == NULL) {
+		ERROR("Cannot read %s\n", manifest_name);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), manifest) != NULL) {
+		line_num++;
+
+		if ((strchr(line, '\n') == NULL) && !feof(manifest)) {
+			ERROR("%s:%u: Line too long\n", manifest_name,
+			      line_num);
+			goto out;
+		}
+
+		num_fields = split_line(line, fields, MANIFEST_NUM_FIELDS);
+		if (num_fields == 0) {
+			continue;
+		}
+
+		if (num_fields != MANIFEST_NUM_FIELDS) {
+			ERROR("%s:%u: Expected <in> <out> <key> <nonce>\n",
+			      manifest_name, line_num);
+			goto out;
+		}
+
+		tmp = realloc(images, (num_images + 1) * sizeof(images[0]));
+		if (tmp == NULL) {
+			ERROR("%s:%d Failed to allocate memory.\n", __func__,
+			      __LINE__);
+			goto out;
+		}
+		images = tmp;
+
+		image = &images[num_images];
+		if (parse_key_iv(fields[2], fields[3], image) != 0) {
+			ERROR("%s:%u: Invalid key or nonce\n", manifest_name,
+			      line_num);
+			goto out;
+		}
+		image->fw_enc_status = fw_enc_status;
+		image->ip_name = strdup(fields[0]);
+		image->op_name = strdup(fields[1]);
+		num_images++;
+
+		if ((image->ip_name == NULL) || (image->op_name == NULL)) {
+			ERROR("%s:%d Failed to allocate memory.\n", __func__,
+			      __LINE__);
+			goto out;
+		}
+
+		if (check_image(images, num_images - 1, image) != 0) {
+			goto out;
+		}
+	}
+
+	if (ferror(manifest)) {
+		ERROR("Cannot read %s\n", manifest_name);
+		goto out;
+	}
+
+	if (num_images == 0) {
+		ERROR("No image in %s\n", manifest_name);
+		goto out;
+	}
+
+	jobs = calloc(num_images, sizeof(jobs[0]));
+	if (jobs == NULL) {
+		ERROR("%s:%d Failed to allocate memory.\n", __func__, __LINE__);
+		goto out;
+	}
+
+	for (i = 0; i < num_images; i++) {
+		jobs[i].fn = encrypt_image;
+		jobs[i].arg = &images[i];
+		jobs[i].dep = JOB_NO_DEP;
+	}
+
+	if (jobs_run(jobs, num_images, num_threads)) {
+		ret = 0;
+	}
+
+out:
+	fclose(manifest);
+	for (i = 0; i < num_images; i++) {
+		free(images[i].ip_name);
+		free(images[i].op_name);
+	}
+	/* Do not keep copies of the keys around */
+	if (images != NULL) {
+		memset(images, 0, num_images * sizeof(images[0]));
+	}
+	free(images);
+	free(jobs);
+
+	return ret;
+}
@@ -8,6 +8,7 @@
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -45,7 +46,8 @@ static void print_help(const char *cmd, const struct option *long_opt)
 	printf("\n\n");
 	printf("The firmware encryption tool loads the binary image and\n"
 	       "outputs encrypted binary image using an encryption key\n"
-	       "provided as an input hex string.\n");
+	       "provided as an input hex string. Several images can be\n"
+	       "encrypted in one run by listing them in a manifest file.\n");
 	printf("\n");
 	printf("Usage:\n");
 	printf("\t%s [OPTIONS]\n\n", cmd);
@@ -83,6 +85,18 @@ static int get_key_alg(const char *key_alg_str)
 	return -1;
 }
 
+static int get_num_threads(const char *num_threads_str)
+{
+	char *end;
+	long num;
+
+	num = strtol(num_threads_str, &end, 10);
+	if ((*end != '\0') || (num <= 0) || (num > INT_MAX))
+		return -1;
+
+	return num;
+}
+
 static void parse_fw_enc_status_flag(const char *arg,
 				     unsigned short *fw_enc_status)
 {
@@ -128,23 +142,36 @@ static const cmd_opt_t common_cmd_opt[] = {
 		{ "out", required_argument, NULL, 'o' },
 		"Encrypted output filename."
 	},
+	{
+		{ "manifest", required_argument, NULL, 'm' },
+		"File listing the images to be encrypted, one per line as "
+		"'<in> <out> <key> <nonce>'. Replaces --in, --out, --key and "
+		"--nonce."
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of images of the manifest encrypted in parallel "
+		"(default: 1)"
+	},
 };
 
 int main(int argc, char *argv[])
 {
-	int i, key_alg, ret;
+	int i, key_alg, num_threads, ret;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
 	char *key = NULL;
 	char *nonce = NULL;
 	char *in_fn = NULL;
 	char *out_fn = NULL;
+	char *manifest_fn = NULL;
 	unsigned short fw_enc_status = 0;
 
 	NOTICE("Firmware Encryption Tool: %s\n", build_msg);
 
 	/* Set default options */
 	key_alg = KEY_ALG_GCM;
+	num_threads = 1;
 
 	/* Add common command line options */
 	for (i = 0; i < NUM_ELEM(common_cmd_opt); i++) {
@@ -156,7 +183,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:f:hi:k:n:o:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:f:hi:j:k:m:n:o:", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -174,9 +201,19 @@ int main(int argc, char *argv[])
 		case 'f':
 			parse_fw_enc_status_flag(optarg, &fw_enc_status);
 			break;
+		case 'j':
+			num_threads = get_num_threads(optarg);
+			if (num_threads < 0) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			key = optarg;
 			break;
+		case 'm':
+			manifest_fn = optarg;
+			break;
 		case 'i':
 			in_fn = optarg;
 			break;
@@ -196,6 +233,20 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	if (manifest_fn) {
+		if (key || nonce || in_fn || out_fn) {
+			ERROR("Manifest cannot be combined with key, nonce, "
+			      "input or output filename\n");
+			exit(1);
+		}
+
+		ret = encrypt_manifest(fw_enc_status, key_alg, manifest_fn,
+				       num_threads);
+		CRYPTO_cleanup_all_ex_data();
+
+		return ret;
+	}
+
 	if (!key) {
 		ERROR("Key must not be NULL\n");
 		exit(1);
@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+# Copyright (c) 2024, Arm Limited. All rights reserved.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+
+"""
+Compile a firmware configuration DTB into a blob which fconf can read without
+walking the device tree. The blob layout is described in
+include/lib/fconf/fconf_blob.h and both must be kept in sync.
+
+Only the nodes which have a compiled form are converted. The tool fails if the
+DTB contains none of them, so that a configuration which must stay a DTB is not
+silently replaced by an empty blob.
+"""
+
+import argparse
+import struct
+import sys
+
+FDT_MAGIC = 0xd00dfeed
+FDT_BEGIN_NODE = 1
+FDT_END_NODE = 2
+FDT_PROP = 3
+FDT_NOP = 4
+FDT_END = 9
+
+FCONF_BLOB_MAGIC = 0x42434654  # "TFCB"
+FCONF_BLOB_VERSION = 1
+FCONF_BLOB_HEADER = struct.Struct("<IHHII")
+FCONF_BLOB_RECORD = struct.Struct("<II")
+
+FCONF_BLOB_TAG_DTB_REGISTRY = 1
+FCONF_BLOB_TAG_TBBR = 2
+
+DTB_INFO = struct.Struct("<QQII")
+TBBR = struct.Struct("<QII")
+
+NO_ADDRESS = (1 << 64) - 1
+
+
+class Node:
+    def __init__(self, name):
+        self.name = name
+        self.props = {}
+        self.children = []
+
+    def walk(self):
+        yield self
+        for child in self.children:
+            yield from child.walk()
+
+    def compatible(self):
+        return self.props.get("compatible", b"").split(b"\0")
+
+
+def parse_dtb(data):
+    """Return the root node of the flattened device tree in 'data'."""
+    (magic, totalsize, off_struct, off_strings, _, version, _, _,
+     size_strings, size_struct) = struct.unpack_from(">10I", data)
+
+    if magic != FDT_MAGIC or totalsize > len(data) or version < 17:
+        raise ValueError("not a valid DTB")
+
+    strings = data[off_strings:off_strings + size_strings]
+    pos = off_struct
+    end = off_struct + size_struct
+    stack = []
+    root = None
+
+    while pos < end:
+        (token,) = struct.unpack_from(">I", data, pos)
+        pos += 4
+
+        if token == FDT_BEGIN_NODE:
+            name_end = data.index(b"\0", pos)
+            node = Node(data[pos:name_end].decode())
+            pos = (name_end + 4) & ~3
+            if stack:
+                stack[-1].children.append(node)
+            else:
+                root = node
+            stack.append(node)
+        elif token == FDT_END_NODE:
+            stack.pop()
+        elif token == FDT_PROP:
+            length, name_off = struct.unpack_from(">II", data, pos)
+            pos += 8
+            name = strings[name_off:strings.index(b"\0", name_off)].decode()
+            stack[-1].props[name] = data[pos:pos + length]
+            pos = (pos + length + 3) & ~3
+        elif token == FDT_NOP:
+            continue
+        elif token == FDT_END:
+            break
+        else:
+            raise ValueError("bad FDT token 0x%x" % token)
+
+    if root is None:
+        raise ValueError("empty DTB")
+
+    return root
+
+
+def read_u32(node, prop):
+    value = node.props.get(prop)
+    if value is None or len(value) != 4:
+        raise ValueError("%s: missing or malformed u32 property '%s'" %
+                         (node.name, prop))
+    return struct.unpack(">I", value)[0]
+
+
+def read_u64(node, prop, default=None):
+    # fdt_read_uint64() requires the value to span exactly two cells
+    value = node.props.get(prop)
+    if value is None and default is not None:
+        return default
+    if value is None or len(value) != 8:
+        raise ValueError("%s: missing or malformed u64 property '%s'" %
+                         (node.name, prop))
+    return struct.unpack(">Q", value)[0]
+
+
+def find_compatible(root, compatible):
+    for node in root.walk():
+        if compatible.encode() in node.compatible():
+            return node
+    return None
+
+
+def dtb_registry_record(root):
+    registry = find_compatible(root, "fconf,dyn_cfg-dtb_registry")
+    if registry is None:
+        return None
+
+    payload = b""
+    for child in registry.children:
+        payload += DTB_INFO.pack(
+            read_u64(child, "load-address"),
+            read_u64(child, "secondary-load-address", NO_ADDRESS),
+            read_u32(child, "max-size"),
+            read_u32(child, "id"))
+
+    return (FCONF_BLOB_TAG_DTB_REGISTRY, payload)
+
+
+def tbbr_record(root):
+    node = find_compatible(root, "arm,tb_fw")
+    if node is None:
+        return None
+
+    disable_auth = read_u32(node, "disable_auth")
+    if disable_auth not in (0, 1):
+        raise ValueError("invalid value for 'disable_auth': %u" %
+                         disable_auth)
+
+    return (FCONF_BLOB_TAG_TBBR,
+            TBBR.pack(read_u64(node, "mbedtls_heap_addr"),
+                      read_u32(node, "mbedtls_heap_size"),
+                      disable_auth))
+
+
+def compile_blob(root):
+    records = [r for r in (dtb_registry_record(root), tbbr_record(root))
+               if r is not None]
+    if not records:
+        raise ValueError("no node with a compiled form found")
+
+    body = b""
+    for tag, payload in records:
+        body += FCONF_BLOB_RECORD.pack(tag, len(payload)) + payload
+
+    total_size = FCONF_BLOB_HEADER.size + len(body)
+    assert total_size % 8 == 0
+
+    header = FCONF_BLOB_HEADER.pack(FCONF_BLOB_MAGIC, FCONF_BLOB_VERSION,
+                                    len(records), total_size, 0)
+    blob = header + body
+
+    # Make the sum of all the 32-bit words of the blob equal to 0
+    checksum = -sum(struct.unpack("<%dI" % (total_size // 4), blob))
+    checksum &= 0xffffffff
+
+    return FCONF_BLOB_HEADER.pack(FCONF_BLOB_MAGIC, FCONF_BLOB_VERSION,
+                                  len(records), total_size, checksum) + body
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compile a firmware "
+                                     "configuration DTB into an fconf blob.")
+    parser.add_argument("-o", "--output", required=True,
+                        help="output blob file")
+    parser.add_argument("dtb", help="input configuration DTB")
+    args = parser.parse_args()
+
+    try:
+        with open(args.dtb, "rb") as f:
+            blob = compile_blob(parse_dtb(f.read()))
+    except (OSError, ValueError, struct.error) as e:
+        print("%s: %s: %s" % (sys.argv[0], args.dtb, e), file=sys.stderr)
+        return 1
+
+    with open(args.output, "wb") as f:
+        f.write(blob)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef ARCH_HELPERS_H
+#define ARCH_HELPERS_H
+
+#include <sched.h>
+
+/* Host stand-ins for the AArch64 helpers used by the RSE comms driver */
+static inline void wfe(void)
+{
+	sched_yield();
+}
+
+static inline void sev(void)
+{
+}
+
+static inline void dsbish(void)
+{
+	__sync_synchronize();
+}
+
+#endif /* ARCH_HELPERS_H */
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef MHU_LOOPBACK_H
+#define MHU_LOOPBACK_H
+
+/*
+ * The loopback MHU stands in for RSE: it answers each embed protocol message
+ * with the handle of the message as return value and with the payload of the
+ * input vectors copied to the first output vector.
+ */
+
+/* Make the next reply carry a wrong sequence number */
+void mhu_loopback_corrupt_next_reply(void);
+
+#endif /* MHU_LOOPBACK_H */
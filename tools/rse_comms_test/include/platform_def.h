@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef PLATFORM_DEF_H
+#define PLATFORM_DEF_H
+
+#include <lib/cassert.h>
+
+/* Same payload size as the TC platform */
+#define PLAT_RSE_COMMS_PAYLOAD_MAX_SIZE	0x500
+
+/* Fewer buffers than test threads, so that callers wait for a buffer */
+#define PLAT_RSE_COMMS_MAX_CLIENTS	4U
+
+#endif /* PLATFORM_DEF_H */
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Host test of the RSE comms driver over a loopback MHU. Several threads make
+ * PSA calls concurrently, with more threads than message buffers, and check
+ * that each of them gets the reply to its own message.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <drivers/arm/rse_comms.h>
+#include <psa/client.h>
+
+#include "mhu_loopback.h"
+
+#define NUM_THREADS		8U
+#define NUM_CALLS		2000U
+#define DATA_SIZE		64U
+
+static int failed;
+
+static void fill(uint8_t *buf, unsigned int thread, unsigned int call)
+{
+	unsigned int i;
+
+	for (i = 0U; i < DATA_SIZE; i++) {
+		buf[i] = (uint8_t)(thread * 31U + call * 7U + i);
+	}
+}
+
+static psa_status_t echo_call(psa_handle_t handle, uint8_t *in, uint8_t *out,
+			      size_t *out_size)
+{
+	psa_invec in_vec[] = { { in, DATA_SIZE } };
+	psa_outvec out_vec[] = { { out, DATA_SIZE } };
+	psa_status_t status;
+
+	status = psa_call(handle, 0, in_vec, 1U, out_vec, 1U);
+	*out_size = out_vec[0].len;
+
+	return status;
+}
+
+static void *client(void *arg)
+{
+	unsigned int thread = (unsigned int)(uintptr_t)arg;
+	psa_handle_t handle = (psa_handle_t)(thread + 1U);
+	uint8_t in[DATA_SIZE], out[DATA_SIZE];
+	psa_status_t status;
+	size_t out_size;
+	unsigned int call;
+
+	for (call = 0U; call < NUM_CALLS; call++) {
+		fill(in, thread, call);
+		memset(out, 0, sizeof(out));
+
+		status = echo_call(handle, in, out, &out_size);
+		if ((status != handle) || (out_size != DATA_SIZE) ||
+		    (memcmp(in, out, DATA_SIZE) != 0)) {
+			printf("FAIL: thread %u call %u got status %d\n",
+			       thread, call, status);
+			__atomic_store_n(&failed, 1, __ATOMIC_RELAXED);
+			break;
+		}
+	}
+
+	return NULL;
+}
+
+static void test_concurrent_calls(void)
+{
+	pthread_t threads[NUM_THREADS];
+	unsigned int i;
+
+	for (i = 0U; i < NUM_THREADS; i++) {
+		if (pthread_create(&threads[i], NULL, client,
+				   (void *)(uintptr_t)i) != 0) {
+			printf("FAIL: cannot create thread %u\n", i);
+			exit(1);
+		}
+	}
+
+	for (i = 0U; i < NUM_THREADS; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	printf("%s: %u threads x %u calls\n",
+	       failed ? "FAIL" : "PASS", NUM_THREADS, NUM_CALLS);
+}
+
+/*
+ * A reply to another message is rejected, and the message buffer is released
+ * on this error path: the calls that follow, more than there are buffers,
+ * still succeed.
+ */
+static void test_mismatched_reply(void)
+{
+	uint8_t in[DATA_SIZE], out[DATA_SIZE];
+	psa_status_t status;
+	size_t out_size;
+	unsigned int i;
+	int ok = 1;
+
+	fill(in, 0U, 0U);
+
+	for (i = 0U; i < (2U * NUM_THREADS); i++) {
+		mhu_loopback_corrupt_next_reply();
+		status = echo_call(1, in, out, &out_size);
+		if (status != PSA_ERROR_COMMUNICATION_FAILURE) {
+			ok = 0;
+		}
+	}
+
+	status = echo_call(1, in, out, &out_size);
+	if ((status != 1) || (memcmp(in, out, DATA_SIZE) != 0)) {
+		ok = 0;
+	}
+
+	if (!ok) {
+		failed = 1;
+	}
+
+	printf("%s: mismatched replies are rejected\n", ok ? "PASS" : "FAIL");
+}
+
+int main(void)
+{
+	if (rse_comms_init(0U, 0U) != 0) {
+		printf("FAIL: rse_comms_init\n");
+		return 1;
+	}
+
+	test_concurrent_calls();
+	test_mismatched_reply();
+
+	return failed ? 1 : 0;
+}
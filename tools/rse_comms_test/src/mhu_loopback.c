@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <drivers/arm/mhu.h>
+
+#include "mhu_loopback.h"
+#include "rse_comms_protocol.h"
+#include "rse_comms_protocol_common.h"
+
+/* Largest message, chosen so that the test messages use the embed protocol */
+#define LOOPBACK_MAX_MSG_SIZE	0x600U
+
+/*
+ * Last message sent. The driver holds its MHU lock from the send to the
+ * receive of the reply, so the loopback needs no lock of its own.
+ */
+static struct serialized_rse_comms_msg_t msg;
+static size_t msg_size;
+static bool corrupt_next_reply;
+
+enum mhu_error_t mhu_init_sender(uintptr_t mhu_sender_base)
+{
+	return MHU_ERR_NONE;
+}
+
+enum mhu_error_t mhu_init_receiver(uintptr_t mhu_receiver_base)
+{
+	return MHU_ERR_NONE;
+}
+
+size_t mhu_get_max_message_size(void)
+{
+	return LOOPBACK_MAX_MSG_SIZE;
+}
+
+enum mhu_error_t mhu_send_data(const uint8_t *send_buffer, size_t size)
+{
+	if ((size > sizeof(msg)) || (size > LOOPBACK_MAX_MSG_SIZE)) {
+		return MHU_ERR_INVALID_ARG;
+	}
+
+	memcpy(&msg, send_buffer, size);
+	msg_size = size;
+
+	return MHU_ERR_NONE;
+}
+
+enum mhu_error_t mhu_receive_data(uint8_t *receive_buffer, size_t *size)
+{
+	struct serialized_rse_comms_reply_t *reply = (void *)receive_buffer;
+	const struct rse_embed_msg_t *embed = &msg.msg.embed;
+	size_t in_len, out_len, payload = 0U, reply_size;
+	unsigned int i;
+
+	if ((msg_size == 0U) ||
+	    (msg.header.protocol_ver != RSE_COMMS_PROTOCOL_EMBED)) {
+		return MHU_ERR_GENERAL;
+	}
+
+	in_len = (embed->ctrl_param & IN_LEN_MASK) >> IN_LEN_OFFSET;
+	out_len = (embed->ctrl_param & OUT_LEN_MASK) >> OUT_LEN_OFFSET;
+	for (i = 0U; i < in_len; i++) {
+		payload += embed->io_size[i];
+	}
+	if ((out_len != 0U) && (payload > embed->io_size[in_len])) {
+		payload = embed->io_size[in_len];
+	}
+	if (out_len == 0U) {
+		payload = 0U;
+	}
+
+	reply_size = sizeof(*reply) - sizeof(reply->reply.embed.trailer) +
+		     payload;
+	if (reply_size > *size) {
+		return MHU_ERR_BUFFER_TOO_SMALL;
+	}
+
+	/* The message and the reply share the same buffer in the driver */
+	memset(reply, 0, reply_size);
+	reply->header = msg.header;
+	if (corrupt_next_reply) {
+		reply->header.seq_num++;
+		corrupt_next_reply = false;
+	}
+	reply->reply.embed.return_val = embed->handle;
+	if (out_len != 0U) {
+		reply->reply.embed.out_size[0] = (uint16_t)payload;
+		memcpy(reply->reply.embed.trailer, embed->trailer, payload);
+	}
+
+	*size = reply_size;
+	msg_size = 0U;
+
+	return MHU_ERR_NONE;
+}
+
+void mhu_loopback_corrupt_next_reply(void)
+{
+	corrupt_next_reply = true;
+}
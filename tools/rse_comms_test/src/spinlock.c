@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2024, Arm Limited. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <sched.h>
+
+#include <lib/spinlock.h>
+
+/* Host implementation of the spinlocks used by the RSE comms driver */
+void spin_lock(spinlock_t *lock)
+{
+	while (__atomic_exchange_n(&lock->lock, 1U, __ATOMIC_ACQUIRE) != 0U) {
+		sched_yield();
+	}
+}
+
+void spin_unlock(spinlock_t *lock)
+{
+	__atomic_store_n(&lock->lock, 0U, __ATOMIC_RELEASE);
+}